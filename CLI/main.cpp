@@ -0,0 +1,351 @@
+#include "../W32/RTTI.h"
+#include "../W32/HeaderExporter.h"
+#include "../W32/JsonExporter.h"
+#include "../W32/ClassDatabase.h"
+#include "../W32/ClassDiff.h"
+#include "../Util/Log.h"
+#include "../Util/Strings.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+/************************************************************************/
+/* Headless dumper for build machines                                   */
+/* Progress and the result are printed to stdout as one JSON object per */
+/* line, log messages go to stderr                                      */
+/************************************************************************/
+
+enum EExitCode
+{
+	ExitSuccess = 0,
+	ExitInvalidArguments = 1,
+	ExitTargetNotFound = 2,
+	ExitModuleNotFound = 3,
+	ExitNoClassesFound = 4,
+	ExitWriteFailed = 5
+};
+
+enum class EOutputFormat
+{
+	Header,
+	Json,
+	Database,
+	Diff
+};
+
+struct FOptions
+{
+	DWORD PID = 0;
+	std::string ProcessName;
+	std::string ImagePath;
+	std::string ModuleName; // main module of the target if empty
+	std::string OutputPath;
+	std::string BasePath; // older build's database for --format diff
+	bool bScanAll = false;
+	bool bIncludeAddresses = false;
+	bool bUseCache = true;
+	EOutputFormat Format = EOutputFormat::Header;
+};
+
+static constexpr auto PollInterval = std::chrono::milliseconds(20);
+
+static void PrintUsage()
+{
+	fprintf(stderr,
+		"usage: ClassDumper3CLI (--pid <pid> | --process <name> | --image <path>) --out <file> [options]\n"
+		"\n"
+		"  --pid <pid>        attach to a running process\n"
+		"  --process <name>   attach to the first process with this executable name\n"
+		"  --image <path>     map an executable or dll into this process without running it\n"
+		"  --module <name>    module to dump, defaults to the main module or the image\n"
+		"  --out <file>       file to write\n"
+		"  --format <format>  header (default), json (one class per line), db (memory mappable database)\n"
+		"                     or diff (report against the database given with --base)\n"
+		"  --base <file>      database of an older build to diff against\n"
+		"  --scan-all         also scan for code references and instances\n"
+		"  --addresses        write vtable and function RVAs into the header, json and db always have them\n"
+		"  --no-cache         always scan, do not load or store results in %%LOCALAPPDATA%%\\ClassDumper3\\Cache\n"
+		"\n"
+		"exit codes: 0 success, 1 invalid arguments, 2 target not found, 3 module not found,\n"
+		"            4 no classes found, 5 output could not be written\n");
+}
+
+static void PrintEvent(const char* Event, const std::string& Field, const std::string& Value)
+{
+	fprintf(stdout, "{\"event\":\"%s\",\"%s\":\"%s\"}\n", Event, Field.c_str(), EscapeJson(Value).c_str());
+	fflush(stdout);
+}
+
+static int Fail(EExitCode ExitCode, const std::string& Message)
+{
+	fprintf(stdout, "{\"event\":\"error\",\"exit_code\":%d,\"message\":\"%s\"}\n", ExitCode, EscapeJson(Message).c_str());
+	fflush(stdout);
+	return ExitCode;
+}
+
+static bool ParseArguments(int argc, char** argv, FOptions& Options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string Argument = argv[i];
+		const bool bHasValue = i + 1 < argc;
+
+		if (Argument == "--pid" && bHasValue)
+		{
+			Options.PID = static_cast<DWORD>(strtoul(argv[++i], nullptr, 0));
+		}
+		else if (Argument == "--process" && bHasValue)
+		{
+			Options.ProcessName = argv[++i];
+		}
+		else if (Argument == "--image" && bHasValue)
+		{
+			Options.ImagePath = argv[++i];
+		}
+		else if (Argument == "--module" && bHasValue)
+		{
+			Options.ModuleName = argv[++i];
+		}
+		else if (Argument == "--out" && bHasValue)
+		{
+			Options.OutputPath = argv[++i];
+		}
+		else if (Argument == "--base" && bHasValue)
+		{
+			Options.BasePath = argv[++i];
+		}
+		else if (Argument == "--format" && bHasValue)
+		{
+			const std::string Format = argv[++i];
+			if (Format == "header")
+			{
+				Options.Format = EOutputFormat::Header;
+			}
+			else if (Format == "json")
+			{
+				Options.Format = EOutputFormat::Json;
+			}
+			else if (Format == "db")
+			{
+				Options.Format = EOutputFormat::Database;
+			}
+			else if (Format == "diff")
+			{
+				Options.Format = EOutputFormat::Diff;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else if (Argument == "--scan-all")
+		{
+			Options.bScanAll = true;
+		}
+		else if (Argument == "--addresses")
+		{
+			Options.bIncludeAddresses = true;
+		}
+		else if (Argument == "--no-cache")
+		{
+			Options.bUseCache = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	const int NumTargets = (Options.PID != 0) + !Options.ProcessName.empty() + !Options.ImagePath.empty();
+	const bool bHasBase = !Options.BasePath.empty();
+	return NumTargets == 1 && !Options.OutputPath.empty() && bHasBase == (Options.Format == EOutputFormat::Diff);
+}
+
+// prints every stage the scanner passes through until it is done
+static void WaitForProcessing(RTTI& Dumper)
+{
+	std::string LastStage;
+
+	do
+	{
+		std::this_thread::sleep_for(PollInterval);
+
+		const std::string Stage = Dumper.GetProcessingStage();
+		if (Stage != LastStage)
+		{
+			PrintEvent("stage", "stage", Stage);
+			LastStage = Stage;
+		}
+	} while (Dumper.IsAsyncProcessing());
+}
+
+static void WaitForScanning(RTTI& Dumper)
+{
+	while (Dumper.IsAsyncScanning())
+	{
+		std::this_thread::sleep_for(PollInterval);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	FOptions Options;
+	if (!ParseArguments(argc, argv, Options))
+	{
+		PrintUsage();
+		return Fail(ExitInvalidArguments, "invalid arguments");
+	}
+
+	FLog::SetSink([](const char* Message) { fprintf(stderr, "%s\n", Message); });
+
+	GetDebugPrivilege();
+
+	std::unique_ptr<FTargetProcess> Target;
+	if (!Options.ImagePath.empty())
+	{
+		// mapped and relocated by the loader, but no imports are resolved and no code runs
+		HMODULE Image = LoadLibraryExA(Options.ImagePath.c_str(), nullptr, DONT_RESOLVE_DLL_REFERENCES);
+		if (!Image)
+		{
+			return Fail(ExitTargetNotFound, "failed to map " + Options.ImagePath + ", error code " + std::to_string(GetLastError()));
+		}
+
+		if (Options.ModuleName.empty())
+		{
+			const size_t NameStart = Options.ImagePath.find_last_of("\\/");
+			Options.ModuleName = NameStart == std::string::npos ? Options.ImagePath : Options.ImagePath.substr(NameStart + 1);
+		}
+
+		Target = std::make_unique<FTargetProcess>(GetCurrentProcessId());
+	}
+	else if (Options.PID != 0)
+	{
+		Target = std::make_unique<FTargetProcess>(Options.PID);
+	}
+	else
+	{
+		Target = std::make_unique<FTargetProcess>(Options.ProcessName);
+	}
+
+	if (!Target->IsValid() || Target->GetModules().empty())
+	{
+		return Fail(ExitTargetNotFound, "failed to attach to the target process");
+	}
+
+	if (Options.ModuleName.empty())
+	{
+		Options.ModuleName = Target->GetModules()[0].Name;
+	}
+
+	if (!Target->GetModule(Options.ModuleName))
+	{
+		return Fail(ExitModuleNotFound, "module " + Options.ModuleName + " not found");
+	}
+
+	PrintEvent("attached", "module", Options.ModuleName);
+
+	RTTI Dumper(Target.get(), Options.ModuleName);
+	Dumper.SetResultCacheEnabled(Options.bUseCache);
+	Dumper.ProcessRTTIAsync();
+	WaitForProcessing(Dumper);
+
+	const size_t NumClasses = Dumper.GetClasses().size();
+	if (NumClasses == 0)
+	{
+		return Fail(ExitNoClassesFound, "no classes found in " + Options.ModuleName);
+	}
+
+	if (Options.bScanAll)
+	{
+		PrintEvent("stage", "stage", "Scanning for code references and instances...");
+		Dumper.ScanAllAsync();
+		WaitForScanning(Dumper);
+	}
+
+	PrintEvent("stage", "stage", "Writing " + Options.OutputPath + "...");
+
+	size_t NumWritten = 0;
+	uint64_t BytesWritten = 0;
+
+	if (Options.Format == EOutputFormat::Diff)
+	{
+		FClassDatabase OldDatabase;
+		if (!OldDatabase.Open(Options.BasePath))
+		{
+			return Fail(ExitInvalidArguments, "failed to open " + Options.BasePath);
+		}
+
+		// the new side of the diff is the current dump, written next to the report
+		const std::string NewPath = Options.OutputPath + ".cd3db";
+		FClassDatabaseWriter Writer(Dumper);
+		FClassDatabase NewDatabase;
+		if (!Writer.Write(NewPath) || !NewDatabase.Open(NewPath))
+		{
+			return Fail(ExitWriteFailed, "failed to write " + NewPath);
+		}
+
+		FClassDiff Diff(OldDatabase, NewDatabase);
+		Diff.Run();
+		if (!Diff.WriteReport(Options.OutputPath))
+		{
+			return Fail(ExitWriteFailed, "failed to write " + Options.OutputPath);
+		}
+
+		const FClassDiffStats& Stats = Diff.GetStats();
+		fprintf(stdout, "{\"event\":\"diff\",\"matched\":%zu,\"added\":%zu,\"removed\":%zu,\"changed_vtables\":%zu,\"renames\":%zu,\"ms\":%.2f}\n",
+			Diff.GetMatches().size(),
+			Stats.NumAdded,
+			Stats.NumRemoved,
+			Stats.NumChangedVTables,
+			Stats.NumRenames,
+			Stats.ElapsedMs);
+
+		NumWritten = NumClasses;
+		BytesWritten = NewDatabase.GetHeader().FileSize;
+	}
+	else if (Options.Format == EOutputFormat::Database)
+	{
+		FClassDatabaseWriter Writer(Dumper);
+		FClassDatabase Database;
+		if (!Writer.Write(Options.OutputPath) || !Database.Open(Options.OutputPath))
+		{
+			return Fail(ExitWriteFailed, "failed to write " + Options.OutputPath);
+		}
+
+		NumWritten = Database.GetClasses().size();
+		BytesWritten = Database.GetHeader().FileSize;
+	}
+	else if (Options.Format == EOutputFormat::Json)
+	{
+		FJsonExporter Exporter(Dumper);
+		if (!Exporter.Export(Options.OutputPath))
+		{
+			return Fail(ExitWriteFailed, "failed to write " + Options.OutputPath);
+		}
+
+		NumWritten = Exporter.GetStats().NumClasses;
+		BytesWritten = Exporter.GetStats().BytesWritten;
+	}
+	else
+	{
+		FHeaderExportSettings Settings;
+		Settings.bIncludeAddresses = Options.bIncludeAddresses;
+
+		FHeaderExporter Exporter(Dumper, Settings);
+		if (!Exporter.Export(Options.OutputPath))
+		{
+			return Fail(ExitWriteFailed, "failed to write " + Options.OutputPath);
+		}
+
+		NumWritten = Exporter.GetStats().NumClasses;
+		BytesWritten = Exporter.GetStats().BytesWritten;
+	}
+
+	fprintf(stdout, "{\"event\":\"done\",\"exit_code\":%d,\"classes\":%zu,\"bytes\":%llu,\"output\":\"%s\"}\n",
+		ExitSuccess,
+		NumWritten,
+		static_cast<unsigned long long>(BytesWritten),
+		EscapeJson(Options.OutputPath).c_str());
+
+	return ExitSuccess;
+}
@@ -1,4 +1,5 @@
 #include "ClassDumper3.h"
+#include "Util/Log.h"
 
 std::shared_ptr<LogWindow> ClassDumper3::LogWnd = nullptr;
 std::mutex ClassDumper3::LogMutex;
@@ -55,6 +56,9 @@ void ClassDumper3::Initialize()
 
 	LogWnd = IWindow::Create<LogWindow>();
 	LogWnd->Enable();
+
+	// scanner output goes to the log window
+	FLog::SetSink([](const char* Message) { ClassDumper3::Log(Message); });
 }
 
 void ClassDumper3::CleanExit()
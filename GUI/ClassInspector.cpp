@@ -78,6 +78,18 @@ void ClassInspector::Draw()
 	{
 		RTTIObserver->ScanForClassInstancesAsync(SelectedClassWeak);
 	}
+	ImGui::SameLine();
+
+	if (ImGui::Button("Scan for Derived Instances"))
+	{
+		RTTIObserver->ScanForPolymorphicInstancesAsync(SelectedClassWeak);
+	}
+	ImGui::SameLine();
+
+	if (ImGui::Button("Sample Layout"))
+	{
+		RTTIObserver->SampleLayoutAsync(SelectedClassWeak);
+	}
 
 	if (RTTIObserver->IsAsyncScanning())
 	{
@@ -91,6 +103,11 @@ void ClassInspector::Draw()
 
 	ImGui::Text("CompleteObjectLocator: 0x%s", IntegerToHexStr(SelectedClassWeak->CompleteObjectLocator).c_str());
 
+	if (SelectedClassWeak->ObjectSizeSource != EObjectSizeSource::Unknown)
+	{
+		ImGui::Text("Object Size: 0x%X (%s)", SelectedClassWeak->ObjectSize, RTTI::GetObjectSizeSourceName(SelectedClassWeak->ObjectSizeSource));
+	}
+
 	ImGui::Text("Num Inherited: %d", SelectedClassWeak->Parents.size());
 	{
 		for (const std::shared_ptr<ParentClass>& Parent : SelectedClassWeak->Parents)
@@ -127,36 +144,76 @@ void ClassInspector::Draw()
 		}
 	}
 
+	DrawSpecialFunctions("Constructors", SelectedClassWeak->Constructors);
+	DrawSpecialFunctions("Destructors", SelectedClassWeak->Destructors);
+	DrawSpecialFunctions("Constructors or Destructors", SelectedClassWeak->StructorCandidates);
+
 	ImGui::Text("Virtual Function Table: 0x%s", IntegerToHexStr(SelectedClassWeak->VTable).c_str());
 
-	ImGui::Text("Num Virtual Functions: %d", static_cast<int>(SelectedClassWeak->Functions.size()));
+	FFunctionTable& FunctionTable = RTTIObserver->GetFunctionTable();
+	const FVTableView VTable = FunctionTable.GetVTable(SelectedClassWeak->ClassID);
+
+	ImGui::Text("Num Virtual Functions: %d", static_cast<int>(VTable.size()));
 	{
-		ScopedColor Color(ImGuiCol_Text, Color::Green);
-		int Index = 0;
+		std::vector<FSlotCallCount> CallCounts;
+		if (!RTTIObserver->IsAsyncScanning())
+		{
+			CallCounts = RTTIObserver->GetVirtualCallCounts(SelectedClassWeak);
+		}
 
-		for (const auto& Function : SelectedClassWeak->Functions)
+		for (size_t Index = 0; Index < VTable.size(); Index++)
 		{
-			auto it = SelectedClassWeak->FunctionNames.find(Function);
-			std::string FunctionName = (it != SelectedClassWeak->FunctionNames.end()) ? it->second : "<unknown>";
-			// todo refactor function names to be global per process.
+			const uint32_t FunctionIndex = VTable[Index];
+			const ESlotStatus Status = FunctionTable.GetSlotStatus(SelectedClassWeak->ClassID, static_cast<uint32_t>(Index));
 
-			std::string FunctionText = std::to_string(Index) + " - " + IntegerToHexStr(Function) + " : " + FunctionName;
-			ImGui::Text("%s", FunctionText.c_str());
+			std::string FunctionText = std::to_string(Index) + " - " + IntegerToHexStr(FunctionTable.GetAddress(FunctionIndex)) + " : " + RTTIObserver->GetFunctionName(FunctionIndex);
 
-			if (ImGui::IsItemClicked(EMouseButton::Left))
+			if (Index < CallCounts.size())
 			{
-				// insert disassembler tool here
+				FunctionText += " [calls: " + std::to_string(CallCounts[Index].Total) + ", via this: " + std::to_string(CallCounts[Index].FromThis) + "]";
 			}
-			if (ImGui::IsItemClicked(EMouseButton::Right) && it != SelectedClassWeak->FunctionNames.end())
+
+			switch (Status)
 			{
-				RenameFunction(&(*it)); 
+			case ESlotStatus::Inherited:
+			{
+				ScopedColor Color(ImGuiCol_Text, ImVec4(0.6f, 0.6f, 0.6f, 1.0f));
+				ImGui::Text("%s", FunctionText.c_str());
+				break;
+			}
+			case ESlotStatus::Overridden:
+			{
+				ScopedColor Color(ImGuiCol_Text, Color::Yellow);
+				ImGui::Text("%s (override)", FunctionText.c_str());
+				break;
+			}
+			default:
+			{
+				ScopedColor Color(ImGuiCol_Text, Color::Green);
+				ImGui::Text("%s (new)", FunctionText.c_str());
+				break;
+			}
+			}
+
+			if (ImGui::IsItemHovered())
+			{
+				DrawFunctionUsers(FunctionIndex);
 			}
 
-			Index++;
+			if (ImGui::IsItemClicked(EMouseButton::Left))
+			{
+				OpenDisassembly(FunctionIndex);
+			}
+			if (ImGui::IsItemClicked(EMouseButton::Right))
+			{
+				RenameFunction(FunctionIndex);
+			}
 		}
 
 	}
 
+	DrawMembers();
+
 	ImGui::NextColumn();
 	DrawClassReferences();
 
@@ -190,24 +247,67 @@ void ClassInspector::DrawClassReferences()
 	ImGui::EndChildFrame();
 
 	ImGui::Text("Instances:");
+	ImGui::SameLine();
+	FInstanceValidationSettings ValidationSettings = RTTIObserver->GetInstanceValidationSettings();
+	int Threshold = ValidationSettings.ConfidenceThreshold;
+	ImGui::PushItemWidth(150);
+	if (ImGui::SliderInt("Min Confidence", &Threshold, 0, 100))
+	{
+		ValidationSettings.ConfidenceThreshold = static_cast<uint8_t>(Threshold);
+		RTTIObserver->SetInstanceValidationSettings(ValidationSettings);
+	}
+	ImGui::PopItemWidth();
 	ImGui::BeginChildFrame(3, { 300,300 }, ImGuiWindowFlags_NoCollapse);
 	if (!RTTIObserver->IsAsyncScanning())
 	{
-		for (const auto& Instance : SelectedClassWeak->ClassInstances)
+		for (const FClassInstance& Instance : SelectedClassWeak->ClassInstances)
 		{
-			std::string InstanceStr = "0x" + IntegerToHexStr(Instance);
+			DrawInstance(Instance);
+		}
+	}
+	ImGui::EndChildFrame();
 
-			ImGui::Text(InstanceStr.c_str());
+	DrawPolymorphicInstances();
+}
 
-			if (ImGui::IsItemClicked(EMouseButton::Right))
-			{
-				ClassDumper3::CopyToClipboard(InstanceStr);
-			}
+void ClassInspector::DrawPolymorphicInstances()
+{
+	if (RTTIObserver->IsAsyncScanning() || RTTIObserver->GetPolymorphicScanRoot() != RTTIObserver->GetCompleteClass(SelectedClassWeak))
+	{
+		return;
+	}
+
+	ImGui::Text("Derived Instances:");
+	ImGui::BeginChildFrame(4, { 300,300 }, ImGuiWindowFlags_NoCollapse);
+	for (const FInstanceGroup& Group : RTTIObserver->GetPolymorphicScanResults())
+	{
+		std::string Header = Group.Class->Name + " (" + std::to_string(Group.Instances.size()) + ")";
+		if (!ImGui::TreeNode(Header.c_str()))
+		{
+			continue;
 		}
+
+		for (const FClassInstance& Instance : Group.Instances)
+		{
+			DrawInstance(Instance);
+		}
+		ImGui::TreePop();
 	}
 	ImGui::EndChildFrame();
 }
 
+void ClassInspector::DrawInstance(const FClassInstance& Instance)
+{
+	std::string InstanceStr = "0x" + IntegerToHexStr(Instance.Address);
+
+	ImGui::Text("%s (%u%%, %s)", InstanceStr.c_str(), Instance.Confidence, FInstanceValidator::GetRegionName(Instance.Region));
+
+	if (ImGui::IsItemClicked(EMouseButton::Right))
+	{
+		ClassDumper3::CopyToClipboard(InstanceStr);
+	}
+}
+
 void ClassInspector::OnProcessSelectedDelegate(std::shared_ptr<FTargetProcess> InTarget, std::shared_ptr<RTTI> InRTTI)
 {
 	Target = InTarget;
@@ -218,9 +318,118 @@ void ClassInspector::OnClassSelectedDelegate(std::shared_ptr<ClassMetaData> InCl
 {
 	SelectedClassWeak = InClass;
 	Enable();
+
+	// decode the vtable in the background so opening any of its functions is instant
+	if (RTTIObserver)
+	{
+		RTTIObserver->PrefetchDisassembly(InClass);
+	}
+}
+
+void ClassInspector::DrawFunctionUsers(uint32_t FunctionIndex)
+{
+	constexpr size_t MaxListedSlots = 16;
+	std::span<const FFunctionSlot> Slots = RTTIObserver->GetFunctionTable().GetSlots(FunctionIndex);
+
+	ImGui::BeginTooltip();
+
+	if (uint32_t Size = RTTIObserver->GetFunctionTable().GetSize(FunctionIndex))
+	{
+		ImGui::Text("Size: 0x%X bytes", Size);
+	}
+
+	ImGui::Text("In %d vtables:", static_cast<int>(Slots.size()));
+
+	for (size_t i = 0; i < Slots.size() && i < MaxListedSlots; i++)
+	{
+		std::shared_ptr<ClassMetaData> Class = RTTIObserver->GetClass(Slots[i].ClassID);
+		ImGui::Text("%s [%u]", Class ? Class->Name.c_str() : "<unknown>", Slots[i].Slot);
+	}
+
+	if (Slots.size() > MaxListedSlots)
+	{
+		ImGui::Text("...");
+	}
+
+	ImGui::EndTooltip();
+}
+
+void ClassInspector::DrawMembers()
+{
+	std::shared_ptr<ClassMetaData> Complete = RTTIObserver->GetCompleteClass(SelectedClassWeak);
+	if (!Complete || Complete->Members.empty() || RTTIObserver->IsAsyncScanning())
+	{
+		return;
+	}
+
+	ImGui::Text("Inferred Layout (%d fields):", static_cast<int>(Complete->Members.size()));
+
+	if (!ImGui::BeginTable("MemberTable", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY, ImVec2(0, 250)))
+	{
+		return;
+	}
+
+	ImGui::TableSetupColumn("Offset");
+	ImGui::TableSetupColumn("Kind");
+	ImGui::TableSetupColumn("Agreement");
+	ImGui::TableSetupColumn("Example");
+	ImGui::TableHeadersRow();
+
+	for (const FFieldLayout& Member : Complete->Members)
+	{
+		ImGui::TableNextRow();
+		ImGui::TableSetColumnIndex(0);
+		ImGui::Text("+0x%X", Member.Offset);
+
+		ImGui::TableSetColumnIndex(1);
+		std::shared_ptr<ClassMetaData> MemberClass = Member.ClassID != FAddressIndex::InvalidIndex ? RTTIObserver->GetClass(Member.ClassID) : nullptr;
+		if (MemberClass)
+		{
+			ScopedColor Color(ImGuiCol_Text, Color::Cyan);
+			ImGui::Text("%s (%s)", FLayoutSampler::GetFieldKindName(Member.Kind), MemberClass->Name.c_str());
+		}
+		else
+		{
+			ImGui::Text("%s", FLayoutSampler::GetFieldKindName(Member.Kind));
+		}
+
+		ImGui::TableSetColumnIndex(2);
+		ImGui::Text("%u%%", Member.Agreement);
+
+		ImGui::TableSetColumnIndex(3);
+		ImGui::Text("0x%p", reinterpret_cast<void*>(Member.Example));
+	}
+
+	ImGui::EndTable();
+}
+
+void ClassInspector::DrawSpecialFunctions(const char* Label, const std::vector<uint32_t>& Functions)
+{
+	if (Functions.empty())
+	{
+		return;
+	}
+
+	ImGui::Text("%s: %d", Label, static_cast<int>(Functions.size()));
+
+	ScopedColor Color(ImGuiCol_Text, Color::Cyan);
+	for (uint32_t FunctionIndex : Functions)
+	{
+		const std::string FunctionText = IntegerToHexStr(RTTIObserver->GetFunctionTable().GetAddress(FunctionIndex)) + " : " + RTTIObserver->GetFunctionName(FunctionIndex);
+		ImGui::Text("%s", FunctionText.c_str());
+
+		if (ImGui::IsItemClicked(EMouseButton::Left))
+		{
+			OpenDisassembly(FunctionIndex);
+		}
+		if (ImGui::IsItemClicked(EMouseButton::Right))
+		{
+			RenameFunction(FunctionIndex);
+		}
+	}
 }
 
-void ClassInspector::RenameFunction(std::pair<const uintptr_t, std::string>* InFunction)
+void ClassInspector::RenameFunction(uint32_t FunctionIndex)
 {
 	if (RenamePopupWnd)
 	{
@@ -229,7 +438,17 @@ void ClassInspector::RenameFunction(std::pair<const uintptr_t, std::string>* InF
 	}
 
 	RenamePopupWnd = IWindow::Create<RenamePopup>();
-	RenamePopupWnd->Initialize(InFunction);
+	RenamePopupWnd->Initialize(RTTIObserver, FunctionIndex);
+}
+
+void ClassInspector::OpenDisassembly(uint32_t FunctionIndex)
+{
+	if (!DisassemblyWnd)
+	{
+		DisassemblyWnd = IWindow::Create<DisassemblyWindow>();
+	}
+
+	DisassemblyWnd->Open(RTTIObserver, FunctionIndex);
 }
 
 void ClassInspector::CopyInfo()
@@ -237,6 +456,10 @@ void ClassInspector::CopyInfo()
     // Copy all class info
     std::string Info = "Name: " + SelectedClassWeak->Name + "\n";
 	Info += "CompleteObjectLocator: 0x" + IntegerToHexStr(SelectedClassWeak->CompleteObjectLocator) + "\n";
+	if (SelectedClassWeak->ObjectSizeSource != EObjectSizeSource::Unknown)
+	{
+		Info += "Object Size: 0x" + IntegerToHexStr(SelectedClassWeak->ObjectSize) + " (" + RTTI::GetObjectSizeSourceName(SelectedClassWeak->ObjectSizeSource) + ")\n";
+	}
 	Info += "Num Inherited: " + std::to_string(SelectedClassWeak->Parents.size()) + "\n";
 
     for (const std::shared_ptr<ParentClass>& Parent : SelectedClassWeak->Parents)
@@ -245,21 +468,37 @@ void ClassInspector::CopyInfo()
     }
 
 	Info += "Num Interfaces: " + std::to_string(SelectedClassWeak->Interfaces.size()) + "\n";
+	const FFunctionTable& FunctionTable = RTTIObserver->GetFunctionTable();
+	for (uint32_t FunctionIndex : SelectedClassWeak->Constructors)
+	{
+		Info += "Constructor: " + IntegerToHexStr(FunctionTable.GetAddress(FunctionIndex)) + " : " + RTTIObserver->GetFunctionName(FunctionIndex) + "\n";
+	}
+	for (uint32_t FunctionIndex : SelectedClassWeak->Destructors)
+	{
+		Info += "Destructor: " + IntegerToHexStr(FunctionTable.GetAddress(FunctionIndex)) + " : " + RTTIObserver->GetFunctionName(FunctionIndex) + "\n";
+	}
+	for (uint32_t FunctionIndex : SelectedClassWeak->StructorCandidates)
+	{
+		Info += "Constructor or Destructor: " + IntegerToHexStr(FunctionTable.GetAddress(FunctionIndex)) + " : " + RTTIObserver->GetFunctionName(FunctionIndex) + "\n";
+	}
+
 	Info += "Virtual Function Table: 0x" + IntegerToHexStr(SelectedClassWeak->VTable) + "\n";
-	Info += "Num Virtual Functions: " + std::to_string(SelectedClassWeak->Functions.size()) + "\n";
+	const FVTableView VTable = FunctionTable.GetVTable(SelectedClassWeak->ClassID);
+	Info += "Num Virtual Functions: " + std::to_string(VTable.size()) + "\n";
 
-    for (const auto& FunctionName : SelectedClassWeak->FunctionNames)
+    for (uint32_t FunctionIndex : VTable)
     {
-		Info += IntegerToHexStr(FunctionName.first) + " : " + FunctionName.second + "\n";
+		Info += IntegerToHexStr(FunctionTable.GetAddress(FunctionIndex)) + " : " + RTTIObserver->GetFunctionName(FunctionIndex) + "\n";
     }
 
 	ClassDumper3::CopyToClipboard(Info);
 }
 
 
-void RenamePopup::Initialize(std::pair<const uintptr_t, std::string>* InFunction)
+void RenamePopup::Initialize(std::shared_ptr<RTTI> InRTTI, uint32_t InFunctionIndex)
 {
-	FunctionPtr = InFunction;
+	RTTIObserver = InRTTI;
+	FunctionIndex = InFunctionIndex;
 	Enable();
 }
 
@@ -274,13 +513,13 @@ void RenamePopup::Draw()
 
     if (ImGui::Button("Rename") && !NewName.empty())
     {
-        FunctionPtr->second = NewName;
+        RTTIObserver->RenameFunction(FunctionIndex, NewName);
         Disable();
     }
 
     if (ImGui::IsKeyDown(ImGuiKey_Enter) && !NewName.empty())
     {
-        FunctionPtr->second = NewName;
+        RTTIObserver->RenameFunction(FunctionIndex, NewName);
         Disable();
     }
 
@@ -3,6 +3,7 @@
 #include "../Delegate.h"
 #include "../W32/Memory.h"
 #include "../W32/RTTI.h"
+#include "DisassemblyWindow.h"
 #include <memory>
 
 class RenamePopup : public IWindow
@@ -10,11 +11,12 @@ class RenamePopup : public IWindow
 public:
 	RenamePopup() {};
 	~RenamePopup(){};
-	void Initialize(std::pair<const uintptr_t, std::string>* InFunction);
+	void Initialize(std::shared_ptr<RTTI> InRTTI, uint32_t InFunctionIndex);
 	void Draw() override;
 protected:
 	std::string NewName;
-	std::pair<const uintptr_t, std::string>* FunctionPtr = nullptr;
+	std::shared_ptr<RTTI> RTTIObserver;
+	uint32_t FunctionIndex = FFunctionTable::InvalidIndex;
 };
 
 class ClassInspector : public IWindow, public std::enable_shared_from_this<ClassInspector>
@@ -27,9 +29,15 @@ public:
 protected:
 	void DrawClass();
 	void DrawClassReferences();
+	void DrawPolymorphicInstances();
+	void DrawInstance(const FClassInstance& Instance);
 	void OnProcessSelectedDelegate(std::shared_ptr<FTargetProcess> Target, std::shared_ptr<RTTI> RTTI);
 	void OnClassSelectedDelegate(std::shared_ptr<ClassMetaData> InClass);
-	void RenameFunction(std::pair<const uintptr_t, std::string>* InFunction);
+	void DrawFunctionUsers(uint32_t FunctionIndex);
+	void DrawMembers();
+	void DrawSpecialFunctions(const char* Label, const std::vector<uint32_t>& Functions);
+	void RenameFunction(uint32_t FunctionIndex);
+	void OpenDisassembly(uint32_t FunctionIndex);
 	void CopyInfo();
 	
 	std::shared_ptr<ClassMetaData> SelectedClassWeak;
@@ -38,4 +46,5 @@ protected:
 
 	// popups
 	std::shared_ptr<RenamePopup> RenamePopupWnd;
+	std::shared_ptr<DisassemblyWindow> DisassemblyWnd;
 };
\ No newline at end of file
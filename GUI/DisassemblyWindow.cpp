@@ -0,0 +1,107 @@
+#include "DisassemblyWindow.h"
+#include "CustomWidgets.h"
+#include "../ClassDumper3.h"
+#include "../Util/Strings.h"
+
+void DisassemblyWindow::Open(std::shared_ptr<RTTI> InRTTI, uint32_t InFunctionIndex)
+{
+	RTTIObserver = InRTTI;
+	FunctionIndex = InFunctionIndex;
+	Listing.reset();
+	RTTIObserver->RequestDisassembly(FunctionIndex);
+	Enable();
+}
+
+void DisassemblyWindow::Draw()
+{
+	if (!RTTIObserver || FunctionIndex >= RTTIObserver->GetFunctionTable().GetNumFunctions())
+	{
+		Disable();
+		return;
+	}
+
+	FDisassemblyCache* Cache = RTTIObserver->GetDisassemblyCache();
+	const uintptr_t Address = RTTIObserver->GetFunctionTable().GetAddress(FunctionIndex);
+
+	if (!Listing && Cache)
+	{
+		Listing = Cache->Find(Address);
+	}
+
+	ImVec2 screenSize = ImGui::GetIO().DisplaySize;
+	ImGui::SetNextWindowSize(ImVec2(screenSize.x * 0.35f, screenSize.y * 0.5f), ImGuiCond_FirstUseEver);
+
+	bool bOpen = true;
+	const std::string Title = RTTIObserver->GetFunctionName(FunctionIndex) + "###Disassembly";
+	ImGui::Begin(Title.c_str(), &bOpen, ImGuiWindowFlags_NoCollapse);
+
+	ImGui::Text("0x%p", reinterpret_cast<void*>(Address));
+
+	if (!Listing)
+	{
+		ImGui::SameLine();
+		ImGui::Text("Decoding...");
+		ImGui::SameLine();
+		ImGui::Spinner("DisassemblySpinner", 10, 10, 0xFF0000FF);
+
+		// the request is dropped if it is already cached or queued, so this also covers an eviction since Open
+		RTTIObserver->RequestDisassembly(FunctionIndex);
+	}
+	else
+	{
+		ImGui::SameLine();
+		ImGui::Text("| 0x%X bytes | %d instructions", static_cast<uint32_t>(Listing->Size), static_cast<int>(Listing->GetNumLines()));
+
+		if (Listing->bTruncated)
+		{
+			ImGui::SameLine();
+			ImGui::TextColored(Color::Yellow, "(truncated)");
+		}
+
+		ImGui::SameLine();
+		if (ImGui::Button("Copy"))
+		{
+			CopyListing();
+		}
+
+		ImGui::Separator();
+		ImGui::BeginChild("DisassemblyListing");
+
+		// only the visible page of lines is formatted into the draw list
+		ImGuiListClipper Clipper;
+		Clipper.Begin(static_cast<int>(Listing->GetNumLines()));
+		while (Clipper.Step())
+		{
+			for (int Line = Clipper.DisplayStart; Line < Clipper.DisplayEnd; Line++)
+			{
+				const std::string_view Text = Listing->GetLineText(Line);
+				ImGui::TextDisabled("%p", reinterpret_cast<void*>(Listing->GetLineAddress(Line)));
+				ImGui::SameLine();
+				ImGui::Text("%.*s", static_cast<int>(Text.size()), Text.data());
+			}
+		}
+		Clipper.End();
+
+		ImGui::EndChild();
+	}
+
+	ImGui::End();
+
+	if (!bOpen)
+	{
+		Listing.reset();
+		Disable();
+	}
+}
+
+void DisassemblyWindow::CopyListing()
+{
+	std::string Info = RTTIObserver->GetFunctionName(FunctionIndex) + "\n";
+
+	for (size_t Line = 0; Line < Listing->GetNumLines(); Line++)
+	{
+		Info += IntegerToHexStr(Listing->GetLineAddress(Line)) + " | " + std::string(Listing->GetLineText(Line)) + "\n";
+	}
+
+	ClassDumper3::CopyToClipboard(Info);
+}
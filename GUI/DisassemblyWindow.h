@@ -0,0 +1,19 @@
+#pragma once
+#include "Interfaces/IWindow.h"
+#include "../W32/RTTI.h"
+#include <memory>
+
+class DisassemblyWindow : public IWindow
+{
+public:
+	DisassemblyWindow() {};
+	~DisassemblyWindow() {};
+	void Open(std::shared_ptr<RTTI> InRTTI, uint32_t InFunctionIndex);
+	void Draw() override;
+protected:
+	void CopyListing();
+
+	std::shared_ptr<RTTI> RTTIObserver;
+	uint32_t FunctionIndex = FFunctionTable::InvalidIndex;
+	std::shared_ptr<const FFunctionListing> Listing; // kept while shown, even if the cache evicts it
+};
@@ -41,6 +41,11 @@ void MainWindow::Draw()
 		}
 	}
 
+	if (ImGui::CollapsingHeader("Class Census"))
+	{
+		DrawClassCensus();
+	}
+
 	if (ImGui::CollapsingHeader("Class Viewer", ImGuiTreeNodeFlags_DefaultOpen))
 	{
 		DrawClassList();
@@ -171,6 +176,63 @@ void MainWindow::DrawClassList()
 		RTTIObserver->ScanAllAsync();
 	}
 
+	ImGui::SameLine();
+	if (ImGui::Button("Benchmark Code Scan"))
+	{
+		RTTIObserver->BenchmarkCodeReferenceScanAsync();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Benchmark Hashing"))
+	{
+		RTTIObserver->BenchmarkHashingAsync();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Scan Virtual Calls"))
+	{
+		RTTIObserver->ScanForVirtualCallsAsync();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Export Header"))
+	{
+		// game.exe -> game.h in the working directory
+		RTTIObserver->ExportHeaderAsync(SelectedModuleName.substr(0, SelectedModuleName.find_last_of('.')) + ".h");
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Export JSON"))
+	{
+		RTTIObserver->ExportJsonAsync(SelectedModuleName.substr(0, SelectedModuleName.find_last_of('.')) + ".ndjson");
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Save Database"))
+	{
+		RTTIObserver->SaveDatabaseAsync(SelectedModuleName.substr(0, SelectedModuleName.find_last_of('.')) + ".cd3db");
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Diff Saved Database"))
+	{
+		// the database Save Database wrote for an older build of the module
+		const std::string BaseName = SelectedModuleName.substr(0, SelectedModuleName.find_last_of('.'));
+		RTTIObserver->DiffWithDatabaseAsync(BaseName + ".cd3db", BaseName + ".diff.txt");
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Benchmark Export"))
+	{
+		RTTIObserver->BenchmarkJsonExportAsync();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Benchmark Diff"))
+	{
+		RTTIObserver->BenchmarkClassDiffAsync();
+	}
+
 	if (RTTIObserver->IsAsyncScanning())
 	{
 		ImGui::SameLine();
@@ -178,6 +240,12 @@ void MainWindow::DrawClassList()
 		ImGui::SameLine();
 		ImGui::Spinner("ScanSpinner", 10, 10, 0xFF0000FF);
 	}
+	else if (FScanPipelineStats Stats = RTTIObserver->GetLastScanStats(); Stats.TotalNs > 0)
+	{
+		ImGui::SameLine();
+		ImGui::TextDisabled("Last scan: %.1f ms | reader stall %.1f ms | scanner stall %.1f ms",
+			Stats.TotalNs / 1e6, Stats.ReaderStallNs / 1e6, Stats.ScannerStallNs / 1e6);
+	}
 
 	if (ImGui::Button("Filter Children"))
 	{
@@ -251,7 +319,7 @@ void MainWindow::DrawClassList()
 			}
 
 			ImGui::TableSetColumnIndex(1);
-			ImGui::Text("%d", Class->Functions.size());
+			ImGui::Text("%d", static_cast<int>(RTTIObserver->GetNumFunctions(Class)));
 
 			ImGui::TableSetColumnIndex(2);
 			ImGui::Text("0x%p", reinterpret_cast<void*>(Class->VTable));
@@ -263,6 +331,88 @@ void MainWindow::DrawClassList()
 	ImGui::EndChild();
 }
 
+void MainWindow::DrawClassCensus()
+{
+	if (!RTTIObserver || RTTIObserver->IsAsyncProcessing()) return;
+
+	if (ImGui::Button("Run Census"))
+	{
+		RTTIObserver->RunClassCensusAsync();
+	}
+
+	ImGui::SameLine();
+	ImGui::PushItemWidth(100);
+	if (ImGui::InputInt("Top N", &CensusTopN))
+	{
+		CensusTopN = std::max(CensusTopN, 1);
+		CensusCache.Generation = 0;
+	}
+	ImGui::PopItemWidth();
+
+	if (RTTIObserver->IsAsyncScanning())
+	{
+		ImGui::SameLine();
+		ImGui::Spinner("CensusSpinner", 10, 10, 0xFF0000FF);
+		return;
+	}
+
+	if (CensusCache.Generation != RTTIObserver->GetClassCensusGeneration())
+	{
+		CensusCache = RTTIObserver->GetClassCensus(CensusTopN);
+	}
+
+	if (CensusCache.Generation == 0)
+	{
+		return;
+	}
+
+	ImGui::Text("Census #%u: %llu live instances", CensusCache.Generation, CensusCache.TotalInstances);
+
+	if (!ImGui::BeginTable("CensusTable", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY, ImVec2(0, 300)))
+	{
+		return;
+	}
+
+	ImGui::TableSetupColumn("Class Name");
+	ImGui::TableSetupColumn("Count");
+	ImGui::TableSetupColumn("Delta");
+	ImGui::TableSetupColumn("Examples");
+	ImGui::TableHeadersRow();
+
+	for (const FCensusEntry& Entry : CensusCache.Entries)
+	{
+		ImGui::TableNextRow();
+		ImGui::TableSetColumnIndex(0);
+		ImGui::TextUnformatted(Entry.Class->Name.c_str());
+
+		if (ImGui::IsItemClicked())
+		{
+			OnClassSelected(Entry.Class);
+			SelectedClassWeak = Entry.Class;
+		}
+
+		ImGui::TableSetColumnIndex(1);
+		ImGui::Text("%llu", Entry.Count);
+
+		ImGui::TableSetColumnIndex(2);
+		if (Entry.Delta != 0)
+		{
+			ScopedColor DeltaColor(ImGuiCol_Text, Entry.Delta > 0 ? Color::Red : Color::Green);
+			ImGui::Text("%+lld", Entry.Delta);
+		}
+
+		ImGui::TableSetColumnIndex(3);
+		for (uintptr_t Sample : Entry.Samples)
+		{
+			ImGui::Text("0x%p", reinterpret_cast<void*>(Sample));
+			ImGui::SameLine();
+		}
+		ImGui::NewLine();
+	}
+
+	ImGui::EndTable();
+}
+
 void MainWindow::DrawClass(const std::shared_ptr<ClassMetaData>& CMeta)
 {
 	auto SelectedClassLocked = SelectedClassWeak.lock();
@@ -23,6 +23,7 @@ protected:
 	void FilterChildren();
 	void DrawClassList();
 	void DrawClass(const std::shared_ptr<ClassMetaData>& cl);
+	void DrawClassCensus();
 	
 	std::string SelectedProcessName;
 	std::string SelectedModuleName;
@@ -35,5 +36,8 @@ protected:
 	std::shared_ptr<RTTI> RTTIObserver;
 	std::weak_ptr<ClassMetaData> SelectedClassWeak;
 
+	int CensusTopN = 50;
+	FClassCensus CensusCache;
+
 	std::string Title = "ClassDumper3";
 };
\ No newline at end of file
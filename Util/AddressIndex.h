@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Open addressing hash map from non-zero addresses to 32 bit indices, built once and queried from
+ * many threads. Tuned for scanning loops where almost every candidate misses: a range check and a
+ * small bit filter reject most values before the table itself is touched.
+ */
+class FAddressIndex
+{
+public:
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	FAddressIndex() = default;
+
+	void Reserve(size_t Count)
+	{
+		size_t Capacity = 16;
+		while (Capacity < Count * 2)
+		{
+			Capacity <<= 1;
+		}
+
+		Keys.assign(Capacity, 0);
+		Values.assign(Capacity, InvalidIndex);
+		Mask = Capacity - 1;
+		NumEntries = 0;
+		MinKey = UINTPTR_MAX;
+		MaxKey = 0;
+		Filter.assign(FilterWords, 0);
+	}
+
+	void Insert(uintptr_t Key, uint32_t Value)
+	{
+		if (Key == 0)
+		{
+			return;
+		}
+
+		if (Keys.empty() || (NumEntries + 1) * 2 > Keys.size())
+		{
+			Rehash(Keys.empty() ? 16 : Keys.size() * 2);
+		}
+
+		size_t Slot = Hash(Key) & Mask;
+		while (Keys[Slot] != 0 && Keys[Slot] != Key)
+		{
+			Slot = (Slot + 1) & Mask;
+		}
+
+		if (Keys[Slot] == 0)
+		{
+			NumEntries++;
+		}
+
+		Keys[Slot] = Key;
+		Values[Slot] = Value;
+		MinKey = Key < MinKey ? Key : MinKey;
+		MaxKey = Key > MaxKey ? Key : MaxKey;
+
+		const size_t Bit = FilterBit(Key);
+		Filter[Bit >> 6] |= 1ull << (Bit & 63);
+	}
+
+	uint32_t Find(uintptr_t Key) const
+	{
+		if (Key < MinKey || Key > MaxKey)
+		{
+			return InvalidIndex;
+		}
+
+		const size_t Bit = FilterBit(Key);
+		if ((Filter[Bit >> 6] & (1ull << (Bit & 63))) == 0)
+		{
+			return InvalidIndex;
+		}
+
+		for (size_t Slot = Hash(Key) & Mask; Keys[Slot] != 0; Slot = (Slot + 1) & Mask)
+		{
+			if (Keys[Slot] == Key)
+			{
+				return Values[Slot];
+			}
+		}
+
+		return InvalidIndex;
+	}
+
+	bool Contains(uintptr_t Key) const { return Find(Key) != InvalidIndex; }
+	size_t Size() const { return NumEntries; }
+	bool IsEmpty() const { return NumEntries == 0; }
+
+private:
+	static constexpr size_t FilterWords = 1024; // 64k bits, fits in L1
+
+	static size_t Hash(uintptr_t Key)
+	{
+		return static_cast<size_t>((static_cast<uint64_t>(Key) >> 3) * 0x9E3779B97F4A7C15ull >> 17);
+	}
+
+	static size_t FilterBit(uintptr_t Key)
+	{
+		return static_cast<size_t>((Key >> 3) ^ (Key >> 19)) & (FilterWords * 64 - 1);
+	}
+
+	void Rehash(size_t NewCapacity)
+	{
+		std::vector<uintptr_t> OldKeys = std::move(Keys);
+		std::vector<uint32_t> OldValues = std::move(Values);
+
+		Keys.assign(NewCapacity, 0);
+		Values.assign(NewCapacity, InvalidIndex);
+		Mask = NewCapacity - 1;
+		NumEntries = 0;
+
+		if (Filter.empty())
+		{
+			Filter.assign(FilterWords, 0);
+		}
+
+		for (size_t i = 0; i < OldKeys.size(); i++)
+		{
+			if (OldKeys[i] != 0)
+			{
+				Insert(OldKeys[i], OldValues[i]);
+			}
+		}
+	}
+
+	std::vector<uintptr_t> Keys;
+	std::vector<uint32_t> Values;
+	std::vector<uint64_t> Filter;
+	size_t Mask = 0;
+	size_t NumEntries = 0;
+	uintptr_t MinKey = UINTPTR_MAX;
+	uintptr_t MaxKey = 0;
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <windows.h>
+
+/**
+ * Write only file with a large user space buffer. Text is appended without formatting through the CRT,
+ * numbers are converted with std::to_chars, and the buffer goes to disk in one WriteFile call whenever it
+ * fills up, so exporters can stream millions of small pieces without holding the output in memory.
+ * A failed write is sticky: everything after it is dropped and HasFailed reports it.
+ */
+class FBufferedWriter
+{
+public:
+	static constexpr size_t DefaultCapacity = 4 * 1024 * 1024;
+
+	explicit FBufferedWriter(size_t InCapacity = DefaultCapacity)
+	{
+		Buffer.resize(InCapacity);
+	}
+
+	~FBufferedWriter()
+	{
+		Close();
+	}
+
+	FBufferedWriter(const FBufferedWriter&) = delete;
+	FBufferedWriter& operator=(const FBufferedWriter&) = delete;
+
+	bool Open(const std::string& Path)
+	{
+		Close();
+
+		File = CreateFileA(Path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		bFailed = File == INVALID_HANDLE_VALUE;
+		Used = 0;
+		BytesWritten = 0;
+		return !bFailed;
+	}
+
+	// flushes and closes the file, false if anything could not be written
+	bool Close()
+	{
+		if (File == INVALID_HANDLE_VALUE)
+		{
+			return !bFailed;
+		}
+
+		Flush();
+		CloseHandle(File);
+		File = INVALID_HANDLE_VALUE;
+		return !bFailed;
+	}
+
+	bool IsOpen() const { return File != INVALID_HANDLE_VALUE; }
+	bool HasFailed() const { return bFailed; }
+	uint64_t GetBytesWritten() const { return BytesWritten + Used; }
+
+	void Write(const char* Data, size_t Size)
+	{
+		if (Size > Buffer.size() - Used)
+		{
+			Flush();
+
+			// larger than the whole buffer, hand it to the OS directly
+			if (Size > Buffer.size())
+			{
+				WriteToFile(Data, Size);
+				return;
+			}
+		}
+
+		memcpy(Buffer.data() + Used, Data, Size);
+		Used += Size;
+	}
+
+	void Write(std::string_view Text)
+	{
+		Write(Text.data(), Text.size());
+	}
+
+	void Write(char Character)
+	{
+		if (Used == Buffer.size())
+		{
+			Flush();
+		}
+
+		Buffer[Used++] = Character;
+	}
+
+	void WriteDecimal(int64_t Value)
+	{
+		char Text[24];
+		const std::to_chars_result Result = std::to_chars(Text, Text + sizeof(Text), Value);
+		Write(Text, Result.ptr - Text);
+	}
+
+	// lower case hex without prefix or leading zeros
+	void WriteHex(uint64_t Value)
+	{
+		char Text[16];
+		const std::to_chars_result Result = std::to_chars(Text, Text + sizeof(Text), Value, 16);
+		Write(Text, Result.ptr - Text);
+	}
+
+	bool Flush()
+	{
+		if (Used > 0)
+		{
+			WriteToFile(Buffer.data(), Used);
+			Used = 0;
+		}
+
+		return !bFailed;
+	}
+
+protected:
+	void WriteToFile(const char* Data, size_t Size)
+	{
+		while (Size > 0 && !bFailed)
+		{
+			const DWORD Chunk = static_cast<DWORD>(std::min<size_t>(Size, 0x40000000));
+			DWORD Written = 0;
+			if (!WriteFile(File, Data, Chunk, &Written, nullptr) || Written == 0)
+			{
+				bFailed = true;
+				return;
+			}
+
+			Data += Written;
+			Size -= Written;
+			BytesWritten += Written;
+		}
+	}
+
+	HANDLE File = INVALID_HANDLE_VALUE;
+	std::vector<char> Buffer;
+	size_t Used = 0;
+	uint64_t BytesWritten = 0;
+	bool bFailed = false;
+};
@@ -0,0 +1,258 @@
+#include "Hash.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <emmintrin.h>
+#include "ThreadPool.h"
+
+namespace
+{
+	constexpr size_t StripeSize = 64; // four SSE2 lanes
+	constexpr size_t StripesPerBlock = 16;
+	constexpr size_t BlockSize = StripeSize * StripesPerBlock;
+	constexpr size_t KeyStep = 8; // key offset between stripes
+	constexpr size_t SecretSize = StripeSize + KeyStep * StripesPerBlock;
+	constexpr size_t PagesPerBatch = 256; // pages a worker takes at a time
+
+	constexpr uint32_t Prime32 = 0x9E3779B1u;
+	constexpr uint64_t Prime64A = 0x9E3779B185EBCA87ull;
+	constexpr uint64_t Prime64B = 0xC2B2AE3D27D4EB4Full;
+	constexpr uint64_t Prime64C = 0x165667B19E3779F9ull;
+
+	// splitmix64 sequence, the keys only need to be fixed and well mixed
+	constexpr std::array<uint64_t, SecretSize / sizeof(uint64_t)> MakeSecret()
+	{
+		std::array<uint64_t, SecretSize / sizeof(uint64_t)> Secret{};
+		uint64_t State = Prime64C;
+		for (uint64_t& Word : Secret)
+		{
+			State += 0x9E3779B97F4A7C15ull;
+			uint64_t Value = State;
+			Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+			Word = Value ^ (Value >> 31);
+		}
+		return Secret;
+	}
+
+	constexpr std::array<uint64_t, SecretSize / sizeof(uint64_t)> SecretWords = MakeSecret();
+
+	const uint8_t* GetSecret()
+	{
+		return reinterpret_cast<const uint8_t*>(SecretWords.data());
+	}
+
+	uint64_t Avalanche(uint64_t Hash)
+	{
+		Hash ^= Hash >> 33;
+		Hash *= 0xFF51AFD7ED558CCDull;
+		Hash ^= Hash >> 33;
+		Hash *= 0xC4CEB9FE1A85EC53ull;
+		Hash ^= Hash >> 33;
+		return Hash;
+	}
+
+	// per 64 bit lane: acc += swapped data + lo32(data ^ key) * hi32(data ^ key)
+	void AccumulateStripe(__m128i* Acc, const uint8_t* Input, const uint8_t* Key)
+	{
+		for (size_t i = 0; i < 4; i++)
+		{
+			const __m128i DataVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Input) + i);
+			const __m128i KeyVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key) + i);
+			const __m128i DataKey = _mm_xor_si128(DataVec, KeyVec);
+			const __m128i DataKeyHigh = _mm_shuffle_epi32(DataKey, _MM_SHUFFLE(0, 3, 0, 1));
+			const __m128i Product = _mm_mul_epu32(DataKey, DataKeyHigh);
+			const __m128i DataSwap = _mm_shuffle_epi32(DataVec, _MM_SHUFFLE(1, 0, 3, 2));
+			Acc[i] = _mm_add_epi64(Acc[i], _mm_add_epi64(Product, DataSwap));
+		}
+	}
+
+	// keeps the accumulators from saturating, run after every block
+	void ScrambleAccumulators(__m128i* Acc, const uint8_t* Key)
+	{
+		const __m128i PrimeVec = _mm_set1_epi32(static_cast<int>(Prime32));
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			const __m128i Shifted = _mm_xor_si128(Acc[i], _mm_srli_epi64(Acc[i], 47));
+			const __m128i DataKey = _mm_xor_si128(Shifted, _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key) + i));
+			const __m128i DataKeyHigh = _mm_shuffle_epi32(DataKey, _MM_SHUFFLE(0, 3, 0, 1));
+			const __m128i ProductLow = _mm_mul_epu32(DataKey, PrimeVec);
+			const __m128i ProductHigh = _mm_mul_epu32(DataKeyHigh, PrimeVec);
+			Acc[i] = _mm_add_epi64(ProductLow, _mm_slli_epi64(ProductHigh, 32));
+		}
+	}
+
+	template<uint32_t Polynomial>
+	constexpr std::array<uint32_t, 256> MakeCrcTable()
+	{
+		std::array<uint32_t, 256> Table{};
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t Crc = i;
+			for (int Bit = 0; Bit < 8; Bit++)
+			{
+				Crc = (Crc >> 1) ^ (Crc & 1 ? Polynomial : 0);
+			}
+			Table[i] = Crc;
+		}
+		return Table;
+	}
+
+	constexpr std::array<uint32_t, 256> Crc32Table = MakeCrcTable<0xEDB88320u>();
+	constexpr std::array<uint32_t, 256> Crc32CTable = MakeCrcTable<0x82F63B78u>();
+
+	uint32_t UpdateCrc(const std::array<uint32_t, 256>& Table, const void* Data, size_t Size, uint32_t Crc)
+	{
+		const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+		Crc = ~Crc;
+		for (size_t i = 0; i < Size; i++)
+		{
+			Crc = Table[(Crc ^ Bytes[i]) & 0xFF] ^ (Crc >> 8);
+		}
+		return ~Crc;
+	}
+}
+
+FHash128 FHash::Hash128(const void* Data, size_t Size, uint64_t Seed)
+{
+	const uint8_t* Input = static_cast<const uint8_t*>(Data);
+	const uint8_t* Secret = GetSecret();
+
+	alignas(16) uint64_t Lanes[8] = {
+		Prime32, Prime64A, Prime64B, Prime64C,
+		Prime64A ^ Prime64B, Prime64B ^ Prime64C, Prime64C ^ Prime32, Prime64A ^ Prime32
+	};
+	for (size_t i = 0; i < 8; i++)
+	{
+		Lanes[i] ^= Seed * (2 * i + 1);
+	}
+
+	__m128i Acc[4];
+	for (size_t i = 0; i < 4; i++)
+	{
+		Acc[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(Lanes) + i);
+	}
+
+	const size_t NumBlocks = Size / BlockSize;
+	for (size_t Block = 0; Block < NumBlocks; Block++)
+	{
+		const uint8_t* BlockInput = Input + Block * BlockSize;
+		for (size_t Stripe = 0; Stripe < StripesPerBlock; Stripe++)
+		{
+			AccumulateStripe(Acc, BlockInput + Stripe * StripeSize, Secret + Stripe * KeyStep);
+		}
+		ScrambleAccumulators(Acc, Secret + SecretSize - StripeSize);
+	}
+
+	const uint8_t* Rest = Input + NumBlocks * BlockSize;
+	const size_t RestSize = Size - NumBlocks * BlockSize;
+	const size_t NumStripes = RestSize / StripeSize;
+	for (size_t Stripe = 0; Stripe < NumStripes; Stripe++)
+	{
+		AccumulateStripe(Acc, Rest + Stripe * StripeSize, Secret + Stripe * KeyStep);
+	}
+
+	// the partial stripe is zero padded, the size is mixed in below so padding cannot collide
+	if (const size_t TailSize = RestSize - NumStripes * StripeSize)
+	{
+		alignas(16) uint8_t Tail[StripeSize] = {};
+		memcpy(Tail, Rest + NumStripes * StripeSize, TailSize);
+		AccumulateStripe(Acc, Tail, Secret + SecretSize - StripeSize - 7);
+	}
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		_mm_store_si128(reinterpret_cast<__m128i*>(Lanes) + i, Acc[i]);
+	}
+
+	FHash128 Hash;
+	Hash.Low = Seed ^ (static_cast<uint64_t>(Size) * Prime64A);
+	Hash.High = ~Seed ^ (static_cast<uint64_t>(Size) * Prime64B);
+	for (size_t i = 0; i < 8; i++)
+	{
+		Hash.Low = std::rotl(Hash.Low ^ ((Lanes[i] ^ SecretWords[i]) * Prime64B), 31) * Prime64A;
+		Hash.High = std::rotl(Hash.High ^ ((Lanes[7 - i] ^ SecretWords[8 + i]) * Prime64C), 27) * Prime64B;
+	}
+
+	Hash.Low = Avalanche(Hash.Low);
+	Hash.High = Avalanche(Hash.High ^ Hash.Low);
+	return Hash;
+}
+
+std::vector<uint64_t> FHash::HashPages(const void* Data, size_t Size, size_t NumThreads)
+{
+	const uint8_t* Input = static_cast<const uint8_t*>(Data);
+	const size_t NumPages = (Size + PageSize - 1) / PageSize;
+	const size_t NumBatches = (NumPages + PagesPerBatch - 1) / PagesPerBatch;
+	std::vector<uint64_t> PageHashes(NumPages);
+
+	auto HashBatch = [&](size_t Batch)
+	{
+		const size_t LastPage = std::min(NumPages, (Batch + 1) * PagesPerBatch);
+		for (size_t Page = Batch * PagesPerBatch; Page < LastPage; Page++)
+		{
+			const size_t Offset = Page * PageSize;
+			PageHashes[Page] = Hash64(Input + Offset, std::min(PageSize, Size - Offset));
+		}
+	};
+
+	if (NumThreads == 0)
+	{
+		NumThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+	NumThreads = std::min(NumThreads, NumBatches);
+
+	if (NumThreads <= 1)
+	{
+		for (size_t Batch = 0; Batch < NumBatches; Batch++)
+		{
+			HashBatch(Batch);
+		}
+		return PageHashes;
+	}
+
+	std::atomic<size_t> NextBatch = 0;
+	{
+		ThreadPool Pool(NumThreads);
+
+		for (size_t i = 0; i < NumThreads; i++)
+		{
+			Pool.enqueue([&]()
+				{
+					for (size_t Batch = NextBatch++; Batch < NumBatches; Batch = NextBatch++)
+					{
+						HashBatch(Batch);
+					}
+				});
+		}
+	}
+
+	return PageHashes;
+}
+
+FHash128 FHash::HashPageArray(const std::vector<uint64_t>& PageHashes, size_t Size)
+{
+	return Hash128(PageHashes.data(), PageHashes.size() * sizeof(uint64_t), Size);
+}
+
+FHash128 FHash::HashParallel(const void* Data, size_t Size, size_t NumThreads)
+{
+	return HashPageArray(HashPages(Data, Size, NumThreads), Size);
+}
+
+uint32_t FHash::Crc32(const void* Data, size_t Size, uint32_t Crc)
+{
+	return UpdateCrc(Crc32Table, Data, Size, Crc);
+}
+
+uint32_t FHash::Crc32C(const void* Data, size_t Size, uint32_t Crc)
+{
+	return UpdateCrc(Crc32CTable, Data, Size, Crc);
+}
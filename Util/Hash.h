@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct FHash128
+{
+	uint64_t Low = 0;
+	uint64_t High = 0;
+
+	bool operator==(const FHash128& Other) const = default;
+};
+
+/**
+ * Fast non-cryptographic hashing of memory copies, for telling whether a section or region changed.
+ * The kernel consumes 64 bytes per step in four SSE2 lanes, in the style of XXH3: every 64 bit lane
+ * accumulates the product of the low and high halves of the data mixed with a key, and the key shifts
+ * with the position of the stripe so reordered data hashes differently.
+ * Large buffers are hashed as an array of page hashes, pages are independent so they are hashed in
+ * parallel and the array tells which pages changed. The combined hash only depends on the data, never
+ * on the number of threads.
+ */
+class FHash
+{
+public:
+	static constexpr size_t PageSize = 0x1000;
+
+	static FHash128 Hash128(const void* Data, size_t Size, uint64_t Seed = 0);
+	static uint64_t Hash64(const void* Data, size_t Size, uint64_t Seed = 0) { return Hash128(Data, Size, Seed).Low; }
+
+	// hash of every PageSize bytes, the last page may be shorter, NumThreads 0 uses every core
+	static std::vector<uint64_t> HashPages(const void* Data, size_t Size, size_t NumThreads = 0);
+
+	// hash of the page hashes and the size, equal for equal data whatever the thread count
+	static FHash128 HashPageArray(const std::vector<uint64_t>& PageHashes, size_t Size);
+	static FHash128 HashParallel(const void* Data, size_t Size, size_t NumThreads = 0);
+
+	// reflected CRC-32 (zlib polynomial) and CRC-32C (Castagnoli), table driven, for comparison
+	static uint32_t Crc32(const void* Data, size_t Size, uint32_t Crc = 0);
+	static uint32_t Crc32C(const void* Data, size_t Size, uint32_t Crc = 0);
+};
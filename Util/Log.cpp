@@ -0,0 +1,41 @@
+#include "Log.h"
+#include <cstdarg>
+#include <cstdio>
+
+std::mutex FLog::Mutex;
+FLog::FSink FLog::Sink;
+
+void FLog::SetSink(FSink InSink)
+{
+	std::scoped_lock Lock(Mutex);
+	Sink = std::move(InSink);
+}
+
+void FLog::Write(const std::string& Message)
+{
+	Write(Message.c_str());
+}
+
+void FLog::Write(const char* Message)
+{
+	std::scoped_lock Lock(Mutex);
+
+	if (!Sink) return;
+	Sink(Message);
+}
+
+void FLog::WriteF(const char* Format, ...)
+{
+	std::scoped_lock Lock(Mutex);
+
+	if (!Sink) return;
+	va_list Args;
+	va_start(Args, Format);
+
+	char Buffer[BufferSize] = { 0 };
+	vsnprintf_s(Buffer, sizeof(Buffer), _TRUNCATE, Format, Args);
+
+	va_end(Args);
+
+	Sink(Buffer);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * Log output of the scanners, independent of any window. The GUI forwards it to the log window and
+ * the command line tool to stderr; without a sink messages are dropped.
+ */
+class FLog
+{
+public:
+	using FSink = std::function<void(const char* Message)>;
+
+	static void SetSink(FSink InSink);
+
+	static void Write(const std::string& Message);
+	static void Write(const char* Message);
+	static void WriteF(const char* Format, ...);
+
+private:
+	static constexpr size_t BufferSize = 8192;
+
+	static std::mutex Mutex;
+	static FSink Sink;
+};
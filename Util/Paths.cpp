@@ -0,0 +1,26 @@
+#include "Paths.h"
+#include <windows.h>
+
+std::string GetAppDataDirectory(const std::string& SubFolder)
+{
+	char LocalAppData[MAX_PATH] = { 0 };
+	const DWORD Length = GetEnvironmentVariableA("LOCALAPPDATA", LocalAppData, MAX_PATH);
+	if (Length == 0 || Length >= MAX_PATH)
+	{
+		return "";
+	}
+
+	// fails with ERROR_ALREADY_EXISTS after the first run, which is fine
+	std::string Directory = std::string(LocalAppData) + "\\ClassDumper3";
+	CreateDirectoryA(Directory.c_str(), NULL);
+	Directory += "\\" + SubFolder;
+	CreateDirectoryA(Directory.c_str(), NULL);
+
+	const DWORD Attributes = GetFileAttributesA(Directory.c_str());
+	if (Attributes == INVALID_FILE_ATTRIBUTES || !(Attributes & FILE_ATTRIBUTE_DIRECTORY))
+	{
+		return "";
+	}
+
+	return Directory;
+}
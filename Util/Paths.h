@@ -0,0 +1,5 @@
+#pragma once
+#include <string>
+
+// %LOCALAPPDATA%\ClassDumper3\<SubFolder>, created if missing, empty if it could not be created
+std::string GetAppDataDirectory(const std::string& SubFolder);
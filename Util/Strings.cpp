@@ -25,3 +25,63 @@ void StrLower(std::string& str)
 	std::transform(str.begin(), str.end(), str.begin(),
 		[](unsigned char c) { return std::tolower(c); });
 }
+
+std::string GetUnqualifiedName(const std::string& name)
+{
+	int depth = 0;
+	size_t start = 0;
+	size_t end = name.size();
+
+	for (size_t i = 0; i < name.size(); i++)
+	{
+		if (name[i] == '<')
+		{
+			if (depth++ == 0) end = i;
+		}
+		else if (name[i] == '>')
+		{
+			depth = std::max(depth - 1, 0);
+		}
+		else if (depth == 0 && name[i] == ':' && i + 1 < name.size() && name[i + 1] == ':')
+		{
+			start = i + 2;
+			end = name.size();
+			i++;
+		}
+	}
+
+	return name.substr(start, end > start ? end - start : std::string::npos);
+}
+
+std::string EscapeJson(const std::string& str)
+{
+	static const char HexDigits[] = "0123456789abcdef";
+
+	std::string escaped;
+	escaped.reserve(str.size());
+
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"': escaped += "\\\""; break;
+		case '\\': escaped += "\\\\"; break;
+		case '\n': escaped += "\\n"; break;
+		case '\r': escaped += "\\r"; break;
+		case '\t': escaped += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				escaped += "\\u00";
+				escaped += HexDigits[(c >> 4) & 0xF];
+				escaped += HexDigits[c & 0xF];
+			}
+			else
+			{
+				escaped += c;
+			}
+		}
+	}
+
+	return escaped;
+}
@@ -9,6 +9,12 @@ std::string Utf8Encode(const std::wstring& wstr);
 std::wstring Utf8Decode(const std::string& str);
 void StrLower(std::string& str);
 
+// last scope of a C++ name without template arguments, ns::Foo<a::b> -> Foo
+std::string GetUnqualifiedName(const std::string& name);
+
+// contents of a JSON string literal, quotes, backslashes and control characters escaped
+std::string EscapeJson(const std::string& str);
+
 template< typename T >
 std::string IntegerToHexStr(T i);
 
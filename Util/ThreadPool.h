@@ -1,5 +1,10 @@
 #pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <queue>
+#include <thread>
+#include <vector>
 class ThreadPool
 {
 public:
@@ -0,0 +1,586 @@
+#include "ClassDatabase.h"
+#include "RTTI.h"
+#include "../Util/BufferedWriter.h"
+#include "../Util/Hash.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+	constexpr uint64_t TableAlignment = 8;
+
+	uint64_t AlignUp(uint64_t Value)
+	{
+		return (Value + TableAlignment - 1) & ~(TableAlignment - 1);
+	}
+
+	bool IsInRange(const FDatabaseRange& Range, size_t TableSize)
+	{
+		return Range.First <= TableSize && Range.Count <= TableSize - Range.First;
+	}
+
+	bool ContainsIgnoreCase(std::string_view Text, const std::string& LowerPattern)
+	{
+		auto it = std::search(Text.begin(), Text.end(), LowerPattern.begin(), LowerPattern.end(),
+			[](char A, char B) { return std::tolower(static_cast<unsigned char>(A)) == B; });
+		return it != Text.end() || LowerPattern.empty();
+	}
+
+	// sorts the lookup tables of a finished set of classes
+	void BuildIndexTables(const std::vector<FDatabaseClass>& Classes, const std::string& Strings,
+		std::vector<uint32_t>& NameIndex, std::vector<uint32_t>& VTableIndex, std::vector<FDatabaseChild>& ChildIndex)
+	{
+		NameIndex.resize(Classes.size());
+		for (uint32_t ClassID = 0; ClassID < NameIndex.size(); ClassID++)
+		{
+			NameIndex[ClassID] = ClassID;
+		}
+		VTableIndex = NameIndex;
+
+		auto GetName = [&](uint32_t ClassID) { return std::string_view(Strings).substr(Classes[ClassID].Name.Offset, Classes[ClassID].Name.Length); };
+		std::sort(NameIndex.begin(), NameIndex.end(), [&](uint32_t A, uint32_t B) { return GetName(A) != GetName(B) ? GetName(A) < GetName(B) : A < B; });
+		std::sort(VTableIndex.begin(), VTableIndex.end(), [&](uint32_t A, uint32_t B) { return Classes[A].VTable < Classes[B].VTable; });
+		std::sort(ChildIndex.begin(), ChildIndex.end(), [](const FDatabaseChild& A, const FDatabaseChild& B)
+			{
+				return A.BaseTypeDescriptor != B.BaseTypeDescriptor ? A.BaseTypeDescriptor < B.BaseTypeDescriptor : A.Class < B.Class;
+			});
+	}
+
+	struct FTableData
+	{
+		const void* Data;
+		size_t ElementSize;
+		size_t Count;
+	};
+
+	// the table of contents is known before anything is written, tables follow the header in enum order
+	bool WriteDatabaseFile(const std::string& Path, FDatabaseHeader& Header, std::span<const FTableData> Tables)
+	{
+		uint64_t Offset = AlignUp(sizeof(FDatabaseHeader));
+		for (size_t i = 0; i < Tables.size(); i++)
+		{
+			Header.Tables[i] = { Offset, Tables[i].Count };
+			Offset = AlignUp(Offset + Tables[i].ElementSize * Tables[i].Count);
+		}
+		Header.FileSize = Offset;
+
+		FBufferedWriter Out;
+		if (!Out.Open(Path))
+		{
+			return false;
+		}
+
+		static const char Padding[TableAlignment] = {};
+		Out.Write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+		for (size_t i = 0; i < Tables.size(); i++)
+		{
+			Out.Write(Padding, Header.Tables[i].Offset - Out.GetBytesWritten());
+			Out.Write(static_cast<const char*>(Tables[i].Data), Tables[i].ElementSize * Tables[i].Count);
+		}
+		Out.Write(Padding, Header.FileSize - Out.GetBytesWritten());
+
+		return Out.Close();
+	}
+}
+
+// ---------------------------------------------
+// Writer
+// ---------------------------------------------
+
+FClassDatabaseWriter::FClassDatabaseWriter(RTTI& InSource)
+	: Source(InSource)
+{
+}
+
+FDatabaseString FClassDatabaseWriter::AddString(const std::string& Text)
+{
+	auto [it, bInserted] = StringLookup.try_emplace(Text);
+	if (bInserted)
+	{
+		it->second.Offset = static_cast<uint32_t>(Strings.size());
+		it->second.Length = static_cast<uint32_t>(Text.size());
+		Strings += Text;
+	}
+
+	return it->second;
+}
+
+bool FClassDatabaseWriter::Write(const std::string& Path)
+{
+	const std::vector<std::shared_ptr<ClassMetaData>> SourceClasses = Source.GetClasses();
+	FFunctionTable& SourceFunctions = Source.GetFunctionTable();
+	const uintptr_t ModuleBase = Source.GetLoadAddress();
+
+	FDatabaseHeader Header;
+	std::copy(std::begin(FDatabaseHeader::MagicValue), std::end(FDatabaseHeader::MagicValue), Header.Magic);
+	Header.ModuleBase = ModuleBase;
+	Header.ModuleName = AddString(Source.GetModuleName());
+	Header.Fingerprint = Source.GetModuleFingerprint();
+
+	std::vector<FDatabaseClass> Classes(SourceClasses.size());
+	std::vector<FDatabaseParent> Parents;
+	std::vector<FDatabaseSlot> Slots;
+	std::vector<uint32_t> FunctionRefs;
+	std::vector<int64_t> References;
+	std::vector<FDatabaseInstance> Instances;
+	std::vector<FDatabaseChild> ChildIndex;
+
+	for (const std::shared_ptr<ClassMetaData>& CMeta : SourceClasses)
+	{
+		FDatabaseClass& Class = Classes[CMeta->ClassID];
+		Class.Name = AddString(CMeta->Name);
+		Class.MangledName = AddString(CMeta->MangledName);
+		Class.VTable = static_cast<uint32_t>(CMeta->VTable - ModuleBase);
+		Class.CompleteObjectLocator = static_cast<uint32_t>(CMeta->CompleteObjectLocator - ModuleBase);
+		Class.TypeDescriptor = static_cast<uint32_t>(CMeta->TypeDescriptor - ModuleBase);
+		Class.VTableOffset = CMeta->VTableOffset;
+		Class.ConstructorDisplacementOffset = CMeta->ConstructorDisplacementOffset;
+		Class.ObjectSize = CMeta->ObjectSize;
+		Class.ObjectSizeSource = static_cast<uint8_t>(CMeta->ObjectSizeSource);
+
+		if (std::shared_ptr<ClassMetaData> Complete = Source.GetCompleteClass(CMeta))
+		{
+			Class.CompleteClass = Complete->ClassID;
+		}
+
+		Class.Flags = (CMeta->bMultipleInheritance ? DatabaseClassMultipleInheritance : 0)
+			| (CMeta->bVirtualInheritance ? DatabaseClassVirtualInheritance : 0)
+			| (CMeta->bAmbigious ? DatabaseClassAmbiguous : 0)
+			| (CMeta->bStruct ? DatabaseClassStruct : 0)
+			| (CMeta->bInterface ? DatabaseClassInterface : 0);
+
+		Class.Parents = { static_cast<uint32_t>(Parents.size()), static_cast<uint32_t>(CMeta->Parents.size()) };
+		for (const std::shared_ptr<ParentClass>& Parent : CMeta->Parents)
+		{
+			FDatabaseParent& Record = Parents.emplace_back();
+			Record.Name = AddString(Parent->Name);
+			Record.MangledName = AddString(Parent->MangledName);
+			Record.TypeDescriptor = static_cast<uint32_t>(Parent->TypeDescriptor - ModuleBase);
+			Record.NumContainedBases = Parent->numContainedBases;
+			Record.MemberDisplacement = Parent->where.mdisp;
+			Record.VBTableDisplacement = Parent->where.pdisp;
+			Record.VBTableOffset = Parent->where.vdisp;
+			Record.Attributes = Parent->attributes;
+			Record.TreeDepth = Parent->TreeDepth;
+
+			if (std::shared_ptr<ClassMetaData> ParentMeta = Parent->Class.lock())
+			{
+				Record.Class = ParentMeta->ClassID;
+			}
+
+			ChildIndex.push_back({ Record.TypeDescriptor, CMeta->ClassID });
+		}
+
+		const FVTableView VTable = SourceFunctions.GetVTable(CMeta->ClassID);
+		Class.Slots = { static_cast<uint32_t>(Slots.size()), static_cast<uint32_t>(VTable.size()) };
+		for (uint32_t Slot = 0; Slot < VTable.size(); Slot++)
+		{
+			FDatabaseSlot& Record = Slots.emplace_back();
+			Record.Function = VTable[Slot];
+			Record.Status = static_cast<uint8_t>(SourceFunctions.GetSlotStatus(CMeta->ClassID, Slot));
+		}
+
+		Class.Constructors = { static_cast<uint32_t>(FunctionRefs.size()), static_cast<uint32_t>(CMeta->Constructors.size()) };
+		FunctionRefs.insert(FunctionRefs.end(), CMeta->Constructors.begin(), CMeta->Constructors.end());
+		Class.Destructors = { static_cast<uint32_t>(FunctionRefs.size()), static_cast<uint32_t>(CMeta->Destructors.size()) };
+		FunctionRefs.insert(FunctionRefs.end(), CMeta->Destructors.begin(), CMeta->Destructors.end());
+
+		Class.References = { static_cast<uint32_t>(References.size()), static_cast<uint32_t>(CMeta->CodeReferences.size()) };
+		for (uintptr_t Reference : CMeta->CodeReferences)
+		{
+			References.push_back(static_cast<int64_t>(Reference - ModuleBase));
+		}
+
+		Class.Instances = { static_cast<uint32_t>(Instances.size()), static_cast<uint32_t>(CMeta->ClassInstances.size()) };
+		for (const FClassInstance& Instance : CMeta->ClassInstances)
+		{
+			FDatabaseInstance& Record = Instances.emplace_back();
+			Record.Address = Instance.Address;
+			Record.Confidence = Instance.Confidence;
+			Record.Region = static_cast<uint8_t>(Instance.Region);
+		}
+	}
+
+	std::vector<FDatabaseFunction> Functions(SourceFunctions.GetNumFunctions());
+	for (uint32_t FunctionIndex = 0; FunctionIndex < Functions.size(); FunctionIndex++)
+	{
+		FDatabaseFunction& Function = Functions[FunctionIndex];
+		Function.Offset = static_cast<int64_t>(SourceFunctions.GetAddress(FunctionIndex) - ModuleBase);
+		Function.Hash = SourceFunctions.GetHash(FunctionIndex);
+		Function.Size = SourceFunctions.GetSize(FunctionIndex);
+		Function.OwnerClass = SourceFunctions.GetOwner(FunctionIndex).ClassID;
+		Function.OwnerSlot = SourceFunctions.GetOwner(FunctionIndex).Slot;
+
+		if (SourceFunctions.HasName(FunctionIndex))
+		{
+			Function.Name = AddString(SourceFunctions.GetName(FunctionIndex));
+			Function.Flags = SourceFunctions.HasUserName(FunctionIndex) ? 0 : DatabaseFunctionInferredName;
+		}
+	}
+
+	std::vector<uint32_t> NameIndex;
+	std::vector<uint32_t> VTableIndex;
+	BuildIndexTables(Classes, Strings, NameIndex, VTableIndex, ChildIndex);
+
+	const FTableData Tables[] = {
+		{ Classes.data(), sizeof(FDatabaseClass), Classes.size() },
+		{ Parents.data(), sizeof(FDatabaseParent), Parents.size() },
+		{ Slots.data(), sizeof(FDatabaseSlot), Slots.size() },
+		{ Functions.data(), sizeof(FDatabaseFunction), Functions.size() },
+		{ FunctionRefs.data(), sizeof(uint32_t), FunctionRefs.size() },
+		{ References.data(), sizeof(int64_t), References.size() },
+		{ Instances.data(), sizeof(FDatabaseInstance), Instances.size() },
+		{ NameIndex.data(), sizeof(uint32_t), NameIndex.size() },
+		{ VTableIndex.data(), sizeof(uint32_t), VTableIndex.size() },
+		{ ChildIndex.data(), sizeof(FDatabaseChild), ChildIndex.size() },
+		{ Strings.data(), sizeof(char), Strings.size() }
+	};
+	static_assert(std::size(Tables) == static_cast<size_t>(EDatabaseTable::Num));
+
+	return WriteDatabaseFile(Path, Header, Tables);
+}
+
+// ---------------------------------------------
+// Synthetic Writer
+// ---------------------------------------------
+
+FSyntheticDatabaseWriter::FSyntheticDatabaseWriter(size_t InNumClasses, uint32_t InBuild)
+	: NumClasses(InNumClasses), Build(InBuild)
+{
+}
+
+FDatabaseString FSyntheticDatabaseWriter::AddString(const std::string& Text)
+{
+	// every synthetic name is unique, there is nothing to share
+	const FDatabaseString String = { static_cast<uint32_t>(Strings.size()), static_cast<uint32_t>(Text.size()) };
+	Strings += Text;
+	return String;
+}
+
+bool FSyntheticDatabaseWriter::Write(const std::string& Path)
+{
+	// every decision about a class depends only on its number, so both builds agree on what stayed the same
+	auto Random = [](uint64_t Value, uint64_t Salt) { return FHash::Hash64(&Value, sizeof(Value), Salt); };
+
+	FDatabaseHeader Header;
+	std::copy(std::begin(FDatabaseHeader::MagicValue), std::end(FDatabaseHeader::MagicValue), Header.Magic);
+	Header.ModuleBase = 0x10000000;
+	Header.ModuleName = AddString("synthetic.dll");
+	Header.Fingerprint.TimeDateStamp = Build;
+
+	std::vector<FDatabaseClass> Classes;
+	std::vector<FDatabaseParent> Parents;
+	std::vector<FDatabaseSlot> Slots;
+	std::vector<FDatabaseFunction> Functions;
+	std::vector<FDatabaseChild> ChildIndex;
+	Classes.reserve(NumClasses + NumClasses / 50);
+
+	auto AddFunction = [&](uint32_t ClassID, uint32_t Slot, uint64_t Hash, const std::string& Name)
+	{
+		FDatabaseFunction& Function = Functions.emplace_back();
+		Function.Offset = static_cast<int64_t>(0x2000000 + Functions.size() * 0x40);
+		Function.Hash = Hash | 1;
+		Function.Size = static_cast<uint32_t>(16 + Hash % 0x200);
+		Function.OwnerClass = ClassID;
+		Function.OwnerSlot = Slot;
+		if (!Name.empty())
+		{
+			Function.Name = AddString(Name);
+		}
+
+		Slots.push_back({ static_cast<uint32_t>(Functions.size() - 1), static_cast<uint8_t>(ESlotStatus::Introduced) });
+	};
+
+	// build 1 drops 2% of the classes, renames 2%, changes a function in 5%, inserts a slot in 3% and adds 2% new classes
+	const size_t NumAdded = Build == 0 ? 0 : NumClasses / 50;
+	for (size_t Number = 0; Number < NumClasses + NumAdded; Number++)
+	{
+		const uint64_t Change = (Build == 0 || Number >= NumClasses) ? 100 : Random(Number, 1) % 100;
+		if (Change < 2)
+		{
+			continue;
+		}
+
+		const uint32_t ClassID = static_cast<uint32_t>(Classes.size());
+		const std::string Name = (Change < 4 ? "RenamedClass" : "SyntheticClass") + std::to_string(Number);
+		const uint32_t NumSlots = static_cast<uint32_t>(4 + Random(Number, 2) % 28);
+		const uint32_t ChangedSlot = static_cast<uint32_t>(Random(Number, 3) % NumSlots);
+
+		FDatabaseClass& Class = Classes.emplace_back();
+		Class.Name = AddString(Name);
+		Class.MangledName = AddString(".?AV" + Name + "@@");
+		Class.VTable = static_cast<uint32_t>(0x100000 + Number * 0x100);
+		Class.CompleteObjectLocator = static_cast<uint32_t>(0x4000000 + Number * 0x20);
+		Class.TypeDescriptor = static_cast<uint32_t>(0x6000000 + Number * 0x40);
+		Class.CompleteClass = ClassID;
+		Class.ObjectSize = static_cast<uint32_t>(8 * (1 + Random(Number, 4) % 64));
+
+		// the class itself, and for three in four classes the one before it as base
+		const bool bHasBase = Number % 4 != 0;
+		Class.Parents = { static_cast<uint32_t>(Parents.size()), bHasBase ? 2u : 1u };
+
+		FDatabaseParent& Self = Parents.emplace_back();
+		Self.Name = Class.Name;
+		Self.MangledName = Class.MangledName;
+		Self.TypeDescriptor = Class.TypeDescriptor;
+		Self.Class = ClassID;
+		Self.NumContainedBases = bHasBase ? 1 : 0;
+		ChildIndex.push_back({ Self.TypeDescriptor, ClassID });
+
+		if (bHasBase)
+		{
+			const std::string BaseName = "SyntheticBase" + std::to_string(Number - 1);
+			FDatabaseParent& Base = Parents.emplace_back();
+			Base.Name = AddString(BaseName);
+			Base.MangledName = AddString(".?AV" + BaseName + "@@");
+			Base.TypeDescriptor = static_cast<uint32_t>(0x6000000 + (Number - 1) * 0x40);
+			Base.TreeDepth = 1;
+			ChildIndex.push_back({ Base.TypeDescriptor, ClassID });
+		}
+
+		Class.Slots = { static_cast<uint32_t>(Slots.size()), NumSlots + (Change >= 9 && Change < 12 ? 1 : 0) };
+		for (uint32_t Slot = 0; Slot < NumSlots; Slot++)
+		{
+			const uint64_t Key = Number * 64 + Slot;
+
+			if (Change >= 9 && Change < 12 && Slot == ChangedSlot)
+			{
+				AddFunction(ClassID, Slot, Random(Key, 6), "");
+			}
+
+			// the old build has every eighth function named, the diff carries those names to the new one
+			const bool bModified = Change >= 4 && Change < 9 && Slot == ChangedSlot;
+			const bool bNamed = Build == 0 && Key % 8 == 0;
+			AddFunction(ClassID, Slot, Random(Key, bModified ? 7 : 5), bNamed ? Name + "::Function" + std::to_string(Slot) : "");
+		}
+	}
+
+	std::vector<uint32_t> NameIndex;
+	std::vector<uint32_t> VTableIndex;
+	BuildIndexTables(Classes, Strings, NameIndex, VTableIndex, ChildIndex);
+
+	const FTableData Tables[] = {
+		{ Classes.data(), sizeof(FDatabaseClass), Classes.size() },
+		{ Parents.data(), sizeof(FDatabaseParent), Parents.size() },
+		{ Slots.data(), sizeof(FDatabaseSlot), Slots.size() },
+		{ Functions.data(), sizeof(FDatabaseFunction), Functions.size() },
+		{ nullptr, sizeof(uint32_t), 0 },
+		{ nullptr, sizeof(int64_t), 0 },
+		{ nullptr, sizeof(FDatabaseInstance), 0 },
+		{ NameIndex.data(), sizeof(uint32_t), NameIndex.size() },
+		{ VTableIndex.data(), sizeof(uint32_t), VTableIndex.size() },
+		{ ChildIndex.data(), sizeof(FDatabaseChild), ChildIndex.size() },
+		{ Strings.data(), sizeof(char), Strings.size() }
+	};
+	static_assert(std::size(Tables) == static_cast<size_t>(EDatabaseTable::Num));
+
+	return WriteDatabaseFile(Path, Header, Tables);
+}
+
+// ---------------------------------------------
+// Reader
+// ---------------------------------------------
+
+FClassDatabase::~FClassDatabase()
+{
+	Close();
+}
+
+bool FClassDatabase::Open(const std::string& Path)
+{
+	Close();
+
+	File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER FileSize{};
+	Mapping = GetFileSizeEx(File, &FileSize) && FileSize.QuadPart >= static_cast<long long>(sizeof(FDatabaseHeader))
+		? CreateFileMapping(File, NULL, PAGE_READONLY, 0, 0, NULL)
+		: NULL;
+	View = Mapping ? static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+	if (!View)
+	{
+		Close();
+		return false;
+	}
+
+	ViewSize = static_cast<uint64_t>(FileSize.QuadPart);
+	Header = reinterpret_cast<const FDatabaseHeader*>(View);
+	ModuleBase = static_cast<uintptr_t>(Header->ModuleBase);
+
+	const bool bValidHeader = std::equal(std::begin(FDatabaseHeader::MagicValue), std::end(FDatabaseHeader::MagicValue), Header->Magic)
+		&& Header->Version == FDatabaseHeader::CurrentVersion
+		&& Header->PointerSize == sizeof(uintptr_t)
+		&& Header->FileSize == ViewSize;
+
+	if (!bValidHeader
+		|| !GetTable(EDatabaseTable::Classes, Classes)
+		|| !GetTable(EDatabaseTable::Parents, Parents)
+		|| !GetTable(EDatabaseTable::Slots, Slots)
+		|| !GetTable(EDatabaseTable::Functions, Functions)
+		|| !GetTable(EDatabaseTable::FunctionRefs, FunctionRefs)
+		|| !GetTable(EDatabaseTable::References, References)
+		|| !GetTable(EDatabaseTable::Instances, Instances)
+		|| !GetTable(EDatabaseTable::NameIndex, NameIndex)
+		|| !GetTable(EDatabaseTable::VTableIndex, VTableIndex)
+		|| !GetTable(EDatabaseTable::ChildIndex, ChildIndex)
+		|| !GetTable(EDatabaseTable::Strings, Strings))
+	{
+		Close();
+		return false;
+	}
+
+	// ranges are checked once here so the accessors can index without checks
+	auto IsValidString = [this](const FDatabaseString& String) { return String.Offset <= Strings.size() && String.Length <= Strings.size() - String.Offset; };
+
+	const bool bValidRecords = IsValidString(Header->ModuleName)
+		&& NameIndex.size() == Classes.size()
+		&& VTableIndex.size() == Classes.size()
+		&& std::all_of(Classes.begin(), Classes.end(), [&](const FDatabaseClass& Class)
+			{
+				return IsValidString(Class.Name) && IsValidString(Class.MangledName)
+					&& IsInRange(Class.Parents, Parents.size())
+					&& IsInRange(Class.Slots, Slots.size())
+					&& IsInRange(Class.Constructors, FunctionRefs.size())
+					&& IsInRange(Class.Destructors, FunctionRefs.size())
+					&& IsInRange(Class.References, References.size())
+					&& IsInRange(Class.Instances, Instances.size());
+			})
+		&& std::all_of(Parents.begin(), Parents.end(), [&](const FDatabaseParent& Parent) { return IsValidString(Parent.Name) && IsValidString(Parent.MangledName); })
+		&& std::all_of(Functions.begin(), Functions.end(), [&](const FDatabaseFunction& Function) { return IsValidString(Function.Name); })
+		&& std::all_of(Slots.begin(), Slots.end(), [&](const FDatabaseSlot& Slot) { return Slot.Function < Functions.size(); })
+		&& std::all_of(FunctionRefs.begin(), FunctionRefs.end(), [&](uint32_t Function) { return Function < Functions.size(); })
+		&& std::all_of(NameIndex.begin(), NameIndex.end(), [&](uint32_t ClassID) { return ClassID < Classes.size(); })
+		&& std::all_of(VTableIndex.begin(), VTableIndex.end(), [&](uint32_t ClassID) { return ClassID < Classes.size(); })
+		&& std::all_of(ChildIndex.begin(), ChildIndex.end(), [&](const FDatabaseChild& Child) { return Child.Class < Classes.size(); });
+
+	if (!bValidRecords)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FClassDatabase::Close()
+{
+	if (View)
+	{
+		UnmapViewOfFile(View);
+	}
+
+	if (Mapping)
+	{
+		CloseHandle(Mapping);
+	}
+
+	if (File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(File);
+	}
+
+	File = INVALID_HANDLE_VALUE;
+	Mapping = NULL;
+	View = nullptr;
+	ViewSize = 0;
+	Header = nullptr;
+
+	Classes = {};
+	Parents = {};
+	Slots = {};
+	Functions = {};
+	FunctionRefs = {};
+	References = {};
+	Instances = {};
+	NameIndex = {};
+	VTableIndex = {};
+	ChildIndex = {};
+	Strings = {};
+}
+
+template<typename T>
+bool FClassDatabase::GetTable(EDatabaseTable Table, std::span<const T>& OutTable) const
+{
+	const FDatabaseTable& Entry = Header->Tables[static_cast<size_t>(Table)];
+
+	if (Entry.Offset % alignof(T) != 0 || Entry.Offset > ViewSize || Entry.Count > (ViewSize - Entry.Offset) / sizeof(T))
+	{
+		return false;
+	}
+
+	OutTable = std::span<const T>(reinterpret_cast<const T*>(View + Entry.Offset), static_cast<size_t>(Entry.Count));
+	return true;
+}
+
+std::string_view FClassDatabase::GetString(const FDatabaseString& String) const
+{
+	return std::string_view(Strings.data() + String.Offset, String.Length);
+}
+
+const FDatabaseClass* FClassDatabase::Find(uintptr_t VTable) const
+{
+	if (VTable < ModuleBase || VTable - ModuleBase > UINT32_MAX)
+	{
+		return nullptr;
+	}
+
+	const uint32_t RVA = static_cast<uint32_t>(VTable - ModuleBase);
+	auto it = std::lower_bound(VTableIndex.begin(), VTableIndex.end(), RVA, [this](uint32_t ClassID, uint32_t Value) { return Classes[ClassID].VTable < Value; });
+
+	return it != VTableIndex.end() && Classes[*it].VTable == RVA ? &Classes[*it] : nullptr;
+}
+
+const FDatabaseClass* FClassDatabase::FindFirst(std::string_view ClassName) const
+{
+	auto it = std::lower_bound(NameIndex.begin(), NameIndex.end(), ClassName, [this](uint32_t ClassID, std::string_view Value) { return GetString(Classes[ClassID].Name) < Value; });
+
+	return it != NameIndex.end() && GetString(Classes[*it].Name) == ClassName ? &Classes[*it] : nullptr;
+}
+
+std::vector<const FDatabaseClass*> FClassDatabase::FindAll(const std::string& ClassName) const
+{
+	std::vector<const FDatabaseClass*> FoundClasses;
+	std::string LowerClassName = ClassName;
+	std::transform(LowerClassName.begin(), LowerClassName.end(), LowerClassName.begin(), ::tolower);
+
+	// one class per name like RTTI::FindAll, the index keeps equal names together
+	std::string_view LastName;
+	for (size_t i = 0; i < NameIndex.size(); i++)
+	{
+		const FDatabaseClass& Class = Classes[NameIndex[i]];
+		const std::string_view Name = GetString(Class.Name);
+		if (i > 0 && Name == LastName)
+		{
+			continue;
+		}
+
+		LastName = Name;
+		if (ContainsIgnoreCase(Name, LowerClassName))
+		{
+			FoundClasses.push_back(&Class);
+		}
+	}
+
+	return FoundClasses;
+}
+
+std::vector<const FDatabaseClass*> FClassDatabase::FindChildClasses(const FDatabaseClass& Class) const
+{
+	std::vector<const FDatabaseClass*> FoundClasses;
+
+	auto it = std::lower_bound(ChildIndex.begin(), ChildIndex.end(), Class.TypeDescriptor, [](const FDatabaseChild& Child, uint32_t Value) { return Child.BaseTypeDescriptor < Value; });
+	for (; it != ChildIndex.end() && it->BaseTypeDescriptor == Class.TypeDescriptor; ++it)
+	{
+		// a class can list the same base more than once through different paths
+		if (FoundClasses.empty() || FoundClasses.back() != &Classes[it->Class])
+		{
+			FoundClasses.push_back(&Classes[it->Class]);
+		}
+	}
+
+	return FoundClasses;
+}
@@ -0,0 +1,287 @@
+#pragma once
+#include <Windows.h>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class RTTI;
+
+// ---------------------------------------------
+// Class Database File Format
+// ---------------------------------------------
+
+/**
+ * Binary snapshot of an RTTI scan, laid out to be used straight from a read only file mapping.
+ * The header is followed by fixed size tables, each 8 byte aligned and located through the header's
+ * table of contents. Records refer to each other by table index and to text by offset into the string
+ * pool, never by pointer. Module addresses are stored relative to the module base so the file stays
+ * valid when the module loads somewhere else; only instance addresses are absolute.
+ */
+
+struct FDatabaseString
+{
+	uint32_t Offset = 0; // into the string pool
+	uint32_t Length = 0;
+};
+
+// run of records in another table
+struct FDatabaseRange
+{
+	uint32_t First = 0;
+	uint32_t Count = 0;
+};
+
+enum class EDatabaseTable : uint32_t
+{
+	Classes, // FDatabaseClass, indexed by ClassID
+	Parents, // FDatabaseParent
+	Slots, // FDatabaseSlot
+	Functions, // FDatabaseFunction, indexed by function table index
+	FunctionRefs, // uint32_t function indices of constructors and destructors
+	References, // int64_t offsets of code references from the module base, they can point into other modules
+	Instances, // FDatabaseInstance
+	NameIndex, // uint32_t class indices sorted by name
+	VTableIndex, // uint32_t class indices sorted by vtable RVA
+	ChildIndex, // FDatabaseChild sorted by base type descriptor
+	Strings, // char
+	Num
+};
+
+struct FDatabaseTable
+{
+	uint64_t Offset = 0; // from the start of the file
+	uint64_t Count = 0; // records, not bytes
+};
+
+// identifies one build of a module, independent of where it is loaded
+struct FModuleFingerprint
+{
+	uint32_t TimeDateStamp = 0;
+	uint32_t SizeOfImage = 0;
+	uint32_t CheckSum = 0;
+	uint32_t Reserved = 0;
+	uint64_t RDataHash = 0; // relocated pointers hashed as RVAs and the import address table skipped
+
+	bool operator==(const FModuleFingerprint& Other) const = default;
+};
+
+struct FDatabaseHeader
+{
+	static constexpr char MagicValue[8] = { 'C', 'D', '3', 'C', 'L', 'S', 'D', 'B' };
+	static constexpr uint32_t CurrentVersion = 6;
+
+	char Magic[8] = {};
+	uint32_t Version = CurrentVersion;
+	uint32_t PointerSize = sizeof(uintptr_t);
+	uint64_t ModuleBase = 0; // where the module was loaded when the database was written
+	uint64_t FileSize = 0;
+	FDatabaseString ModuleName;
+	FModuleFingerprint Fingerprint;
+	FDatabaseTable Tables[static_cast<size_t>(EDatabaseTable::Num)];
+};
+
+enum EDatabaseClassFlags : uint8_t
+{
+	DatabaseClassMultipleInheritance = 1 << 0,
+	DatabaseClassVirtualInheritance = 1 << 1,
+	DatabaseClassAmbiguous = 1 << 2,
+	DatabaseClassStruct = 1 << 3,
+	DatabaseClassInterface = 1 << 4
+};
+
+enum EDatabaseFunctionFlags : uint32_t
+{
+	DatabaseFunctionInferredName = 1 << 0 // Name came from the scan, not from the user
+};
+
+struct FDatabaseClass
+{
+	FDatabaseString Name;
+	FDatabaseString MangledName;
+	uint32_t VTable = 0; // RVA
+	uint32_t CompleteObjectLocator = 0; // RVA
+	uint32_t TypeDescriptor = 0; // RVA
+	uint32_t VTableOffset = 0;
+	uint32_t ConstructorDisplacementOffset = 0;
+	uint32_t CompleteClass = 0xFFFFFFFF; // class holding the primary vtable, itself for primary vtables
+	uint32_t ObjectSize = 0;
+	uint8_t ObjectSizeSource = 0; // EObjectSizeSource
+	uint8_t Flags = 0; // EDatabaseClassFlags
+	uint16_t Reserved = 0;
+	FDatabaseRange Parents;
+	FDatabaseRange Slots;
+	FDatabaseRange Constructors; // into FunctionRefs
+	FDatabaseRange Destructors; // into FunctionRefs
+	FDatabaseRange References;
+	FDatabaseRange Instances;
+};
+
+struct FDatabaseParent
+{
+	FDatabaseString Name;
+	FDatabaseString MangledName;
+	uint32_t TypeDescriptor = 0; // RVA
+	uint32_t Class = 0xFFFFFFFF; // class of the same name, if it has a vtable
+	uint32_t NumContainedBases = 0;
+	int32_t MemberDisplacement = 0;
+	int32_t VBTableDisplacement = 0;
+	int32_t VBTableOffset = 0;
+	uint32_t Attributes = 0;
+	uint32_t TreeDepth = 0;
+};
+
+struct FDatabaseSlot
+{
+	uint32_t Function = 0;
+	uint8_t Status = 0; // ESlotStatus
+	uint8_t Reserved[3] = {};
+};
+
+struct FDatabaseFunction
+{
+	int64_t Offset = 0; // from the module base, functions can live in other modules
+	uint64_t Hash = 0; // normalized instruction hash, see FFunctionHasher, 0 if unknown
+	uint32_t Size = 0;
+	uint32_t OwnerClass = 0xFFFFFFFF;
+	uint32_t OwnerSlot = 0;
+	uint32_t Flags = 0; // EDatabaseFunctionFlags
+	FDatabaseString Name; // empty if the function was never named
+};
+
+struct FDatabaseInstance
+{
+	uint64_t Address = 0;
+	uint8_t Confidence = 0;
+	uint8_t Region = 0; // EInstanceRegion
+	uint8_t Reserved[6] = {};
+};
+
+struct FDatabaseChild
+{
+	uint32_t BaseTypeDescriptor = 0; // RVA
+	uint32_t Class = 0;
+};
+
+static_assert(sizeof(FDatabaseHeader) == 240, "class database header layout changed, bump the version");
+static_assert(sizeof(FDatabaseClass) == 96, "class database record layout changed, bump the version");
+static_assert(sizeof(FDatabaseParent) == 48, "class database record layout changed, bump the version");
+static_assert(sizeof(FDatabaseFunction) == 40, "class database record layout changed, bump the version");
+static_assert(sizeof(FDatabaseInstance) == 16, "class database record layout changed, bump the version");
+
+// ---------------------------------------------
+// Class Database
+// ---------------------------------------------
+
+/** Writes the classes, functions and scan results of an RTTI instance as a class database */
+class FClassDatabaseWriter
+{
+public:
+	explicit FClassDatabaseWriter(RTTI& InSource);
+
+	bool Write(const std::string& Path);
+
+protected:
+	FDatabaseString AddString(const std::string& Text);
+
+	RTTI& Source;
+	std::string Strings;
+	std::unordered_map<std::string, FDatabaseString> StringLookup; // names repeat in every parent list
+};
+
+/**
+ * Writes a class database of made up classes to benchmark FClassDiff without two builds of a real
+ * module. Build 0 is the old build; build 1 has the same classes with a few percent dropped, renamed,
+ * changed or added, and none of the function names build 0 has.
+ */
+class FSyntheticDatabaseWriter
+{
+public:
+	FSyntheticDatabaseWriter(size_t InNumClasses, uint32_t InBuild);
+
+	bool Write(const std::string& Path);
+
+protected:
+	FDatabaseString AddString(const std::string& Text);
+
+	size_t NumClasses = 0;
+	uint32_t Build = 0;
+	std::string Strings;
+};
+
+/**
+ * Read only view of a class database file. Opening maps the file and checks the header and table
+ * bounds, nothing is parsed or copied; every accessor returns a reference or span into the mapping,
+ * valid until Close. Lookups by name, vtable and base use the sorted index tables.
+ */
+class FClassDatabase
+{
+public:
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	FClassDatabase() = default;
+	~FClassDatabase();
+
+	FClassDatabase(const FClassDatabase&) = delete;
+	FClassDatabase& operator=(const FClassDatabase&) = delete;
+
+	bool Open(const std::string& Path);
+	void Close();
+	bool IsOpen() const { return View != nullptr; }
+
+	const FDatabaseHeader& GetHeader() const { return *Header; }
+	std::string_view GetString(const FDatabaseString& String) const;
+	std::string_view GetModuleName() const { return GetString(Header->ModuleName); }
+
+	// absolute addresses are computed against this base, the one the database was written with by default
+	uintptr_t GetModuleBase() const { return ModuleBase; }
+	void SetModuleBase(uintptr_t InModuleBase) { ModuleBase = InModuleBase; }
+
+	std::span<const FDatabaseClass> GetClasses() const { return Classes; }
+	const FDatabaseClass& GetClass(uint32_t ClassID) const { return Classes[ClassID]; }
+	uint32_t GetClassID(const FDatabaseClass& Class) const { return static_cast<uint32_t>(&Class - Classes.data()); }
+	uintptr_t GetVTable(const FDatabaseClass& Class) const { return ModuleBase + Class.VTable; }
+
+	std::span<const FDatabaseParent> GetParents(const FDatabaseClass& Class) const { return Parents.subspan(Class.Parents.First, Class.Parents.Count); }
+	std::span<const FDatabaseSlot> GetSlots(const FDatabaseClass& Class) const { return Slots.subspan(Class.Slots.First, Class.Slots.Count); }
+	std::span<const uint32_t> GetConstructors(const FDatabaseClass& Class) const { return FunctionRefs.subspan(Class.Constructors.First, Class.Constructors.Count); }
+	std::span<const uint32_t> GetDestructors(const FDatabaseClass& Class) const { return FunctionRefs.subspan(Class.Destructors.First, Class.Destructors.Count); }
+	std::span<const int64_t> GetReferences(const FDatabaseClass& Class) const { return References.subspan(Class.References.First, Class.References.Count); }
+	std::span<const FDatabaseInstance> GetInstances(const FDatabaseClass& Class) const { return Instances.subspan(Class.Instances.First, Class.Instances.Count); }
+
+	std::span<const FDatabaseFunction> GetFunctions() const { return Functions; }
+	const FDatabaseFunction& GetFunction(uint32_t FunctionIndex) const { return Functions[FunctionIndex]; }
+	uintptr_t GetFunctionAddress(uint32_t FunctionIndex) const { return ModuleBase + static_cast<uintptr_t>(Functions[FunctionIndex].Offset); }
+
+	// same queries as RTTI, answered from the index tables
+	const FDatabaseClass* Find(uintptr_t VTable) const;
+	const FDatabaseClass* FindFirst(std::string_view ClassName) const;
+	std::vector<const FDatabaseClass*> FindAll(const std::string& ClassName) const;
+	std::vector<const FDatabaseClass*> FindChildClasses(const FDatabaseClass& Class) const;
+
+protected:
+	template<typename T>
+	bool GetTable(EDatabaseTable Table, std::span<const T>& OutTable) const;
+
+	HANDLE File = INVALID_HANDLE_VALUE;
+	HANDLE Mapping = NULL;
+	const uint8_t* View = nullptr;
+	uint64_t ViewSize = 0;
+
+	const FDatabaseHeader* Header = nullptr;
+	uintptr_t ModuleBase = 0;
+
+	std::span<const FDatabaseClass> Classes;
+	std::span<const FDatabaseParent> Parents;
+	std::span<const FDatabaseSlot> Slots;
+	std::span<const FDatabaseFunction> Functions;
+	std::span<const uint32_t> FunctionRefs;
+	std::span<const int64_t> References;
+	std::span<const FDatabaseInstance> Instances;
+	std::span<const uint32_t> NameIndex;
+	std::span<const uint32_t> VTableIndex;
+	std::span<const FDatabaseChild> ChildIndex;
+	std::span<const char> Strings;
+};
@@ -0,0 +1,542 @@
+#include "ClassDiff.h"
+#include "../Util/BufferedWriter.h"
+#include "../Util/Hash.h"
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+namespace
+{
+	constexpr uint32_t InvalidIndex = FClassDatabase::InvalidIndex;
+	constexpr uint32_t ConflictIndex = InvalidIndex - 1;
+
+	// largest middle section of two vtables aligned exactly, bigger ones are paired up slot by slot
+	constexpr size_t MaxAlignmentCells = 1 << 16;
+
+	// inferred names are derived again from the new build, only what the user typed is carried over
+	bool HasUserName(const FDatabaseFunction& Function)
+	{
+		return Function.Name.Length > 0 && (Function.Flags & DatabaseFunctionInferredName) == 0;
+	}
+
+	const char* GetMatchKindName(EClassMatchKind Kind)
+	{
+		switch (Kind)
+		{
+		case EClassMatchKind::MangledName:
+			return "name";
+		case EClassMatchKind::Content:
+			return "content";
+		case EClassMatchKind::Shape:
+			return "shape";
+		}
+		return "";
+	}
+}
+
+FClassDiff::FClassDiff(const FClassDatabase& InOld, const FClassDatabase& InNew)
+	: Old(InOld), New(InNew)
+{
+}
+
+void FClassDiff::Run()
+{
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	Matches.clear();
+	Added.clear();
+	Removed.clear();
+	Renames.clear();
+	Stats = FClassDiffStats();
+	OldToNew.assign(Old.GetClasses().size(), InvalidIndex);
+	NewToOld.assign(New.GetClasses().size(), InvalidIndex);
+
+	MatchByMangledName();
+	MatchByHash(EClassMatchKind::Content);
+	MatchByHash(EClassMatchKind::Shape);
+
+	std::sort(Matches.begin(), Matches.end(), [](const FClassMatch& A, const FClassMatch& B) { return A.NewClass < B.NewClass; });
+
+	AlignVTables();
+	CollectUnmatched();
+
+	Stats.ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+}
+
+void FClassDiff::AddMatch(uint32_t OldClass, uint32_t NewClass, EClassMatchKind Kind)
+{
+	OldToNew[OldClass] = NewClass;
+	NewToOld[NewClass] = OldClass;
+
+	FClassMatch& Match = Matches.emplace_back();
+	Match.OldClass = OldClass;
+	Match.NewClass = NewClass;
+	Match.Kind = Kind;
+	Match.bRenamed = Old.GetString(Old.GetClass(OldClass).Name) != New.GetString(New.GetClass(NewClass).Name);
+
+	Stats.NumMatchedByName += Kind == EClassMatchKind::MangledName ? 1 : 0;
+	Stats.NumMatchedByContent += Kind == EClassMatchKind::Content ? 1 : 0;
+	Stats.NumMatchedByShape += Kind == EClassMatchKind::Shape ? 1 : 0;
+}
+
+void FClassDiff::MatchByMangledName()
+{
+	auto GetKey = [](const FClassDatabase& Database, const FDatabaseClass& Class)
+	{
+		const std::string_view MangledName = Database.GetString(Class.MangledName);
+		return FHash::Hash64(MangledName.data(), MangledName.size(), Class.VTableOffset);
+	};
+
+	// vtables sharing a key are paired in order, the linker keeps the order of a class's vtables
+	struct FCandidates
+	{
+		std::vector<uint32_t> Classes;
+		size_t Next = 0;
+	};
+
+	std::unordered_map<uint64_t, FCandidates> NewByKey;
+	NewByKey.reserve(New.GetClasses().size());
+
+	for (const FDatabaseClass& Class : New.GetClasses())
+	{
+		NewByKey[GetKey(New, Class)].Classes.push_back(New.GetClassID(Class));
+	}
+
+	for (const FDatabaseClass& Class : Old.GetClasses())
+	{
+		auto it = NewByKey.find(GetKey(Old, Class));
+		if (it == NewByKey.end())
+		{
+			continue;
+		}
+
+		FCandidates& Candidates = it->second;
+		while (Candidates.Next < Candidates.Classes.size())
+		{
+			const FDatabaseClass& Candidate = New.GetClass(Candidates.Classes[Candidates.Next++]);
+			if (Candidate.VTableOffset == Class.VTableOffset && New.GetString(Candidate.MangledName) == Old.GetString(Class.MangledName))
+			{
+				AddMatch(Old.GetClassID(Class), New.GetClassID(Candidate), EClassMatchKind::MangledName);
+				break;
+			}
+		}
+	}
+}
+
+void FClassDiff::MatchByHash(EClassMatchKind Kind)
+{
+	auto GetHash = [&](const FClassDatabase& Database, const FDatabaseClass& Class)
+	{
+		return Kind == EClassMatchKind::Content ? GetContentHash(Database, Class) : GetShapeHash(Database, Class);
+	};
+
+	// hash -> class, or InvalidIndex once a second class has the same hash
+	std::unordered_map<uint64_t, uint32_t> OldByHash;
+	for (const FDatabaseClass& Class : Old.GetClasses())
+	{
+		const uint32_t ClassID = Old.GetClassID(Class);
+		const uint64_t Hash = OldToNew[ClassID] == InvalidIndex ? GetHash(Old, Class) : 0;
+		if (Hash != 0)
+		{
+			auto [it, bInserted] = OldByHash.try_emplace(Hash, ClassID);
+			it->second = bInserted ? ClassID : InvalidIndex;
+		}
+	}
+
+	std::unordered_map<uint64_t, uint32_t> NewByHash;
+	for (const FDatabaseClass& Class : New.GetClasses())
+	{
+		const uint32_t ClassID = New.GetClassID(Class);
+		const uint64_t Hash = NewToOld[ClassID] == InvalidIndex ? GetHash(New, Class) : 0;
+		if (Hash != 0)
+		{
+			auto [it, bInserted] = NewByHash.try_emplace(Hash, ClassID);
+			it->second = bInserted ? ClassID : InvalidIndex;
+		}
+	}
+
+	for (const auto& [Hash, NewClass] : NewByHash)
+	{
+		auto it = OldByHash.find(Hash);
+		if (NewClass != InvalidIndex && it != OldByHash.end() && it->second != InvalidIndex)
+		{
+			AddMatch(it->second, NewClass, Kind);
+		}
+	}
+}
+
+uint64_t FClassDiff::GetContentHash(const FClassDatabase& Database, const FDatabaseClass& Class) const
+{
+	const std::span<const FDatabaseSlot> Slots = Database.GetSlots(Class);
+	if (Slots.empty())
+	{
+		return 0;
+	}
+
+	std::vector<uint64_t> Keys;
+	Keys.reserve(Slots.size() + 1);
+	Keys.push_back(Class.VTableOffset);
+
+	for (const FDatabaseSlot& Slot : Slots)
+	{
+		// sizes alone are too weak to tell classes apart, only fully hashed vtables take part
+		const uint64_t Hash = Database.GetFunction(Slot.Function).Hash;
+		if (Hash == 0)
+		{
+			return 0;
+		}
+		Keys.push_back(Hash);
+	}
+
+	return FHash::Hash64(Keys.data(), Keys.size() * sizeof(uint64_t)) | 1;
+}
+
+uint64_t FClassDiff::GetShapeHash(const FClassDatabase& Database, const FDatabaseClass& Class) const
+{
+	const std::span<const FDatabaseSlot> Slots = Database.GetSlots(Class);
+	if (Slots.empty())
+	{
+		return 0;
+	}
+
+	std::vector<uint8_t> Shape;
+	Shape.reserve(Slots.size() + 16);
+
+	auto Append = [&](uint32_t Value)
+	{
+		const uint8_t* Bytes = reinterpret_cast<const uint8_t*>(&Value);
+		Shape.insert(Shape.end(), Bytes, Bytes + sizeof(Value));
+	};
+
+	Append(static_cast<uint32_t>(Slots.size()));
+	Append(Class.Parents.Count);
+	Append(Class.ObjectSize);
+	Append(Class.VTableOffset);
+	Shape.push_back(Class.Flags);
+
+	for (const FDatabaseSlot& Slot : Slots)
+	{
+		Shape.push_back(Slot.Status);
+	}
+
+	return FHash::Hash64(Shape.data(), Shape.size()) | 1;
+}
+
+uint64_t FClassDiff::GetSlotKey(const FClassDatabase& Database, const FDatabaseSlot& Slot)
+{
+	const FDatabaseFunction& Function = Database.GetFunction(Slot.Function);
+	return Function.Hash != 0 ? Function.Hash : Function.Size;
+}
+
+void FClassDiff::AlignVTables()
+{
+	// old function that gives its name to each new function, ConflictIndex if two disagree
+	std::vector<uint32_t> RenameTargets(New.GetFunctions().size(), InvalidIndex);
+
+	for (FClassMatch& Match : Matches)
+	{
+		AlignVTable(Match, RenameTargets);
+
+		if (!Match.SlotEdits.empty())
+		{
+			Stats.NumChangedVTables++;
+			Stats.NumSlotEdits += Match.SlotEdits.size();
+		}
+	}
+
+	for (uint32_t NewFunction = 0; NewFunction < RenameTargets.size(); NewFunction++)
+	{
+		const uint32_t OldFunction = RenameTargets[NewFunction];
+		if (OldFunction == ConflictIndex)
+		{
+			Stats.NumRenameConflicts++;
+			continue;
+		}
+
+		// names the user already gave in the new build win
+		if (OldFunction == InvalidIndex || HasUserName(New.GetFunction(NewFunction)))
+		{
+			continue;
+		}
+
+		Renames.push_back({ OldFunction, NewFunction, Old.GetString(Old.GetFunction(OldFunction).Name) });
+	}
+
+	Stats.NumRenames = Renames.size();
+}
+
+void FClassDiff::AlignVTable(FClassMatch& Match, std::vector<uint32_t>& RenameTargets)
+{
+	const std::span<const FDatabaseSlot> OldSlots = Old.GetSlots(Old.GetClass(Match.OldClass));
+	const std::span<const FDatabaseSlot> NewSlots = New.GetSlots(New.GetClass(Match.NewClass));
+
+	auto CarryName = [&](uint32_t OldSlot, uint32_t NewSlot)
+	{
+		const uint32_t OldFunction = OldSlots[OldSlot].Function;
+		if (!HasUserName(Old.GetFunction(OldFunction)))
+		{
+			return;
+		}
+
+		uint32_t& Target = RenameTargets[NewSlots[NewSlot].Function];
+		if (Target == InvalidIndex)
+		{
+			Target = OldFunction;
+		}
+		else if (Target != ConflictIndex && Target != OldFunction
+			&& Old.GetString(Old.GetFunction(Target).Name) != Old.GetString(Old.GetFunction(OldFunction).Name))
+		{
+			Target = ConflictIndex;
+		}
+	};
+
+	auto IsSame = [&](size_t OldSlot, size_t NewSlot) { return GetSlotKey(Old, OldSlots[OldSlot]) == GetSlotKey(New, NewSlots[NewSlot]); };
+
+	// most vtables are unchanged or changed in one place, only the middle needs aligning
+	size_t Prefix = 0;
+	while (Prefix < OldSlots.size() && Prefix < NewSlots.size() && IsSame(Prefix, Prefix))
+	{
+		CarryName(static_cast<uint32_t>(Prefix), static_cast<uint32_t>(Prefix));
+		Prefix++;
+	}
+
+	size_t Suffix = 0;
+	while (Suffix < OldSlots.size() - Prefix && Suffix < NewSlots.size() - Prefix
+		&& IsSame(OldSlots.size() - 1 - Suffix, NewSlots.size() - 1 - Suffix))
+	{
+		CarryName(static_cast<uint32_t>(OldSlots.size() - 1 - Suffix), static_cast<uint32_t>(NewSlots.size() - 1 - Suffix));
+		Suffix++;
+	}
+
+	const size_t NumOld = OldSlots.size() - Prefix - Suffix;
+	const size_t NumNew = NewSlots.size() - Prefix - Suffix;
+	if (NumOld == 0 && NumNew == 0)
+	{
+		return;
+	}
+
+	// edit script of the middle, true where the old and new slot are kept
+	enum class EOp : uint8_t { Keep, Delete, Insert };
+	std::vector<EOp> Ops;
+
+	if ((NumOld + 1) * (NumNew + 1) <= MaxAlignmentCells)
+	{
+		// longest common subsequence, filled from the end so the walk below goes forward
+		std::vector<uint16_t> Lengths((NumOld + 1) * (NumNew + 1), 0);
+		auto At = [&](size_t i, size_t j) -> uint16_t& { return Lengths[i * (NumNew + 1) + j]; };
+
+		for (size_t i = NumOld; i-- > 0;)
+		{
+			for (size_t j = NumNew; j-- > 0;)
+			{
+				At(i, j) = IsSame(Prefix + i, Prefix + j) ? At(i + 1, j + 1) + 1 : std::max(At(i + 1, j), At(i, j + 1));
+			}
+		}
+
+		size_t i = 0;
+		size_t j = 0;
+		while (i < NumOld || j < NumNew)
+		{
+			if (i < NumOld && j < NumNew && IsSame(Prefix + i, Prefix + j))
+			{
+				Ops.push_back(EOp::Keep);
+				i++;
+				j++;
+			}
+			else if (j < NumNew && (i == NumOld || At(i, j + 1) >= At(i + 1, j)))
+			{
+				Ops.push_back(EOp::Insert);
+				j++;
+			}
+			else
+			{
+				Ops.push_back(EOp::Delete);
+				i++;
+			}
+		}
+	}
+	else
+	{
+		Ops.insert(Ops.end(), NumOld, EOp::Delete);
+		Ops.insert(Ops.end(), NumNew, EOp::Insert);
+	}
+
+	// deletions and insertions between the same kept slots pair up as modified slots
+	uint32_t OldSlot = static_cast<uint32_t>(Prefix);
+	uint32_t NewSlot = static_cast<uint32_t>(Prefix);
+	for (size_t First = 0; First < Ops.size();)
+	{
+		if (Ops[First] == EOp::Keep)
+		{
+			CarryName(OldSlot++, NewSlot++);
+			First++;
+			continue;
+		}
+
+		size_t Last = First;
+		size_t NumDeleted = 0;
+		size_t NumInserted = 0;
+		for (; Last < Ops.size() && Ops[Last] != EOp::Keep; Last++)
+		{
+			NumDeleted += Ops[Last] == EOp::Delete ? 1 : 0;
+			NumInserted += Ops[Last] == EOp::Insert ? 1 : 0;
+		}
+
+		const size_t NumModified = std::min(NumDeleted, NumInserted);
+		for (size_t k = 0; k < NumModified; k++)
+		{
+			Match.SlotEdits.push_back({ ESlotEditKind::Modified, OldSlot, NewSlot });
+			CarryName(OldSlot++, NewSlot++);
+		}
+
+		for (size_t k = NumModified; k < NumDeleted; k++)
+		{
+			Match.SlotEdits.push_back({ ESlotEditKind::Deleted, OldSlot++, InvalidIndex });
+		}
+
+		for (size_t k = NumModified; k < NumInserted; k++)
+		{
+			Match.SlotEdits.push_back({ ESlotEditKind::Inserted, InvalidIndex, NewSlot++ });
+		}
+
+		First = Last;
+	}
+}
+
+void FClassDiff::CollectUnmatched()
+{
+	for (uint32_t ClassID = 0; ClassID < OldToNew.size(); ClassID++)
+	{
+		if (OldToNew[ClassID] == InvalidIndex)
+		{
+			Removed.push_back(ClassID);
+		}
+	}
+
+	for (uint32_t ClassID = 0; ClassID < NewToOld.size(); ClassID++)
+	{
+		if (NewToOld[ClassID] == InvalidIndex)
+		{
+			Added.push_back(ClassID);
+		}
+	}
+
+	Stats.NumAdded = Added.size();
+	Stats.NumRemoved = Removed.size();
+}
+
+bool FClassDiff::WriteReport(const std::string& Path) const
+{
+	FBufferedWriter Out;
+	if (!Out.Open(Path))
+	{
+		return false;
+	}
+
+	auto WriteLine = [&](const std::string& Line)
+	{
+		Out.Write(Line);
+		Out.Write('\n');
+	};
+
+	auto WriteClass = [&](const FClassDatabase& Database, uint32_t ClassID)
+	{
+		const FDatabaseClass& Class = Database.GetClass(ClassID);
+		Out.Write(Database.GetString(Class.Name));
+		if (Class.VTableOffset != 0)
+		{
+			Out.Write(" (vtable at +0x");
+			Out.WriteHex(Class.VTableOffset);
+			Out.Write(')');
+		}
+	};
+
+	WriteLine("// " + std::string(Old.GetModuleName()) + " -> " + std::string(New.GetModuleName()));
+	WriteLine("// classes: " + std::to_string(Matches.size()) + " matched ("
+		+ std::to_string(Stats.NumMatchedByName) + " by name, "
+		+ std::to_string(Stats.NumMatchedByContent) + " by content, "
+		+ std::to_string(Stats.NumMatchedByShape) + " by shape), "
+		+ std::to_string(Stats.NumAdded) + " added, "
+		+ std::to_string(Stats.NumRemoved) + " removed");
+	WriteLine("// vtables: " + std::to_string(Stats.NumChangedVTables) + " changed, " + std::to_string(Stats.NumSlotEdits) + " slot edits");
+	WriteLine("// functions: " + std::to_string(Stats.NumRenames) + " names carried over, " + std::to_string(Stats.NumRenameConflicts) + " conflicts");
+	WriteLine("");
+
+	for (uint32_t ClassID : Added)
+	{
+		Out.Write("added    ");
+		WriteClass(New, ClassID);
+		Out.Write('\n');
+	}
+
+	for (uint32_t ClassID : Removed)
+	{
+		Out.Write("removed  ");
+		WriteClass(Old, ClassID);
+		Out.Write('\n');
+	}
+
+	for (const FClassMatch& Match : Matches)
+	{
+		if (Match.bRenamed)
+		{
+			Out.Write("renamed  ");
+			WriteClass(Old, Match.OldClass);
+			Out.Write(" -> ");
+			WriteClass(New, Match.NewClass);
+			Out.Write(" [");
+			Out.Write(GetMatchKindName(Match.Kind));
+			Out.Write("]\n");
+		}
+
+		if (Match.SlotEdits.empty())
+		{
+			continue;
+		}
+
+		Out.Write("vtable   ");
+		WriteClass(New, Match.NewClass);
+		Out.Write(": ");
+		Out.WriteDecimal(Old.GetClass(Match.OldClass).Slots.Count);
+		Out.Write(" -> ");
+		Out.WriteDecimal(New.GetClass(Match.NewClass).Slots.Count);
+		Out.Write(" slots\n");
+
+		for (const FSlotEdit& Edit : Match.SlotEdits)
+		{
+			switch (Edit.Kind)
+			{
+			case ESlotEditKind::Inserted:
+				Out.Write("  + slot ");
+				Out.WriteDecimal(Edit.NewSlot);
+				break;
+			case ESlotEditKind::Deleted:
+				Out.Write("  - old slot ");
+				Out.WriteDecimal(Edit.OldSlot);
+				break;
+			case ESlotEditKind::Modified:
+				Out.Write("  ~ slot ");
+				Out.WriteDecimal(Edit.NewSlot);
+				if (Edit.OldSlot != Edit.NewSlot)
+				{
+					Out.Write(" (old slot ");
+					Out.WriteDecimal(Edit.OldSlot);
+					Out.Write(')');
+				}
+				break;
+			}
+			Out.Write('\n');
+		}
+	}
+
+	for (const FFunctionRename& Rename : Renames)
+	{
+		Out.Write("name     sub_");
+		Out.WriteHex(New.GetFunctionAddress(Rename.NewFunction));
+		Out.Write(" = ");
+		Out.Write(Rename.Name);
+		Out.Write('\n');
+	}
+
+	return Out.Close();
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "ClassDatabase.h"
+#include <string>
+#include <vector>
+
+enum class EClassMatchKind : uint8_t
+{
+	MangledName, // same mangled name and vtable offset
+	Content, // same slot count and the same function hashes in every slot
+	Shape // same slot count, slot status, parent count and object size, unique in both builds
+};
+
+enum class ESlotEditKind : uint8_t
+{
+	Inserted, // only in the new vtable
+	Deleted, // only in the old vtable
+	Modified // both vtables have a slot here but the function changed
+};
+
+struct FSlotEdit
+{
+	ESlotEditKind Kind = ESlotEditKind::Inserted;
+	uint32_t OldSlot = FClassDatabase::InvalidIndex;
+	uint32_t NewSlot = FClassDatabase::InvalidIndex;
+};
+
+struct FClassMatch
+{
+	uint32_t OldClass = 0;
+	uint32_t NewClass = 0;
+	EClassMatchKind Kind = EClassMatchKind::MangledName;
+	bool bRenamed = false;
+	std::vector<FSlotEdit> SlotEdits; // in vtable order, empty if the vtable did not change
+};
+
+// a user given name of the old build that applies to a function of the new build
+struct FFunctionRename
+{
+	uint32_t OldFunction = 0;
+	uint32_t NewFunction = 0;
+	std::string_view Name; // points into the old database
+};
+
+struct FClassDiffStats
+{
+	size_t NumMatchedByName = 0;
+	size_t NumMatchedByContent = 0;
+	size_t NumMatchedByShape = 0;
+	size_t NumChangedVTables = 0;
+	size_t NumSlotEdits = 0;
+	size_t NumAdded = 0;
+	size_t NumRemoved = 0;
+	size_t NumRenames = 0;
+	size_t NumRenameConflicts = 0; // new functions that would get different names from different slots
+	double ElapsedMs = 0.0;
+};
+
+/**
+ * Compares the classes of two builds of a module, given as class databases.
+ * Classes are matched by mangled name first. What is left is matched by a hash of the function hashes
+ * of every slot, then by a hash of the vtable shape; a hash only matches when it is unique in both
+ * builds. Every step is a hash map lookup per class, no pair of classes is compared directly.
+ * Matched vtables are aligned slot by slot on function hashes to find insertions and deletions, and
+ * names the user gave to functions in the old build are carried to the functions in the same slots.
+ */
+class FClassDiff
+{
+public:
+	FClassDiff(const FClassDatabase& InOld, const FClassDatabase& InNew);
+
+	void Run();
+
+	const std::vector<FClassMatch>& GetMatches() const { return Matches; }
+	const std::vector<uint32_t>& GetAdded() const { return Added; }
+	const std::vector<uint32_t>& GetRemoved() const { return Removed; }
+	const std::vector<FFunctionRename>& GetRenames() const { return Renames; }
+	const FClassDiffStats& GetStats() const { return Stats; }
+
+	// human readable summary followed by every added, removed, renamed and changed class
+	bool WriteReport(const std::string& Path) const;
+
+protected:
+	void MatchByMangledName();
+	void MatchByHash(EClassMatchKind Kind);
+	void AlignVTables();
+	void AlignVTable(FClassMatch& Match, std::vector<uint32_t>& RenameTargets);
+	void CollectUnmatched();
+
+	uint64_t GetContentHash(const FClassDatabase& Database, const FDatabaseClass& Class) const;
+	uint64_t GetShapeHash(const FClassDatabase& Database, const FDatabaseClass& Class) const;
+
+	// identity of the function in a slot for alignment, its hash or its size if it was never hashed
+	static uint64_t GetSlotKey(const FClassDatabase& Database, const FDatabaseSlot& Slot);
+
+	void AddMatch(uint32_t OldClass, uint32_t NewClass, EClassMatchKind Kind);
+
+	const FClassDatabase& Old;
+	const FClassDatabase& New;
+
+	std::vector<FClassMatch> Matches;
+	std::vector<uint32_t> Added;
+	std::vector<uint32_t> Removed;
+	std::vector<FFunctionRename> Renames;
+	FClassDiffStats Stats;
+
+	std::vector<uint32_t> OldToNew; // InvalidIndex while unmatched
+	std::vector<uint32_t> NewToOld;
+};
@@ -0,0 +1,940 @@
+#include "CodeScanner.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../Util/ThreadPool.h"
+
+namespace
+{
+	using FClock = std::chrono::steady_clock;
+
+	uint64_t ElapsedNs(FClock::time_point Start)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(FClock::now() - Start).count());
+	}
+
+	constexpr uint8_t Int3 = 0xCC;
+}
+
+FCodeScanner::FCodeScanner(FTargetProcess* InProcess)
+	: Process(InProcess)
+{
+}
+
+bool FCodeScanner::LoadRanges(const std::vector<FMemoryRange>& Ranges)
+{
+	const auto StartTime = FClock::now();
+
+	std::vector<std::future<FMemoryBlock>> Futures;
+	Futures.reserve(Ranges.size());
+	for (const FMemoryRange& Range : Ranges)
+	{
+		Futures.emplace_back(Process->ReadMemoryAsync(Range));
+	}
+
+	Blocks.clear();
+	Blocks.reserve(Futures.size());
+	for (std::future<FMemoryBlock>& Future : Futures)
+	{
+		FMemoryBlock Block = Future.get();
+		if (Block.IsValid())
+		{
+			Stats.BytesLoaded += Block.Size;
+			Blocks.push_back(std::move(Block));
+		}
+	}
+
+	std::sort(Blocks.begin(), Blocks.end(), [](const FMemoryBlock& A, const FMemoryBlock& B) { return A.Address < B.Address; });
+
+	Stats.LoadNs += ElapsedNs(StartTime);
+	return !Blocks.empty();
+}
+
+std::vector<FMemoryRange> FCodeScanner::SplitAtPadding(size_t MinSize) const
+{
+	std::vector<FMemoryRange> WorkRanges;
+	MinSize = std::max<size_t>(MinSize, 2);
+
+	for (const FMemoryBlock& Block : Blocks)
+	{
+		const uint8_t* Data = Block.Copy.data();
+		const uintptr_t Base = reinterpret_cast<uintptr_t>(Block.Address);
+
+		size_t Start = 0;
+		while (Start < Block.Size)
+		{
+			// the next function starts at the first non-int3 byte after at least two bytes of padding
+			size_t Cut = Start + MinSize;
+			while (Cut < Block.Size && !(Data[Cut - 1] == Int3 && Data[Cut - 2] == Int3 && Data[Cut] != Int3))
+			{
+				Cut++;
+			}
+			Cut = std::min(Cut, Block.Size);
+
+			WorkRanges.emplace_back(Base + Start, Base + Cut, true, true, false);
+			Start = Cut;
+		}
+	}
+
+	return WorkRanges;
+}
+
+template <typename FResult, typename FDecodeFunction>
+std::vector<FResult> FCodeScanner::DecodeParallel(const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads, FDecodeFunction&& Decode)
+{
+	const auto StartTime = FClock::now();
+
+	if (NumThreads == 0)
+	{
+		NumThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+	NumThreads = std::min(NumThreads, std::max<size_t>(WorkRanges.size(), 1));
+
+	// one result list per worker so decoding never takes a lock
+	std::vector<std::vector<FResult>> WorkerResults(NumThreads);
+	std::vector<FCodeScanStats> WorkerStats(NumThreads);
+	std::atomic<size_t> NextRange = 0;
+
+	{
+		ThreadPool Pool(NumThreads);
+
+		for (size_t i = 0; i < NumThreads; i++)
+		{
+			Pool.enqueue([&, i]()
+				{
+					for (size_t RangeIndex = NextRange++; RangeIndex < WorkRanges.size(); RangeIndex = NextRange++)
+					{
+						Decode(WorkRanges[RangeIndex], WorkerResults[i], WorkerStats[i]);
+					}
+				});
+		}
+	}
+
+	std::vector<FResult> Results;
+	for (size_t i = 0; i < NumThreads; i++)
+	{
+		Results.insert(Results.end(), WorkerResults[i].begin(), WorkerResults[i].end());
+		Stats.BytesDecoded += WorkerStats[i].BytesDecoded;
+		Stats.Instructions += WorkerStats[i].Instructions;
+		Stats.DecodeFailures += WorkerStats[i].DecodeFailures;
+	}
+
+	Stats.WorkRanges += WorkRanges.size();
+	Stats.DecodeNs += ElapsedNs(StartTime);
+	return Results;
+}
+
+std::vector<FCodeReference> FCodeScanner::FindReferences(const FAddressIndex& Targets)
+{
+	return FindReferences(Targets, SplitAtPadding());
+}
+
+std::vector<FCodeReference> FCodeScanner::FindReferences(const FAddressIndex& Targets, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads)
+{
+	std::vector<FCodeReference> Results = DecodeParallel<FCodeReference>(WorkRanges, NumThreads,
+		[&](const FMemoryRange& Range, std::vector<FCodeReference>& RangeResults, FCodeScanStats& RangeStats)
+		{
+			DecodeRange(Range, Targets, RangeResults, RangeStats);
+		});
+
+	std::sort(Results.begin(), Results.end(), [](const FCodeReference& A, const FCodeReference& B) { return A.Instruction < B.Instruction; });
+	return Results;
+}
+
+std::vector<FVirtualCall> FCodeScanner::FindVirtualCalls(const FAddressIndex& FunctionStarts)
+{
+	return FindVirtualCalls(FunctionStarts, SplitAtPadding());
+}
+
+std::vector<FVirtualCall> FCodeScanner::FindVirtualCalls(const FAddressIndex& FunctionStarts, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads)
+{
+	std::vector<FVirtualCall> Results = DecodeParallel<FVirtualCall>(WorkRanges, NumThreads,
+		[&](const FMemoryRange& Range, std::vector<FVirtualCall>& RangeResults, FCodeScanStats& RangeStats)
+		{
+			DecodeVirtualCalls(Range, FunctionStarts, RangeResults, RangeStats);
+		});
+
+	std::sort(Results.begin(), Results.end(), [](const FVirtualCall& A, const FVirtualCall& B) { return A.Instruction < B.Instruction; });
+	return Results;
+}
+
+std::vector<FVTableStore> FCodeScanner::FindVTableStores(const FAddressIndex& VTables, const FAddressIndex& FunctionStarts)
+{
+	return FindVTableStores(VTables, FunctionStarts, SplitAtPadding());
+}
+
+std::vector<FVTableStore> FCodeScanner::FindVTableStores(const FAddressIndex& VTables, const FAddressIndex& FunctionStarts, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads)
+{
+	std::vector<FVTableStore> Results = DecodeParallel<FVTableStore>(WorkRanges, NumThreads,
+		[&](const FMemoryRange& Range, std::vector<FVTableStore>& RangeResults, FCodeScanStats& RangeStats)
+		{
+			DecodeVTableStores(Range, VTables, FunctionStarts, RangeResults, RangeStats);
+		});
+
+	std::sort(Results.begin(), Results.end(), [](const FVTableStore& A, const FVTableStore& B) { return A.Instruction < B.Instruction; });
+	return Results;
+}
+
+std::vector<FAllocationSite> FCodeScanner::FindAllocationSites(const FAddressIndex& Constructors)
+{
+	return FindAllocationSites(Constructors, SplitAtPadding());
+}
+
+std::vector<FAllocationSite> FCodeScanner::FindAllocationSites(const FAddressIndex& Constructors, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads)
+{
+	std::vector<FAllocationSite> Results = DecodeParallel<FAllocationSite>(WorkRanges, NumThreads,
+		[&](const FMemoryRange& Range, std::vector<FAllocationSite>& RangeResults, FCodeScanStats& RangeStats)
+		{
+			DecodeAllocationSites(Range, Constructors, RangeResults, RangeStats);
+		});
+
+	std::sort(Results.begin(), Results.end(), [](const FAllocationSite& A, const FAllocationSite& B) { return A.Instruction < B.Instruction; });
+	return Results;
+}
+
+std::vector<FCodeReference> FCodeScanner::FindRelocatedReferences(const FAddressIndex& Targets, const FPEImage& Image)
+{
+	const auto StartTime = FClock::now();
+	std::vector<FCodeReference> Results;
+
+	for (uint32_t Rva : Image.GetRelocations())
+	{
+		const uintptr_t Site = Image.GetImageBase() + Rva;
+		const uint8_t* Local = GetLocalCopy(Site, sizeof(uintptr_t));
+		if (!Local)
+		{
+			continue;
+		}
+
+		uintptr_t Target = 0;
+		memcpy(&Target, Local, sizeof(uintptr_t));
+
+		const uint32_t TargetIndex = Targets.Find(Target);
+		if (TargetIndex == FAddressIndex::InvalidIndex)
+		{
+			continue;
+		}
+
+		ZydisDecodedInstruction Instruction;
+		uintptr_t Address = 0;
+		if (FindFixupInstruction(Site, Instruction, Address))
+		{
+			Stats.Instructions++;
+			Results.push_back({ Address, Target, TargetIndex, Instruction.length });
+		}
+		else
+		{
+			Stats.DecodeFailures++;
+		}
+	}
+
+	std::sort(Results.begin(), Results.end(), [](const FCodeReference& A, const FCodeReference& B) { return A.Instruction < B.Instruction; });
+
+	Stats.BytesDecoded += Image.GetRelocations().size() * sizeof(uintptr_t);
+	Stats.DecodeNs += ElapsedNs(StartTime);
+	return Results;
+}
+
+bool FCodeScanner::FindFixupInstruction(uintptr_t Site, ZydisDecodedInstruction& OutInstruction, uintptr_t& OutAddress) const
+{
+	constexpr size_t MaxInstructionLength = 15;
+	constexpr ZyanU8 PointerBits = sizeof(uintptr_t) * 8;
+
+	// the closest start that decodes to an instruction whose displacement or immediate is the fixup
+	for (size_t Back = 1; Back < MaxInstructionLength; Back++)
+	{
+		const uintptr_t Start = Site - Back;
+		const FMemoryBlock* Block = FindBlock(Start);
+		if (!Block)
+		{
+			break;
+		}
+
+		const uintptr_t BlockStart = reinterpret_cast<uintptr_t>(Block->Address);
+		const uint8_t* Data = Block->Copy.data() + (Start - BlockStart);
+		if (!Decoder.DecodeInstruction(Data, BlockStart + Block->Size - Start, OutInstruction) || OutInstruction.length < Back + sizeof(uintptr_t))
+		{
+			continue;
+		}
+
+		const bool bDisplacement = OutInstruction.raw.disp.size == PointerBits && OutInstruction.raw.disp.offset == Back;
+		const bool bImmediate = (OutInstruction.raw.imm[0].size == PointerBits && OutInstruction.raw.imm[0].offset == Back)
+			|| (OutInstruction.raw.imm[1].size == PointerBits && OutInstruction.raw.imm[1].offset == Back);
+
+		if (bDisplacement || bImmediate)
+		{
+			OutAddress = Start;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const uint8_t* FCodeScanner::GetLocalCopy(uintptr_t Address, size_t Size) const
+{
+	const FMemoryBlock* Block = FindBlock(Address);
+	if (!Block)
+	{
+		return nullptr;
+	}
+
+	const uintptr_t Offset = Address - reinterpret_cast<uintptr_t>(Block->Address);
+	return Offset + Size <= Block->Size ? Block->Copy.data() + Offset : nullptr;
+}
+
+std::vector<uintptr_t> FCodeScanner::FindDirectCallees(uintptr_t Function, size_t Size) const
+{
+	constexpr size_t MaxFunctionSize = 0x1000;
+
+	const size_t Available = GetLocalSize(Function);
+	const uint8_t* Data = Available ? GetLocalCopy(Function, Available) : nullptr;
+	if (!Data)
+	{
+		return {};
+	}
+
+	Size = Size ? std::min(Size, Available) : Decoder.GetFunctionSize(Data, std::min(Available, MaxFunctionSize));
+
+	std::vector<uintptr_t> Callees;
+	ZydisDecodedInstruction Instruction;
+
+	for (size_t Offset = 0; Offset < Size;)
+	{
+		if (!Decoder.DecodeInstruction(Data + Offset, Size - Offset, Instruction))
+		{
+			Offset++;
+			continue;
+		}
+
+		const uintptr_t Address = Function + Offset;
+		Offset += Instruction.length;
+
+		const ZydisDecodedOperand& Destination = Instruction.operands[0];
+		if ((Instruction.mnemonic != ZYDIS_MNEMONIC_CALL && Instruction.mnemonic != ZYDIS_MNEMONIC_JMP)
+			|| Destination.type != ZYDIS_OPERAND_TYPE_IMMEDIATE || !Destination.imm.is_relative)
+		{
+			continue;
+		}
+
+		ZyanU64 Absolute = 0;
+		if (!ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(&Instruction, &Destination, Address, &Absolute)))
+		{
+			continue;
+		}
+
+		// jumps inside the function are control flow, not tail calls
+		if (Absolute < Function || Absolute >= Function + Size)
+		{
+			Callees.push_back(static_cast<uintptr_t>(Absolute));
+		}
+	}
+
+	return Callees;
+}
+
+size_t FCodeScanner::GetLocalSize(uintptr_t Address) const
+{
+	const FMemoryBlock* Block = FindBlock(Address);
+	return Block ? reinterpret_cast<uintptr_t>(Block->Address) + Block->Size - Address : 0;
+}
+
+const FMemoryBlock* FCodeScanner::FindBlock(uintptr_t Address) const
+{
+	auto it = std::upper_bound(Blocks.begin(), Blocks.end(), Address, [](uintptr_t Value, const FMemoryBlock& Block) { return Value < reinterpret_cast<uintptr_t>(Block.Address); });
+	if (it == Blocks.begin())
+	{
+		return nullptr;
+	}
+
+	--it;
+	return Address - reinterpret_cast<uintptr_t>(it->Address) < it->Size ? &*it : nullptr;
+}
+
+void FCodeScanner::DecodeRange(const FMemoryRange& Range, const FAddressIndex& Targets, std::vector<FCodeReference>& Results, FCodeScanStats& RangeStats) const
+{
+	const FMemoryBlock* Block = FindBlock(Range.Start);
+	if (!Block)
+	{
+		return;
+	}
+
+	const uintptr_t BlockStart = reinterpret_cast<uintptr_t>(Block->Address);
+	const uint8_t* Data = Block->Copy.data() + (Range.Start - BlockStart);
+	const size_t Length = std::min<size_t>(Range.End, BlockStart + Block->Size) - Range.Start;
+
+	// the last instruction of a range may run into the next one
+	const size_t Available = BlockStart + Block->Size - Range.Start;
+
+	ZydisDecodedInstruction Instruction;
+	size_t Offset = 0;
+
+	while (Offset < Length)
+	{
+		if (!Decoder.DecodeInstruction(Data + Offset, Available - Offset, Instruction))
+		{
+			RangeStats.DecodeFailures++;
+			Offset++;
+			continue;
+		}
+
+		RangeStats.Instructions++;
+		const uintptr_t Address = Range.Start + Offset;
+
+		for (ZyanU8 i = 0; i < Instruction.operand_count; i++)
+		{
+			uintptr_t Target = 0;
+			if (!GetOperandTarget(Instruction, Instruction.operands[i], Address, Target))
+			{
+				continue;
+			}
+
+			const uint32_t TargetIndex = Targets.Find(Target);
+			if (TargetIndex != FAddressIndex::InvalidIndex)
+			{
+				Results.push_back({ Address, Target, TargetIndex, Instruction.length });
+				break;
+			}
+		}
+
+		Offset += Instruction.length;
+	}
+
+	RangeStats.BytesDecoded += Length;
+}
+
+namespace
+{
+	// what the decoder knows about a general purpose register while sweeping a function
+	struct FRegisterState
+	{
+		enum class EKind : uint8_t
+		{
+			Unknown,
+			This, // this pointer of the virtual function being decoded
+			VTable, // loaded from offset 0 of an object
+			Slot // loaded from a vtable slot
+		};
+
+		EKind Kind = EKind::Unknown;
+		bool bBound = false; // the vtable was loaded from this
+		uint32_t Slot = 0;
+	};
+
+	constexpr size_t NumGeneralRegisters = sizeof(uintptr_t) == 8 ? 16 : 8;
+	constexpr ZydisMachineMode MachineMode = sizeof(uintptr_t) == 8 ? ZYDIS_MACHINE_MODE_LONG_64 : ZYDIS_MACHINE_MODE_LEGACY_32;
+	constexpr ZydisRegister FirstGeneralRegister = sizeof(uintptr_t) == 8 ? ZYDIS_REGISTER_RAX : ZYDIS_REGISTER_EAX;
+	constexpr size_t ThisRegister = 1; // rcx / ecx, thiscall on x86 and the first argument on x64
+
+	// index into the register state of the full width register containing Register, NumGeneralRegisters if it is not a GPR
+	size_t GetRegisterIndex(ZydisRegister Register)
+	{
+		if (Register == ZYDIS_REGISTER_NONE)
+		{
+			return NumGeneralRegisters;
+		}
+
+		const int Index = static_cast<int>(ZydisRegisterGetLargestEnclosing(MachineMode, Register)) - static_cast<int>(FirstGeneralRegister);
+		return Index >= 0 && Index < static_cast<int>(NumGeneralRegisters) ? static_cast<size_t>(Index) : NumGeneralRegisters;
+	}
+
+	bool IsVolatileRegister(size_t Index)
+	{
+		// rax rcx rdx r8-r11 on x64, eax ecx edx on x86
+		if constexpr (sizeof(uintptr_t) == 8)
+		{
+			return Index <= 2 || (Index >= 8 && Index <= 11);
+		}
+		else
+		{
+			return Index <= 2;
+		}
+	}
+}
+
+void FCodeScanner::DecodeVirtualCalls(const FMemoryRange& Range, const FAddressIndex& FunctionStarts, std::vector<FVirtualCall>& Results, FCodeScanStats& RangeStats) const
+{
+	using EKind = FRegisterState::EKind;
+
+	const FMemoryBlock* Block = FindBlock(Range.Start);
+	if (!Block)
+	{
+		return;
+	}
+
+	const uintptr_t BlockStart = reinterpret_cast<uintptr_t>(Block->Address);
+	const uint8_t* Data = Block->Copy.data() + (Range.Start - BlockStart);
+	const size_t Length = std::min<size_t>(Range.End, BlockStart + Block->Size) - Range.Start;
+	const size_t Available = BlockStart + Block->Size - Range.Start;
+
+	FRegisterState Registers[NumGeneralRegisters + 1]; // the last entry absorbs writes to anything that is not a GPR
+	uint32_t Caller = FAddressIndex::InvalidIndex;
+
+	auto ResetRegisters = [&]()
+		{
+			for (FRegisterState& Register : Registers)
+			{
+				Register = FRegisterState();
+			}
+		};
+
+	// slot of [reg + disp] when reg holds a vtable
+	auto GetSlotOperand = [&](const ZydisDecodedOperand& Operand, FRegisterState& OutState)
+		{
+			if (Operand.type != ZYDIS_OPERAND_TYPE_MEMORY || Operand.mem.index != ZYDIS_REGISTER_NONE || Operand.mem.disp.value < 0 || Operand.mem.disp.value % sizeof(uintptr_t) != 0)
+			{
+				return false;
+			}
+
+			const FRegisterState& Base = Registers[GetRegisterIndex(Operand.mem.base)];
+			if (Base.Kind != EKind::VTable)
+			{
+				return false;
+			}
+
+			OutState.Kind = EKind::Slot;
+			OutState.bBound = Base.bBound;
+			OutState.Slot = static_cast<uint32_t>(Operand.mem.disp.value / sizeof(uintptr_t));
+			return true;
+		};
+
+	auto AddCall = [&](uintptr_t Address, const FRegisterState& Target)
+		{
+			Results.push_back({ Address, Target.Slot, Target.bBound ? Caller : FAddressIndex::InvalidIndex });
+		};
+
+	ZydisDecodedInstruction Instruction;
+	size_t Offset = 0;
+
+	while (Offset < Length)
+	{
+		const uintptr_t Address = Range.Start + Offset;
+
+		// entering a known virtual function, its first argument is an object of the classes that use it
+		const uint32_t FunctionIndex = FunctionStarts.Find(Address);
+		if (FunctionIndex != FAddressIndex::InvalidIndex)
+		{
+			ResetRegisters();
+			Caller = FunctionIndex;
+			Registers[ThisRegister].Kind = EKind::This;
+		}
+
+		if (!Decoder.DecodeInstruction(Data + Offset, Available - Offset, Instruction))
+		{
+			RangeStats.DecodeFailures++;
+			ResetRegisters();
+			Caller = FAddressIndex::InvalidIndex;
+			Offset++;
+			continue;
+		}
+
+		RangeStats.Instructions++;
+		Offset += Instruction.length;
+
+		const ZydisDecodedOperand& Destination = Instruction.operands[0];
+		const ZydisDecodedOperand& Source = Instruction.operands[1];
+
+		switch (Instruction.mnemonic)
+		{
+		case ZYDIS_MNEMONIC_CALL:
+		case ZYDIS_MNEMONIC_JMP:
+		{
+			FRegisterState Target;
+			if (GetSlotOperand(Destination, Target))
+			{
+				// call [rax + disp]
+				AddCall(Address, Target);
+			}
+			else if (Destination.type == ZYDIS_OPERAND_TYPE_REGISTER && Registers[GetRegisterIndex(Destination.reg.value)].Kind == EKind::Slot)
+			{
+				// mov rax, [rax + disp] / call rax
+				AddCall(Address, Registers[GetRegisterIndex(Destination.reg.value)]);
+			}
+			else if (Instruction.mnemonic == ZYDIS_MNEMONIC_CALL && Destination.type == ZYDIS_OPERAND_TYPE_MEMORY
+				&& (Destination.mem.base == ZYDIS_REGISTER_RIP || Destination.mem.base == ZYDIS_REGISTER_NONE)
+				&& Registers[0].Kind == EKind::Slot)
+			{
+				// control flow guard: the target is in rax when calling __guard_dispatch_icall_fptr
+				AddCall(Address, Registers[0]);
+			}
+
+			if (Instruction.mnemonic == ZYDIS_MNEMONIC_JMP)
+			{
+				// the next instruction is reached from somewhere else, only this tends to survive in a callee saved register
+				for (FRegisterState& Register : Registers)
+				{
+					Register = Register.Kind == EKind::This ? Register : FRegisterState();
+				}
+
+				// an indirect jump or tail call leaves the function
+				if (Destination.type != ZYDIS_OPERAND_TYPE_IMMEDIATE)
+				{
+					ResetRegisters();
+					Caller = FAddressIndex::InvalidIndex;
+				}
+			}
+			else if (Instruction.mnemonic == ZYDIS_MNEMONIC_CALL)
+			{
+				for (size_t i = 0; i < NumGeneralRegisters; i++)
+				{
+					if (IsVolatileRegister(i))
+					{
+						Registers[i] = FRegisterState();
+					}
+				}
+			}
+			continue;
+		}
+		case ZYDIS_MNEMONIC_RET:
+		case ZYDIS_MNEMONIC_INT3:
+			ResetRegisters();
+			Caller = FAddressIndex::InvalidIndex;
+			continue;
+		case ZYDIS_MNEMONIC_MOV:
+		{
+			if (Destination.type != ZYDIS_OPERAND_TYPE_REGISTER || GetRegisterIndex(Destination.reg.value) == NumGeneralRegisters)
+			{
+				break;
+			}
+
+			FRegisterState& Register = Registers[GetRegisterIndex(Destination.reg.value)];
+			FRegisterState Loaded;
+
+			if (Source.type == ZYDIS_OPERAND_TYPE_REGISTER)
+			{
+				// mov rbx, rcx keeps this alive across calls
+				Loaded = Registers[GetRegisterIndex(Source.reg.value)];
+			}
+			else if (Source.type == ZYDIS_OPERAND_TYPE_MEMORY && !GetSlotOperand(Source, Loaded)
+				&& Source.mem.index == ZYDIS_REGISTER_NONE && Source.mem.disp.value == 0
+				&& Source.mem.segment != ZYDIS_REGISTER_FS && Source.mem.segment != ZYDIS_REGISTER_GS
+				&& GetRegisterIndex(Source.mem.base) != NumGeneralRegisters)
+			{
+				// mov rax, [rcx], any object may be behind the base register
+				Loaded.Kind = EKind::VTable;
+				Loaded.bBound = Registers[GetRegisterIndex(Source.mem.base)].Kind == EKind::This;
+			}
+
+			Register = Loaded;
+			continue;
+		}
+		default:
+			break;
+		}
+
+		for (ZyanU8 i = 0; i < Instruction.operand_count; i++)
+		{
+			const ZydisDecodedOperand& Operand = Instruction.operands[i];
+			if (Operand.type == ZYDIS_OPERAND_TYPE_REGISTER && (Operand.actions & ZYDIS_OPERAND_ACTION_MASK_WRITE))
+			{
+				Registers[GetRegisterIndex(Operand.reg.value)] = FRegisterState();
+			}
+		}
+	}
+
+	RangeStats.BytesDecoded += Length;
+}
+
+void FCodeScanner::DecodeVTableStores(const FMemoryRange& Range, const FAddressIndex& VTables, const FAddressIndex& FunctionStarts, std::vector<FVTableStore>& Results, FCodeScanStats& RangeStats) const
+{
+	const FMemoryBlock* Block = FindBlock(Range.Start);
+	if (!Block)
+	{
+		return;
+	}
+
+	const uintptr_t BlockStart = reinterpret_cast<uintptr_t>(Block->Address);
+	const uint8_t* Data = Block->Copy.data() + (Range.Start - BlockStart);
+	const size_t Length = std::min<size_t>(Range.End, BlockStart + Block->Size) - Range.Start;
+	const size_t Available = BlockStart + Block->Size - Range.Start;
+
+	// vtable index held by every general purpose register, the last entry absorbs everything else
+	uint32_t Registers[NumGeneralRegisters + 1];
+	std::fill(std::begin(Registers), std::end(Registers), FAddressIndex::InvalidIndex);
+
+	uintptr_t Function = Range.Start;
+	bool bAfterPadding = false;
+
+	ZydisDecodedInstruction Instruction;
+	size_t Offset = 0;
+
+	while (Offset < Length)
+	{
+		const uintptr_t Address = Range.Start + Offset;
+
+		if (!Decoder.DecodeInstruction(Data + Offset, Available - Offset, Instruction))
+		{
+			RangeStats.DecodeFailures++;
+			Offset++;
+			continue;
+		}
+
+		RangeStats.Instructions++;
+		Offset += Instruction.length;
+
+		if (Instruction.mnemonic == ZYDIS_MNEMONIC_INT3)
+		{
+			bAfterPadding = true;
+			continue;
+		}
+
+		// a new function starts after int3 padding or at a known virtual function
+		if (bAfterPadding || FunctionStarts.Find(Address) != FAddressIndex::InvalidIndex)
+		{
+			std::fill(std::begin(Registers), std::end(Registers), FAddressIndex::InvalidIndex);
+			Function = Address;
+			bAfterPadding = false;
+		}
+
+		const ZydisDecodedOperand& Destination = Instruction.operands[0];
+		const ZydisDecodedOperand& Source = Instruction.operands[1];
+
+		// lea rax, [rip + vtable] / mov eax, offset vtable
+		if ((Instruction.mnemonic == ZYDIS_MNEMONIC_LEA || (Instruction.mnemonic == ZYDIS_MNEMONIC_MOV && Source.type == ZYDIS_OPERAND_TYPE_IMMEDIATE))
+			&& Destination.type == ZYDIS_OPERAND_TYPE_REGISTER)
+		{
+			uintptr_t Target = 0;
+			const bool bTarget = GetOperandTarget(Instruction, Source, Address, Target);
+			Registers[GetRegisterIndex(Destination.reg.value)] = bTarget ? VTables.Find(Target) : FAddressIndex::InvalidIndex;
+			continue;
+		}
+
+		// mov [rcx + disp], rax / mov dword ptr [ecx + disp], offset vtable
+		if (Instruction.mnemonic == ZYDIS_MNEMONIC_MOV && Destination.type == ZYDIS_OPERAND_TYPE_MEMORY
+			&& Destination.mem.index == ZYDIS_REGISTER_NONE && GetRegisterIndex(Destination.mem.base) != NumGeneralRegisters
+			&& Destination.size == sizeof(uintptr_t) * 8)
+		{
+			uint32_t VTableIndex = FAddressIndex::InvalidIndex;
+			if (Source.type == ZYDIS_OPERAND_TYPE_REGISTER)
+			{
+				VTableIndex = Registers[GetRegisterIndex(Source.reg.value)];
+			}
+			else if (Source.type == ZYDIS_OPERAND_TYPE_IMMEDIATE && !Source.imm.is_relative)
+			{
+				VTableIndex = VTables.Find(static_cast<uintptr_t>(Source.imm.value.u));
+			}
+
+			if (VTableIndex != FAddressIndex::InvalidIndex)
+			{
+				Results.push_back({ Address, Function, VTableIndex, static_cast<int32_t>(Destination.mem.disp.value) });
+			}
+			continue;
+		}
+
+		if (Instruction.mnemonic == ZYDIS_MNEMONIC_CALL)
+		{
+			for (size_t i = 0; i < NumGeneralRegisters; i++)
+			{
+				Registers[i] = IsVolatileRegister(i) ? FAddressIndex::InvalidIndex : Registers[i];
+			}
+			continue;
+		}
+
+		for (ZyanU8 i = 0; i < Instruction.operand_count; i++)
+		{
+			const ZydisDecodedOperand& Operand = Instruction.operands[i];
+			if (Operand.type == ZYDIS_OPERAND_TYPE_REGISTER && (Operand.actions & ZYDIS_OPERAND_ACTION_MASK_WRITE))
+			{
+				Registers[GetRegisterIndex(Operand.reg.value)] = FAddressIndex::InvalidIndex;
+			}
+		}
+	}
+
+	RangeStats.BytesDecoded += Length;
+}
+
+void FCodeScanner::DecodeAllocationSites(const FMemoryRange& Range, const FAddressIndex& Constructors, std::vector<FAllocationSite>& Results, FCodeScanStats& RangeStats) const
+{
+	// larger immediates are not object sizes
+	constexpr uint64_t MaxObjectSize = 0x100000;
+
+	struct FValue
+	{
+		enum class EKind : uint8_t
+		{
+			Unknown,
+			Immediate, // small constant, a possible allocation size
+			Allocation // result of a call that was passed an immediate size
+		};
+
+		EKind Kind = EKind::Unknown;
+		uint32_t Size = 0;
+	};
+	using EKind = FValue::EKind;
+
+	const FMemoryBlock* Block = FindBlock(Range.Start);
+	if (!Block)
+	{
+		return;
+	}
+
+	const uintptr_t BlockStart = reinterpret_cast<uintptr_t>(Block->Address);
+	const uint8_t* Data = Block->Copy.data() + (Range.Start - BlockStart);
+	const size_t Length = std::min<size_t>(Range.End, BlockStart + Block->Size) - Range.Start;
+	const size_t Available = BlockStart + Block->Size - Range.Start;
+
+	FValue Registers[NumGeneralRegisters + 1];
+	FValue LastPush; // x86 passes the size of operator new on the stack
+
+	auto Reset = [&]()
+		{
+			std::fill(std::begin(Registers), std::end(Registers), FValue());
+			LastPush = FValue();
+		};
+
+	ZydisDecodedInstruction Instruction;
+	size_t Offset = 0;
+
+	while (Offset < Length)
+	{
+		const uintptr_t Address = Range.Start + Offset;
+
+		if (!Decoder.DecodeInstruction(Data + Offset, Available - Offset, Instruction))
+		{
+			RangeStats.DecodeFailures++;
+			Reset();
+			Offset++;
+			continue;
+		}
+
+		RangeStats.Instructions++;
+		Offset += Instruction.length;
+
+		const ZydisDecodedOperand& Destination = Instruction.operands[0];
+		const ZydisDecodedOperand& Source = Instruction.operands[1];
+
+		switch (Instruction.mnemonic)
+		{
+		case ZYDIS_MNEMONIC_CALL:
+		{
+			const FValue This = Registers[ThisRegister];
+			const FValue Argument = sizeof(uintptr_t) == 8 ? Registers[ThisRegister] : LastPush;
+
+			uintptr_t Callee = 0;
+			if (Destination.type == ZYDIS_OPERAND_TYPE_IMMEDIATE && Destination.imm.is_relative)
+			{
+				ZyanU64 Absolute = 0;
+				if (ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(&Instruction, &Destination, Address, &Absolute)))
+				{
+					Callee = static_cast<uintptr_t>(Absolute);
+				}
+			}
+
+			const uint32_t ConstructorIndex = Callee ? Constructors.Find(Callee) : FAddressIndex::InvalidIndex;
+			if (ConstructorIndex != FAddressIndex::InvalidIndex && This.Kind == EKind::Allocation)
+			{
+				Results.push_back({ Address, ConstructorIndex, This.Size });
+			}
+
+			for (size_t i = 0; i < NumGeneralRegisters; i++)
+			{
+				Registers[i] = IsVolatileRegister(i) ? FValue() : Registers[i];
+			}
+			LastPush = FValue();
+
+			// any call that was handed an immediate may be the allocator, the constructor call decides
+			if (ConstructorIndex == FAddressIndex::InvalidIndex && Argument.Kind == EKind::Immediate)
+			{
+				Registers[0] = { EKind::Allocation, Argument.Size };
+			}
+			continue;
+		}
+		case ZYDIS_MNEMONIC_PUSH:
+			LastPush = FValue();
+			if (Destination.type == ZYDIS_OPERAND_TYPE_IMMEDIATE && Destination.imm.value.u > 0 && Destination.imm.value.u <= MaxObjectSize)
+			{
+				LastPush = { EKind::Immediate, static_cast<uint32_t>(Destination.imm.value.u) };
+			}
+			continue;
+		case ZYDIS_MNEMONIC_MOV:
+			if (Destination.type == ZYDIS_OPERAND_TYPE_REGISTER && GetRegisterIndex(Destination.reg.value) != NumGeneralRegisters)
+			{
+				FValue& Register = Registers[GetRegisterIndex(Destination.reg.value)];
+				if (Source.type == ZYDIS_OPERAND_TYPE_IMMEDIATE && Source.imm.value.u > 0 && Source.imm.value.u <= MaxObjectSize)
+				{
+					Register = { EKind::Immediate, static_cast<uint32_t>(Source.imm.value.u) };
+				}
+				else if (Source.type == ZYDIS_OPERAND_TYPE_REGISTER)
+				{
+					Register = Registers[GetRegisterIndex(Source.reg.value)];
+				}
+				else
+				{
+					Register = FValue();
+				}
+				continue;
+			}
+			break;
+		case ZYDIS_MNEMONIC_RET:
+		case ZYDIS_MNEMONIC_INT3:
+			Reset();
+			continue;
+		case ZYDIS_MNEMONIC_JMP:
+			// the null check after the allocation branches over the constructor call, only leaving the function resets
+			if (Destination.type != ZYDIS_OPERAND_TYPE_IMMEDIATE)
+			{
+				Reset();
+				continue;
+			}
+			break;
+		default:
+			break;
+		}
+
+		for (ZyanU8 i = 0; i < Instruction.operand_count; i++)
+		{
+			const ZydisDecodedOperand& Operand = Instruction.operands[i];
+			if (Operand.type == ZYDIS_OPERAND_TYPE_REGISTER && (Operand.actions & ZYDIS_OPERAND_ACTION_MASK_WRITE))
+			{
+				Registers[GetRegisterIndex(Operand.reg.value)] = FValue();
+			}
+		}
+	}
+
+	RangeStats.BytesDecoded += Length;
+}
+
+bool FCodeScanner::GetOperandTarget(const ZydisDecodedInstruction& Instruction, const ZydisDecodedOperand& Operand, uintptr_t Address, uintptr_t& OutTarget)
+{
+	switch (Operand.type)
+	{
+	case ZYDIS_OPERAND_TYPE_MEMORY:
+	{
+		// lea reg, [rip + disp] / mov reg, [rip + disp]
+		if (Operand.mem.base == ZYDIS_REGISTER_RIP || Operand.mem.base == ZYDIS_REGISTER_EIP)
+		{
+			ZyanU64 Absolute = 0;
+			if (!ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(&Instruction, &Operand, Address, &Absolute)))
+			{
+				return false;
+			}
+
+			OutTarget = static_cast<uintptr_t>(Absolute);
+			return true;
+		}
+
+		// mov reg, [disp32] on x86
+		if (Operand.mem.base == ZYDIS_REGISTER_NONE && Operand.mem.index == ZYDIS_REGISTER_NONE && Operand.mem.disp.has_displacement)
+		{
+			OutTarget = static_cast<uintptr_t>(Operand.mem.disp.value);
+			return true;
+		}
+
+		return false;
+	}
+	case ZYDIS_OPERAND_TYPE_IMMEDIATE:
+	{
+		// relative immediates are branch targets
+		if (Operand.imm.is_relative)
+		{
+			return false;
+		}
+
+		// mov dword ptr [ecx], offset vtable / push offset vtable / movabs
+		OutTarget = static_cast<uintptr_t>(Operand.imm.value.u);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "Memory.h"
+#include "Disassembler.h"
+#include "PEImage.h"
+#include "../Util/AddressIndex.h"
+
+// ---------------------------------------------
+// Code Scanner
+// ---------------------------------------------
+
+struct FCodeReference
+{
+	uintptr_t Instruction = 0; // address of the referencing instruction
+	uintptr_t Target = 0; // address the instruction loads
+	uint32_t TargetIndex = FAddressIndex::InvalidIndex; // value stored for Target in the index
+	uint8_t Length = 0; // length of the referencing instruction
+};
+
+struct FVirtualCall
+{
+	uintptr_t Instruction = 0; // address of the indirect call
+	uint32_t Slot = 0; // vtable slot index called
+	uint32_t Caller = FAddressIndex::InvalidIndex; // virtual function whose this pointer the vtable was loaded from, if any
+};
+
+struct FVTableStore
+{
+	uintptr_t Instruction = 0; // address of the store
+	uintptr_t Function = 0; // start of the containing function as far as a linear sweep can tell
+	uint32_t VTableIndex = FAddressIndex::InvalidIndex; // value stored for the vtable in the index
+	int32_t Offset = 0; // displacement of the store from its base register
+};
+
+struct FAllocationSite
+{
+	uintptr_t Instruction = 0; // call of the constructor
+	uint32_t ConstructorIndex = FAddressIndex::InvalidIndex; // value stored for the constructor in the index
+	uint32_t Size = 0; // immediate size passed to the allocation whose result is constructed
+};
+
+struct FCodeScanStats
+{
+	uint64_t BytesLoaded = 0;
+	uint64_t BytesDecoded = 0;
+	uint64_t Instructions = 0;
+	uint64_t DecodeFailures = 0; // bytes skipped because no instruction could be decoded there
+	uint64_t WorkRanges = 0;
+	uint64_t LoadNs = 0;
+	uint64_t DecodeNs = 0;
+};
+
+/**
+ * Finds the instructions that reference a set of addresses by decoding executable code, instead of
+ * treating every byte offset as a possible displacement. The code is copied once and split into work
+ * ranges that start right after the int3 padding between functions, so every range begins on an
+ * instruction boundary. Ranges are linearly decoded in parallel; RIP relative and absolute memory
+ * operands and immediates are evaluated and looked up in the target index.
+ * On x86 every absolute address in code carries a base relocation, so the fixup sites of the image give the
+ * same references without decoding anything but the instruction around each site.
+ */
+class FCodeScanner
+{
+public:
+	explicit FCodeScanner(FTargetProcess* InProcess);
+
+	// copies the given ranges into local buffers, returns false if nothing was loaded
+	bool LoadRanges(const std::vector<FMemoryRange>& Ranges);
+
+	// splits the loaded code into ranges of at least MinSize bytes, cut after int3 padding
+	std::vector<FMemoryRange> SplitAtPadding(size_t MinSize = 0x10000) const;
+
+	// decodes the work ranges on NumThreads threads (0 = hardware concurrency), results are sorted by instruction
+	std::vector<FCodeReference> FindReferences(const FAddressIndex& Targets, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads = 0);
+	std::vector<FCodeReference> FindReferences(const FAddressIndex& Targets);
+
+	// indirect calls through a vtable slot, FunctionStarts maps virtual function addresses to their index
+	// so calls through the vtable of this inside a known virtual function are bound to that function
+	std::vector<FVirtualCall> FindVirtualCalls(const FAddressIndex& FunctionStarts, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads = 0);
+	std::vector<FVirtualCall> FindVirtualCalls(const FAddressIndex& FunctionStarts);
+
+	// stores of a vtable address into [reg] or [reg + disp], the writes constructors and destructors make
+	std::vector<FVTableStore> FindVTableStores(const FAddressIndex& VTables, const FAddressIndex& FunctionStarts, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads = 0);
+	std::vector<FVTableStore> FindVTableStores(const FAddressIndex& VTables, const FAddressIndex& FunctionStarts);
+
+	// "allocate an immediate size, then construct the result" sequences, Constructors maps constructor addresses to an index
+	std::vector<FAllocationSite> FindAllocationSites(const FAddressIndex& Constructors, const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads = 0);
+	std::vector<FAllocationSite> FindAllocationSites(const FAddressIndex& Constructors);
+
+	// targets of the direct calls and tail jumps of one function, Size 0 decodes up to the first ret
+	std::vector<uintptr_t> FindDirectCallees(uintptr_t Function, size_t Size) const;
+
+	// exact references from the fixup sites of a 32 bit image, only the loaded code of the image is looked at
+	std::vector<FCodeReference> FindRelocatedReferences(const FAddressIndex& Targets, const FPEImage& Image);
+
+	// local copy of [Address, Address + Size) when it lies inside one loaded block
+	const uint8_t* GetLocalCopy(uintptr_t Address, size_t Size) const;
+
+	// bytes of loaded code from Address to the end of its block, 0 if Address was not loaded
+	size_t GetLocalSize(uintptr_t Address) const;
+
+	const FCodeScanStats& GetStats() const { return Stats; }
+
+protected:
+	const FMemoryBlock* FindBlock(uintptr_t Address) const;
+	void DecodeRange(const FMemoryRange& Range, const FAddressIndex& Targets, std::vector<FCodeReference>& Results, FCodeScanStats& RangeStats) const;
+	void DecodeVirtualCalls(const FMemoryRange& Range, const FAddressIndex& FunctionStarts, std::vector<FVirtualCall>& Results, FCodeScanStats& RangeStats) const;
+	void DecodeVTableStores(const FMemoryRange& Range, const FAddressIndex& VTables, const FAddressIndex& FunctionStarts, std::vector<FVTableStore>& Results, FCodeScanStats& RangeStats) const;
+	void DecodeAllocationSites(const FMemoryRange& Range, const FAddressIndex& Constructors, std::vector<FAllocationSite>& Results, FCodeScanStats& RangeStats) const;
+	bool FindFixupInstruction(uintptr_t Site, ZydisDecodedInstruction& OutInstruction, uintptr_t& OutAddress) const;
+
+	// decodes the work ranges on a pool of threads, each worker collects its own results
+	template <typename FResult, typename FDecodeFunction>
+	std::vector<FResult> DecodeParallel(const std::vector<FMemoryRange>& WorkRanges, size_t NumThreads, FDecodeFunction&& Decode);
+
+	static bool GetOperandTarget(const ZydisDecodedInstruction& Instruction, const ZydisDecodedOperand& Operand, uintptr_t Address, uintptr_t& OutTarget);
+
+	FTargetProcess* Process = nullptr;
+	Disassembler Decoder; // only decodes after construction, shared between the worker threads
+	std::vector<FMemoryBlock> Blocks; // sorted by address
+	FCodeScanStats Stats;
+};
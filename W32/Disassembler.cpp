@@ -1,4 +1,5 @@
 #include "Disassembler.h"
+#include "../Util/Strings.h"
 #ifdef _WIN64
 Disassembler::Disassembler() {
     memset(&decoder, 0, sizeof(decoder));
@@ -32,20 +33,15 @@ std::vector<std::string> Disassembler::DecodeToString(uint8_t* instructionPointe
 {
     uint8_t* ip = instructionPointer;
     std::vector<std::string> instructions;
-    std::string s_instruction = "";
     uintptr_t offset = 0;
     ZydisDecodedInstruction instruction;
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeBuffer(&decoder, ip, length - offset, &instruction)))
+    while (offset < length && ZYAN_SUCCESS(ZydisDecoderDecodeBuffer(&decoder, ip, length - offset, &instruction)))
     {
-        //char buffer[256];
-        //ZydisFormatterFormatInstruction(
-        //    &formatter, &instruction, buffer, sizeof(buffer), (ZyanU64)ip);
-        //s_instruction += "0x" + IntegerToHexStr((uintptr_t)ip) + " | ";
-        //s_instruction += buffer;
-        //instructions.push_back(s_instruction);
-        //s_instruction = "";
-        //ip += instruction.length;
-        //offset += instruction.length;
+        char buffer[256];
+        FormatInstruction(instruction, (uintptr_t)ip, buffer, sizeof(buffer));
+        instructions.push_back("0x" + IntegerToHexStr((uintptr_t)ip) + " | " + buffer);
+        ip += instruction.length;
+        offset += instruction.length;
     }
     return instructions;
 }
@@ -56,7 +52,7 @@ std::vector<ZydisDecodedInstruction> Disassembler::Decode(uint8_t* instructionPo
     std::vector<ZydisDecodedInstruction> instructions;
     uintptr_t offset = 0;
     ZydisDecodedInstruction instruction;
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeBuffer(&decoder, ip, length - offset, &instruction)))
+    while (offset < length && ZYAN_SUCCESS(ZydisDecoderDecodeBuffer(&decoder, ip, length - offset, &instruction)))
     {
         instructions.push_back(instruction);
         ip += instruction.length;
@@ -65,21 +61,30 @@ std::vector<ZydisDecodedInstruction> Disassembler::Decode(uint8_t* instructionPo
     return instructions;
 }
 
-size_t Disassembler::GetFunctionSize(uintptr_t functionAddress)
+bool Disassembler::DecodeInstruction(const uint8_t* buffer, size_t length, ZydisDecodedInstruction& instruction) const
+{
+    return length > 0 && ZYAN_SUCCESS(ZydisDecoderDecodeBuffer(&decoder, buffer, length, &instruction));
+}
+
+bool Disassembler::FormatInstruction(const ZydisDecodedInstruction& instruction, uintptr_t runtimeAddress, char* buffer, size_t length) const
+{
+    if (!ZYAN_SUCCESS(ZydisFormatterFormatInstruction(&formatter, &instruction, buffer, length, runtimeAddress)))
+    {
+        snprintf(buffer, length, "db ??");
+        return false;
+    }
+    return true;
+}
+
+size_t Disassembler::GetFunctionSize(const uint8_t* buffer, size_t length) const
 {
-    const size_t maxLength = 4096;
     size_t funcSize = 0;
-    uint8_t* ip = (uint8_t*)functionAddress;
-    uintptr_t offset = 0;
     ZydisDecodedInstruction instruction;
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeBuffer(&decoder, ip, maxLength - offset, &instruction)))
+    while (funcSize < length && ZYAN_SUCCESS(ZydisDecoderDecodeBuffer(&decoder, buffer + funcSize, length - funcSize, &instruction)))
     {
-        ip += instruction.length;
-        offset += instruction.length;
         funcSize += instruction.length;
         if (instruction.mnemonic == ZYDIS_MNEMONIC_RET) break;
         if (instruction.mnemonic == ZYDIS_MNEMONIC_INT3) break;
     }
     return funcSize;
-
 }
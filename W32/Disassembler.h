@@ -14,6 +14,9 @@ public:
 	Disassembler();
 	std::vector<std::string> DecodeToString(uint8_t* instructionPointer, size_t length);
 	std::vector<ZydisDecodedInstruction> Decode(uint8_t* instructionPointer, size_t length);
-	size_t GetFunctionSize(uintptr_t functionAddress);
+	bool DecodeInstruction(const uint8_t* buffer, size_t length, ZydisDecodedInstruction& instruction) const;
+	bool FormatInstruction(const ZydisDecodedInstruction& instruction, uintptr_t runtimeAddress, char* buffer, size_t length) const;
+	// linear sweep up to the first ret or int3, only a guess when no unwind data is available
+	size_t GetFunctionSize(const uint8_t* buffer, size_t length) const;
 };
 
@@ -0,0 +1,162 @@
+#include "DisassemblyCache.h"
+#include <thread>
+#include "../Util/ThreadPool.h"
+
+size_t FFunctionListing::GetMemoryUsage() const
+{
+	return sizeof(FFunctionListing)
+		+ LineOffsets.capacity() * sizeof(uint32_t)
+		+ TextOffsets.capacity() * sizeof(uint32_t)
+		+ Text.capacity();
+}
+
+FDisassemblyCache::FDisassemblyCache(FTargetProcess* InProcess, size_t InMaxBytes, size_t NumThreads)
+	: Process(InProcess), Code(InProcess), MaxBytes(InMaxBytes)
+{
+	if (NumThreads == 0)
+	{
+		// leave a core for the GUI and the scanners
+		NumThreads = std::max<size_t>(std::thread::hardware_concurrency() / 2, 1);
+	}
+
+	Workers = std::make_unique<ThreadPool>(NumThreads);
+}
+
+FDisassemblyCache::~FDisassemblyCache()
+{
+	Workers.reset();
+}
+
+bool FDisassemblyCache::LoadCode(const std::vector<FMemoryRange>& Ranges)
+{
+	return Code.LoadRanges(Ranges);
+}
+
+void FDisassemblyCache::Request(uintptr_t Address, size_t Size)
+{
+	{
+		std::scoped_lock Lock(Mutex);
+		if (Listings.contains(Address) || !Pending.insert(Address).second)
+		{
+			return;
+		}
+	}
+
+	Workers->enqueue([this, Address, Size]
+		{
+			Insert(DecodeFunction(Address, Size));
+		});
+}
+
+std::shared_ptr<const FFunctionListing> FDisassemblyCache::Find(uintptr_t Address)
+{
+	std::scoped_lock Lock(Mutex);
+
+	auto it = Listings.find(Address);
+	if (it == Listings.end())
+	{
+		return nullptr;
+	}
+
+	Recent.splice(Recent.begin(), Recent, it->second);
+	return *it->second;
+}
+
+bool FDisassemblyCache::IsPending(uintptr_t Address)
+{
+	std::scoped_lock Lock(Mutex);
+	return Pending.contains(Address);
+}
+
+size_t FDisassemblyCache::GetMemoryUsage()
+{
+	std::scoped_lock Lock(Mutex);
+	return UsedBytes;
+}
+
+size_t FDisassemblyCache::GetNumCached()
+{
+	std::scoped_lock Lock(Mutex);
+	return Listings.size();
+}
+
+std::shared_ptr<FFunctionListing> FDisassemblyCache::DecodeFunction(uintptr_t Address, size_t Size) const
+{
+	std::shared_ptr<FFunctionListing> Listing = std::make_shared<FFunctionListing>();
+	Listing->Address = Address;
+
+	size_t ReadSize = Size ? std::min(Size, MaxFunctionSize) : UnknownSizeLimit;
+
+	// a function near the end of a section has less loaded code after it than the limit
+	const size_t LoadedSize = Code.GetLocalSize(Address);
+	if (LoadedSize > 0)
+	{
+		ReadSize = std::min(ReadSize, LoadedSize);
+	}
+
+	std::vector<uint8_t> Remote;
+	const uint8_t* Data = LoadedSize > 0 ? Code.GetLocalCopy(Address, ReadSize) : nullptr;
+	if (!Data)
+	{
+		// outside of the loaded code, imported or in another module
+		Remote.resize(ReadSize);
+		Process->Read(Address, Remote.data(), Remote.size());
+		Data = Remote.data();
+	}
+
+	Listing->Size = Size ? ReadSize : Decoder.GetFunctionSize(Data, ReadSize);
+	Listing->bTruncated = Size > ReadSize;
+	Listing->TextOffsets.push_back(0);
+
+	char Buffer[256];
+	size_t Offset = 0;
+	ZydisDecodedInstruction Instruction;
+
+	while (Offset < Listing->Size)
+	{
+		Listing->LineOffsets.push_back(static_cast<uint32_t>(Offset));
+
+		if (!Decoder.DecodeInstruction(Data + Offset, Listing->Size - Offset, Instruction))
+		{
+			snprintf(Buffer, sizeof(Buffer), "db 0x%02X", Data[Offset]);
+			Listing->Text += Buffer;
+			Listing->TextOffsets.push_back(static_cast<uint32_t>(Listing->Text.size()));
+			Offset++;
+			continue;
+		}
+
+		Decoder.FormatInstruction(Instruction, Address + Offset, Buffer, sizeof(Buffer));
+		Listing->Text += Buffer;
+		Listing->TextOffsets.push_back(static_cast<uint32_t>(Listing->Text.size()));
+		Offset += Instruction.length;
+	}
+
+	Listing->LineOffsets.shrink_to_fit();
+	Listing->TextOffsets.shrink_to_fit();
+	Listing->Text.shrink_to_fit();
+	return Listing;
+}
+
+void FDisassemblyCache::Insert(std::shared_ptr<const FFunctionListing> Listing)
+{
+	std::scoped_lock Lock(Mutex);
+
+	Pending.erase(Listing->Address);
+	if (Listings.contains(Listing->Address))
+	{
+		return;
+	}
+
+	UsedBytes += Listing->GetMemoryUsage();
+	Recent.push_front(Listing);
+	Listings[Listing->Address] = Recent.begin();
+
+	// never evict the listing that was just decoded, it is about to be looked at
+	while (UsedBytes > MaxBytes && Recent.size() > 1)
+	{
+		const std::shared_ptr<const FFunctionListing>& Oldest = Recent.back();
+		UsedBytes -= Oldest->GetMemoryUsage();
+		Listings.erase(Oldest->Address);
+		Recent.pop_back();
+	}
+}
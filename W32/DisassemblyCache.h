@@ -0,0 +1,81 @@
+#pragma once
+#include "CodeScanner.h"
+#include <list>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+class ThreadPool;
+
+// ---------------------------------------------
+// Disassembly Cache
+// ---------------------------------------------
+
+/**
+ * Decoded and formatted instructions of one function, immutable once built.
+ * Lines are stored back to back in one string so a listing costs little more than its text.
+ */
+struct FFunctionListing
+{
+	uintptr_t Address = 0;
+	size_t Size = 0; // bytes of code covered by the listing
+	bool bTruncated = false; // decoding stopped before Size bytes
+
+	std::vector<uint32_t> LineOffsets; // instruction address - Address
+	std::vector<uint32_t> TextOffsets; // start of every line in Text, plus the end of the last line
+	std::string Text;
+
+	size_t GetNumLines() const { return LineOffsets.size(); }
+	uintptr_t GetLineAddress(size_t Line) const { return Address + LineOffsets[Line]; }
+	std::string_view GetLineText(size_t Line) const { return std::string_view(Text).substr(TextOffsets[Line], TextOffsets[Line + 1] - TextOffsets[Line]); }
+	size_t GetMemoryUsage() const;
+};
+
+/**
+ * Decodes function bodies on worker threads from a local copy of the code and keeps the formatted
+ * listings in a least recently used cache bounded by memory. Requests for functions that are cached
+ * or already queued are ignored, so windows can request every frame.
+ * Listings are handed out as shared pointers; an evicted listing stays valid for whoever still holds it.
+ */
+class FDisassemblyCache
+{
+public:
+	static constexpr size_t DefaultMaxBytes = 64 * 1024 * 1024;
+	static constexpr size_t MaxFunctionSize = 0x10000; // longest body decoded for a single listing
+	static constexpr size_t UnknownSizeLimit = 0x1000; // bytes swept for the end of a function without unwind data
+
+	FDisassemblyCache(FTargetProcess* InProcess, size_t InMaxBytes = DefaultMaxBytes, size_t NumThreads = 0);
+	~FDisassemblyCache();
+
+	// copies the code ranges that listings are decoded from, functions outside of them are read from the process
+	bool LoadCode(const std::vector<FMemoryRange>& Ranges);
+
+	// queues the function for decoding, Size 0 decodes up to the first ret
+	void Request(uintptr_t Address, size_t Size);
+
+	// cached listing of the function, nullptr while it is not decoded yet
+	std::shared_ptr<const FFunctionListing> Find(uintptr_t Address);
+	bool IsPending(uintptr_t Address);
+
+	size_t GetMemoryUsage();
+	size_t GetNumCached();
+
+protected:
+	std::shared_ptr<FFunctionListing> DecodeFunction(uintptr_t Address, size_t Size) const;
+	void Insert(std::shared_ptr<const FFunctionListing> Listing);
+
+	FTargetProcess* Process = nullptr;
+	FCodeScanner Code; // local copy of the code
+	Disassembler Decoder; // shared between the workers, only decodes and formats after construction
+
+	std::mutex Mutex;
+	std::list<std::shared_ptr<const FFunctionListing>> Recent; // most recently used first
+	std::unordered_map<uintptr_t, std::list<std::shared_ptr<const FFunctionListing>>::iterator> Listings;
+	std::unordered_set<uintptr_t> Pending;
+	size_t MaxBytes = DefaultMaxBytes;
+	size_t UsedBytes = 0;
+
+	// declared last so queued work finishes before anything it touches is destroyed
+	std::unique_ptr<ThreadPool> Workers;
+};
@@ -0,0 +1,308 @@
+#include "FunctionHash.h"
+#include "../Util/BufferedWriter.h"
+#include "../Util/Hash.h"
+#include "../Util/Paths.h"
+#include "../Util/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+	// what an operand value was replaced with, part of the operand token
+	enum class EOperandValue : uint64_t
+	{
+		None,
+		Constant, // immediate kept as is, it follows the operand token
+		Relative, // branch or call target
+		Image, // immediate address inside the module
+		Masked // far pointer
+	};
+
+	constexpr uint64_t DecodeFailureToken = 0xFFFFFFFFFFFFFFFFull;
+}
+
+FFunctionHasher::FFunctionHasher(uintptr_t InImageStart, uintptr_t InImageEnd)
+	: ImageStart(InImageStart), ImageEnd(InImageEnd)
+{
+}
+
+void FFunctionHasher::AddInstruction(const ZydisDecodedInstruction& Instruction, std::vector<uint64_t>& Tokens) const
+{
+	// implicit operands follow from the mnemonic, hidden ones such as flags add nothing
+	uint64_t NumVisible = 0;
+	for (ZyanU8 i = 0; i < Instruction.operand_count; i++)
+	{
+		NumVisible += Instruction.operands[i].visibility != ZYDIS_OPERAND_VISIBILITY_HIDDEN;
+	}
+
+	Tokens.push_back(static_cast<uint64_t>(Instruction.mnemonic) | (NumVisible << 16));
+
+	for (ZyanU8 i = 0; i < Instruction.operand_count; i++)
+	{
+		const ZydisDecodedOperand& Operand = Instruction.operands[i];
+		if (Operand.visibility == ZYDIS_OPERAND_VISIBILITY_HIDDEN)
+		{
+			continue;
+		}
+
+		uint64_t Token = static_cast<uint64_t>(Operand.type) | (static_cast<uint64_t>(Operand.size) << 8);
+
+		switch (Operand.type)
+		{
+		case ZYDIS_OPERAND_TYPE_REGISTER:
+			Tokens.push_back(Token | (static_cast<uint64_t>(Operand.reg.value) << 32));
+			break;
+
+		case ZYDIS_OPERAND_TYPE_MEMORY:
+			// the displacement is dropped, whether there is one is not
+			Tokens.push_back(Token | (static_cast<uint64_t>(Operand.mem.type) << 32));
+			Tokens.push_back(static_cast<uint64_t>(Operand.mem.base)
+				| (static_cast<uint64_t>(Operand.mem.index) << 16)
+				| (static_cast<uint64_t>(Operand.mem.segment) << 32)
+				| (static_cast<uint64_t>(Operand.mem.scale) << 48)
+				| (static_cast<uint64_t>(Operand.mem.disp.has_displacement ? 1 : 0) << 56));
+			break;
+
+		case ZYDIS_OPERAND_TYPE_IMMEDIATE:
+			if (Operand.imm.is_relative)
+			{
+				// short and near encodings of the same branch differ in size, so only the kind is hashed
+				Tokens.push_back(static_cast<uint64_t>(Operand.type) | (static_cast<uint64_t>(EOperandValue::Relative) << 48));
+			}
+			else if (Operand.imm.value.u >= ImageStart && Operand.imm.value.u < ImageEnd)
+			{
+				Tokens.push_back(Token | (static_cast<uint64_t>(EOperandValue::Image) << 48));
+			}
+			else
+			{
+				Tokens.push_back(Token | (static_cast<uint64_t>(EOperandValue::Constant) << 48));
+				Tokens.push_back(Operand.imm.value.u);
+			}
+			break;
+
+		default:
+			Tokens.push_back(Token | (static_cast<uint64_t>(EOperandValue::Masked) << 48));
+			break;
+		}
+	}
+}
+
+uint64_t FFunctionHasher::Hash(const uint8_t* Body, size_t Size) const
+{
+	std::vector<uint64_t> Tokens;
+	Tokens.reserve(Size / 2);
+
+	size_t NumInstructions = 0;
+	size_t Offset = 0;
+	ZydisDecodedInstruction Instruction;
+
+	while (Offset < Size)
+	{
+		if (!Decoder.DecodeInstruction(Body + Offset, Size - Offset, Instruction))
+		{
+			// data in the middle of code, such as jump tables, hashed as an unknown byte
+			Tokens.push_back(DecodeFailureToken);
+			Offset++;
+			continue;
+		}
+
+		AddInstruction(Instruction, Tokens);
+		Offset += Instruction.length;
+		NumInstructions++;
+	}
+
+	if (NumInstructions == 0)
+	{
+		return 0;
+	}
+
+	// 0 means unknown
+	return FHash::Hash64(Tokens.data(), Tokens.size() * sizeof(uint64_t)) | 1;
+}
+
+size_t FFunctionHasher::HashAll(FFunctionTable& Table, const FCodeScanner& Code, size_t NumThreads) const
+{
+	constexpr size_t BatchSize = 256;
+
+	const size_t NumFunctions = Table.GetNumFunctions();
+	const size_t NumBatches = (NumFunctions + BatchSize - 1) / BatchSize;
+
+	auto HashBatch = [&](size_t Batch)
+	{
+		size_t NumHashed = 0;
+		const size_t End = std::min((Batch + 1) * BatchSize, NumFunctions);
+
+		for (uint32_t FunctionIndex = static_cast<uint32_t>(Batch * BatchSize); FunctionIndex < End; FunctionIndex++)
+		{
+			const uint32_t Size = Table.GetSize(FunctionIndex);
+			const uint8_t* Body = Size ? Code.GetLocalCopy(Table.GetAddress(FunctionIndex), Size) : nullptr;
+			const uint64_t FunctionHash = Body ? Hash(Body, Size) : 0;
+
+			// every function writes only its own entry, workers share nothing but the batch counter
+			Table.SetHash(FunctionIndex, FunctionHash);
+			NumHashed += FunctionHash != 0;
+		}
+
+		return NumHashed;
+	};
+
+	if (NumThreads == 0)
+	{
+		NumThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+	NumThreads = std::min(NumThreads, std::max<size_t>(NumBatches, 1));
+
+	std::atomic<size_t> NextBatch = 0;
+	std::atomic<size_t> NumHashed = 0;
+	{
+		ThreadPool Pool(NumThreads);
+
+		for (size_t i = 0; i < NumThreads; i++)
+		{
+			Pool.enqueue([&]()
+				{
+					size_t WorkerHashed = 0;
+					for (size_t Batch = NextBatch++; Batch < NumBatches; Batch = NextBatch++)
+					{
+						WorkerHashed += HashBatch(Batch);
+					}
+					NumHashed += WorkerHashed;
+				});
+		}
+	}
+
+	Table.BuildHashIndex();
+	return NumHashed;
+}
+
+std::string FFunctionAnnotations::GetPath(const std::string& ModuleName)
+{
+	const std::string Directory = GetAppDataDirectory("Annotations");
+	return Directory.empty() ? "" : Directory + "\\" + ModuleName + ".txt";
+}
+
+bool FFunctionAnnotations::Load(const std::string& Path)
+{
+	Names.clear();
+
+	HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		return GetLastError() == ERROR_FILE_NOT_FOUND;
+	}
+
+	LARGE_INTEGER FileSize = { 0 };
+	if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart >= 0x40000000)
+	{
+		CloseHandle(File);
+		return false;
+	}
+
+	std::string Text(static_cast<size_t>(FileSize.QuadPart), '\0');
+	DWORD BytesRead = 0;
+	const bool bRead = Text.empty() || (ReadFile(File, Text.data(), static_cast<DWORD>(Text.size()), &BytesRead, NULL) && BytesRead == Text.size());
+	CloseHandle(File);
+
+	if (!bRead)
+	{
+		return false;
+	}
+
+	// <hash in hex> <name>, lines that do not parse are skipped
+	std::string_view Remaining(Text);
+	while (!Remaining.empty())
+	{
+		const size_t LineEnd = std::min(Remaining.find('\n'), Remaining.size());
+		std::string_view Line = Remaining.substr(0, LineEnd);
+		Remaining.remove_prefix(std::min(LineEnd + 1, Remaining.size()));
+
+		if (!Line.empty() && Line.back() == '\r')
+		{
+			Line.remove_suffix(1);
+		}
+
+		uint64_t Hash = 0;
+		const std::from_chars_result Result = std::from_chars(Line.data(), Line.data() + Line.size(), Hash, 16);
+		if (Result.ec != std::errc() || Hash == 0 || Result.ptr == Line.data() + Line.size() || *Result.ptr != ' ')
+		{
+			continue;
+		}
+
+		const std::string_view Name = Line.substr(Result.ptr - Line.data() + 1);
+		if (!Name.empty())
+		{
+			Names[Hash] = std::string(Name);
+		}
+	}
+
+	return true;
+}
+
+bool FFunctionAnnotations::Save(const std::string& Path) const
+{
+	// sorted so the file diffs cleanly between sessions
+	std::vector<std::pair<uint64_t, const std::string*>> Sorted;
+	Sorted.reserve(Names.size());
+	for (const auto& [Hash, Name] : Names)
+	{
+		Sorted.emplace_back(Hash, &Name);
+	}
+	std::sort(Sorted.begin(), Sorted.end());
+
+	FBufferedWriter Out(0x10000);
+	if (!Out.Open(Path))
+	{
+		return false;
+	}
+
+	for (const auto& [Hash, Name] : Sorted)
+	{
+		Out.WriteHex(Hash);
+		Out.Write(' ');
+		Out.Write(*Name);
+		Out.Write('\n');
+	}
+
+	return Out.Close();
+}
+
+size_t FFunctionAnnotations::Collect(const FFunctionTable& Table)
+{
+	size_t NumCollected = 0;
+
+	for (uint32_t FunctionIndex = 0; FunctionIndex < Table.GetNumFunctions(); FunctionIndex++)
+	{
+		const uint64_t Hash = Table.GetHash(FunctionIndex);
+		if (Hash == 0 || !Table.HasUserName(FunctionIndex) || Table.FindFunctionByHash(Hash) != FunctionIndex)
+		{
+			continue;
+		}
+
+		Names[Hash] = Table.GetName(FunctionIndex);
+		NumCollected++;
+	}
+
+	return NumCollected;
+}
+
+size_t FFunctionAnnotations::Apply(FFunctionTable& Table) const
+{
+	size_t NumApplied = 0;
+
+	for (const auto& [Hash, Name] : Names)
+	{
+		const uint32_t FunctionIndex = Table.FindFunctionByHash(Hash);
+		if (FunctionIndex == FFunctionTable::InvalidIndex || Table.HasUserName(FunctionIndex))
+		{
+			continue;
+		}
+
+		Table.SetName(FunctionIndex, Name);
+		NumApplied++;
+	}
+
+	return NumApplied;
+}
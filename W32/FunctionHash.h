@@ -0,0 +1,62 @@
+#pragma once
+#include "Disassembler.h"
+#include "CodeScanner.h"
+#include "FunctionTable.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Hash of a function that survives a rebuild of its module when the function itself did not change.
+ * Instructions are decoded and only their mnemonics, operand kinds, sizes and registers are hashed.
+ * Whatever the linker or the layout of other code decides is masked: memory displacements, relative
+ * branch and call targets, and immediates that point into the module image. Immediates that are plain
+ * constants are kept, they tell otherwise identical small functions apart.
+ */
+class FFunctionHasher
+{
+public:
+	FFunctionHasher(uintptr_t InImageStart, uintptr_t InImageEnd);
+
+	// 0 if not a single instruction decodes
+	uint64_t Hash(const uint8_t* Body, size_t Size) const;
+
+	// hashes every function of the table with a known size whose code the scanner loaded, NumThreads 0 uses every core
+	size_t HashAll(FFunctionTable& Table, const FCodeScanner& Code, size_t NumThreads = 0) const;
+
+protected:
+	void AddInstruction(const ZydisDecodedInstruction& Instruction, std::vector<uint64_t>& Tokens) const;
+
+	Disassembler Decoder;
+	uintptr_t ImageStart = 0;
+	uintptr_t ImageEnd = 0;
+};
+
+/**
+ * Names the user gave to virtual functions, keyed by FFunctionHasher hash instead of address so they
+ * carry over to the next build of the module. One text file per module under
+ * %LOCALAPPDATA%\ClassDumper3\Annotations, a line per function with its hash in hex and its name.
+ * Only hashes that belong to exactly one function are recorded or applied, a shared hash cannot say
+ * which function a name was meant for.
+ */
+class FFunctionAnnotations
+{
+public:
+	// empty if the annotations directory could not be created
+	static std::string GetPath(const std::string& ModuleName);
+
+	// a missing file is an empty set of annotations
+	bool Load(const std::string& Path);
+	bool Save(const std::string& Path) const;
+
+	// records the user name of every function with a unique hash, replacing names recorded for the same hash
+	size_t Collect(const FFunctionTable& Table);
+
+	// names every function without a user name whose hash is unique in the table and recorded here, returns how many
+	size_t Apply(FFunctionTable& Table) const;
+
+	size_t size() const { return Names.size(); }
+
+protected:
+	std::unordered_map<uint64_t, std::string> Names;
+};
@@ -0,0 +1,244 @@
+#include "FunctionTable.h"
+#include "../Util/Strings.h"
+
+void FFunctionTable::Reset()
+{
+	std::scoped_lock Lock(NameMutex);
+
+	Addresses.clear();
+	AddressToFunction = FAddressIndex();
+	VTables.clear();
+	ChunkRefs.clear();
+	ChunkData.clear();
+	ChunkLookup.clear();
+	NumSlots = 0;
+	SlotStatus.clear();
+	Owners.clear();
+	Sizes.clear();
+	Hashes.clear();
+	HashLookup.clear();
+	ReverseSlots.clear();
+	ReverseStarts.clear();
+	NameIndices.clear();
+	NameSources.clear();
+	Names.clear();
+	NameLookup.clear();
+}
+
+void FFunctionTable::AddVTable(uint32_t ClassID, const std::vector<uintptr_t>& Functions)
+{
+	// classes without a vtable entry of their own get an empty one
+	if (VTables.size() <= ClassID)
+	{
+		VTables.resize(ClassID + 1);
+	}
+
+	std::vector<uint32_t> Slots;
+	Slots.reserve(Functions.size());
+	for (uintptr_t Function : Functions)
+	{
+		Slots.push_back(AddFunction(Function));
+	}
+
+	FVTableEntry& Entry = VTables[ClassID];
+	Entry.FirstChunkRef = static_cast<uint32_t>(ChunkRefs.size());
+	Entry.FirstStatus = static_cast<uint32_t>(NumSlots);
+	Entry.NumSlots = static_cast<uint32_t>(Slots.size());
+
+	for (size_t First = 0; First < Slots.size(); First += FVTableView::ChunkSize)
+	{
+		ChunkRefs.push_back(AddChunk(&Slots[First], std::min<size_t>(FVTableView::ChunkSize, Slots.size() - First)));
+	}
+
+	NumSlots += Slots.size();
+}
+
+uint32_t FFunctionTable::AddChunk(const uint32_t* Slots, size_t Count)
+{
+	FChunk Chunk;
+	Chunk.fill(InvalidIndex);
+	std::copy(Slots, Slots + Count, Chunk.begin());
+
+	auto [it, bInserted] = ChunkLookup.try_emplace(Chunk, static_cast<uint32_t>(ChunkData.size() / FVTableView::ChunkSize));
+	if (bInserted)
+	{
+		ChunkData.insert(ChunkData.end(), Chunk.begin(), Chunk.end());
+	}
+
+	return it->second;
+}
+
+uint32_t FFunctionTable::AddFunction(uintptr_t Address)
+{
+	uint32_t FunctionIndex = AddressToFunction.Find(Address);
+	if (FunctionIndex != InvalidIndex)
+	{
+		return FunctionIndex;
+	}
+
+	FunctionIndex = static_cast<uint32_t>(Addresses.size());
+	Addresses.push_back(Address);
+	NameIndices.push_back(InvalidIndex);
+	NameSources.push_back(ENameSource::None);
+	Owners.push_back({ InvalidIndex, 0 });
+	Sizes.push_back(0);
+	Hashes.push_back(0);
+
+	if (!ReverseStarts.empty())
+	{
+		ReverseStarts.push_back(ReverseStarts.back());
+	}
+
+	AddressToFunction.Insert(Address, FunctionIndex);
+	return FunctionIndex;
+}
+
+void FFunctionTable::Finalize()
+{
+	ChunkLookup = {};
+	SlotStatus.assign((NumSlots + 3) / 4, 0);
+
+	// counting sort of all slots by function
+	ReverseStarts.assign(Addresses.size() + 1, 0);
+	for (uint32_t ClassID = 0; ClassID < VTables.size(); ClassID++)
+	{
+		for (uint32_t FunctionIndex : GetVTable(ClassID))
+		{
+			ReverseStarts[FunctionIndex + 1]++;
+		}
+	}
+
+	for (size_t i = 1; i < ReverseStarts.size(); i++)
+	{
+		ReverseStarts[i] += ReverseStarts[i - 1];
+	}
+
+	ReverseSlots.resize(NumSlots);
+	std::vector<uint32_t> Cursor(ReverseStarts.begin(), ReverseStarts.end() - 1);
+
+	for (uint32_t ClassID = 0; ClassID < VTables.size(); ClassID++)
+	{
+		const FVTableView VTable = GetVTable(ClassID);
+		for (uint32_t Slot = 0; Slot < VTable.size(); Slot++)
+		{
+			ReverseSlots[Cursor[VTable[Slot]]++] = { ClassID, Slot };
+		}
+	}
+}
+
+FVTableView FFunctionTable::GetVTable(uint32_t ClassID) const
+{
+	if (ClassID >= VTables.size() || VTables[ClassID].NumSlots == 0)
+	{
+		return {};
+	}
+
+	return FVTableView(ChunkRefs.data() + VTables[ClassID].FirstChunkRef, ChunkData.data(), VTables[ClassID].NumSlots);
+}
+
+ESlotStatus FFunctionTable::GetSlotStatus(uint32_t ClassID, uint32_t Slot) const
+{
+	if (ClassID >= VTables.size() || Slot >= VTables[ClassID].NumSlots || SlotStatus.empty())
+	{
+		return ESlotStatus::Introduced;
+	}
+
+	const uint32_t Bit = (VTables[ClassID].FirstStatus + Slot) * 2;
+	return static_cast<ESlotStatus>((SlotStatus[Bit / 8] >> (Bit % 8)) & 3);
+}
+
+void FFunctionTable::SetSlotStatus(uint32_t ClassID, uint32_t Slot, ESlotStatus Status)
+{
+	if (ClassID >= VTables.size() || Slot >= VTables[ClassID].NumSlots || SlotStatus.empty())
+	{
+		return;
+	}
+
+	const uint32_t Bit = (VTables[ClassID].FirstStatus + Slot) * 2;
+	SlotStatus[Bit / 8] = static_cast<uint8_t>((SlotStatus[Bit / 8] & ~(3 << (Bit % 8))) | (static_cast<uint8_t>(Status) << (Bit % 8)));
+}
+
+std::span<const FFunctionSlot> FFunctionTable::GetSlots(uint32_t FunctionIndex) const
+{
+	if (FunctionIndex + 1 >= ReverseStarts.size())
+	{
+		return {};
+	}
+
+	return std::span<const FFunctionSlot>(ReverseSlots.data() + ReverseStarts[FunctionIndex], ReverseStarts[FunctionIndex + 1] - ReverseStarts[FunctionIndex]);
+}
+
+void FFunctionTable::BuildHashIndex()
+{
+	HashLookup.clear();
+	HashLookup.reserve(Hashes.size());
+
+	for (uint32_t FunctionIndex = 0; FunctionIndex < Hashes.size(); FunctionIndex++)
+	{
+		if (Hashes[FunctionIndex] == 0)
+		{
+			continue;
+		}
+
+		// identical bodies, such as empty functions and shared getters, cannot tell their functions apart
+		auto [it, bInserted] = HashLookup.try_emplace(Hashes[FunctionIndex], FunctionIndex);
+		if (!bInserted)
+		{
+			it->second = InvalidIndex;
+		}
+	}
+}
+
+uint32_t FFunctionTable::FindFunctionByHash(uint64_t Hash) const
+{
+	auto it = HashLookup.find(Hash);
+	return it != HashLookup.end() ? it->second : InvalidIndex;
+}
+
+std::string FFunctionTable::GetName(uint32_t FunctionIndex) const
+{
+	std::scoped_lock Lock(NameMutex);
+
+	if (FunctionIndex >= NameIndices.size())
+	{
+		return "<unknown>";
+	}
+
+	if (NameIndices[FunctionIndex] == InvalidIndex)
+	{
+		return "sub_" + IntegerToHexStr(Addresses[FunctionIndex]);
+	}
+
+	return Names[NameIndices[FunctionIndex]];
+}
+
+bool FFunctionTable::HasName(uint32_t FunctionIndex) const
+{
+	std::scoped_lock Lock(NameMutex);
+	return FunctionIndex < NameIndices.size() && NameIndices[FunctionIndex] != InvalidIndex;
+}
+
+void FFunctionTable::SetName(uint32_t FunctionIndex, const std::string& Name, ENameSource Source)
+{
+	std::scoped_lock Lock(NameMutex);
+
+	if (FunctionIndex >= NameIndices.size())
+	{
+		return;
+	}
+
+	auto [it, bInserted] = NameLookup.try_emplace(Name, static_cast<uint32_t>(Names.size()));
+	if (bInserted)
+	{
+		Names.push_back(Name);
+	}
+
+	NameIndices[FunctionIndex] = it->second;
+	NameSources[FunctionIndex] = Source;
+}
+
+ENameSource FFunctionTable::GetNameSource(uint32_t FunctionIndex) const
+{
+	std::scoped_lock Lock(NameMutex);
+	return FunctionIndex < NameSources.size() ? NameSources[FunctionIndex] : ENameSource::None;
+}
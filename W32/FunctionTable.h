@@ -0,0 +1,195 @@
+#pragma once
+#include "../Util/AddressIndex.h"
+#include <array>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------
+// Function Table
+// ---------------------------------------------
+
+struct FFunctionSlot
+{
+	uint32_t ClassID = 0;
+	uint32_t Slot = 0;
+};
+
+enum class ESlotStatus : uint8_t
+{
+	Introduced, // new virtual function, not present in the base vtable
+	Inherited, // same function as the base vtable at this slot
+	Overridden // base vtable has a different function at this slot
+};
+
+enum class ENameSource : uint8_t
+{
+	None, // never named, prints as sub_<address>
+	Inferred, // derived from the scan, such as constructor names, replaced by any name the user gives
+	User // given by the user, directly or carried over by annotations or a database diff
+};
+
+/** Read only view of one vtable, slot lookups go through the chunk table and stay O(1) */
+class FVTableView
+{
+public:
+	static constexpr uint32_t ChunkSize = 16;
+
+	FVTableView() = default;
+	FVTableView(const uint32_t* InChunkRefs, const uint32_t* InChunkData, uint32_t InNumSlots)
+		: ChunkRefs(InChunkRefs), ChunkData(InChunkData), NumSlots(InNumSlots)
+	{
+	}
+
+	size_t size() const { return NumSlots; }
+	bool empty() const { return NumSlots == 0; }
+
+	uint32_t operator[](size_t Slot) const
+	{
+		return ChunkData[ChunkRefs[Slot / ChunkSize] * ChunkSize + Slot % ChunkSize];
+	}
+
+	class FIterator
+	{
+	public:
+		FIterator(const FVTableView* InView, size_t InSlot) : View(InView), Slot(InSlot) {}
+		uint32_t operator*() const { return (*View)[Slot]; }
+		FIterator& operator++() { ++Slot; return *this; }
+		bool operator!=(const FIterator& Other) const { return Slot != Other.Slot; }
+	private:
+		const FVTableView* View;
+		size_t Slot;
+	};
+
+	FIterator begin() const { return FIterator(this, 0); }
+	FIterator end() const { return FIterator(this, NumSlots); }
+
+private:
+	const uint32_t* ChunkRefs = nullptr;
+	const uint32_t* ChunkData = nullptr;
+	uint32_t NumSlots = 0;
+};
+
+/**
+ * Module wide table of virtual functions. Every unique function address has one record and one name,
+ * and a reverse index lists every (class, slot) holding a function. Inherited slots share their record,
+ * so a rename shows up in every class at once. Names are interned, functions that were never named
+ * print as sub_<address>.
+ * VTables are stored as lists of hash-consed chunks of FVTableView::ChunkSize slots. A derived class
+ * shares every chunk of its base's vtable it did not override, so only overridden and appended slots
+ * cost memory.
+ */
+class FFunctionTable
+{
+public:
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	void Reset();
+
+	// adds the vtable of ClassID, classes have to be added in ClassID order
+	void AddVTable(uint32_t ClassID, const std::vector<uintptr_t>& Functions);
+
+	// builds the reverse index, call once all vtables are added
+	void Finalize();
+
+	// index of the function at Address, functions added after Finalize are not in any vtable
+	uint32_t AddFunction(uintptr_t Address);
+
+	size_t GetNumFunctions() const { return Addresses.size(); }
+	size_t GetNumSlots() const { return NumSlots; }
+
+	uint32_t FindFunction(uintptr_t Address) const { return AddressToFunction.Find(Address); }
+	const FAddressIndex& GetAddressIndex() const { return AddressToFunction; }
+	uintptr_t GetAddress(uint32_t FunctionIndex) const { return Addresses[FunctionIndex]; }
+
+	// function indices of every slot of the vtable of ClassID
+	FVTableView GetVTable(uint32_t ClassID) const;
+	size_t GetNumChunks() const { return ChunkData.size() / FVTableView::ChunkSize; }
+
+	// every (class, slot) that holds the function
+	std::span<const FFunctionSlot> GetSlots(uint32_t FunctionIndex) const;
+
+	// status bits of every slot, all slots are Introduced until set otherwise
+	ESlotStatus GetSlotStatus(uint32_t ClassID, uint32_t Slot) const;
+	void SetSlotStatus(uint32_t ClassID, uint32_t Slot, ESlotStatus Status);
+
+	// class and slot that introduced or overrode the function first, ClassID is InvalidIndex if unknown
+	FFunctionSlot GetOwner(uint32_t FunctionIndex) const { return Owners[FunctionIndex]; }
+	void SetOwner(uint32_t FunctionIndex, const FFunctionSlot& Owner) { Owners[FunctionIndex] = Owner; }
+
+	// size in bytes of the function body, 0 if unknown
+	uint32_t GetSize(uint32_t FunctionIndex) const { return Sizes[FunctionIndex]; }
+	void SetSize(uint32_t FunctionIndex, uint32_t Size) { Sizes[FunctionIndex] = Size; }
+
+	// hash of the function body used to recognize it in another build, 0 if unknown
+	uint64_t GetHash(uint32_t FunctionIndex) const { return Hashes[FunctionIndex]; }
+	void SetHash(uint32_t FunctionIndex, uint64_t Hash) { Hashes[FunctionIndex] = Hash; }
+
+	// indexes the hashes of every function, call again after hashes changed
+	void BuildHashIndex();
+
+	// the only function with this hash, InvalidIndex if none or several functions have it
+	uint32_t FindFunctionByHash(uint64_t Hash) const;
+
+	std::string GetName(uint32_t FunctionIndex) const;
+	bool HasName(uint32_t FunctionIndex) const;
+	void SetName(uint32_t FunctionIndex, const std::string& Name, ENameSource Source = ENameSource::User);
+
+	// only user names are recorded as annotations and carried over to other builds
+	ENameSource GetNameSource(uint32_t FunctionIndex) const;
+	bool HasUserName(uint32_t FunctionIndex) const { return GetNameSource(FunctionIndex) == ENameSource::User; }
+
+protected:
+
+	std::vector<uintptr_t> Addresses; // function index -> address
+	FAddressIndex AddressToFunction;
+
+	uint32_t AddChunk(const uint32_t* Slots, size_t Count);
+
+	struct FVTableEntry
+	{
+		uint32_t FirstChunkRef = 0; // into ChunkRefs
+		uint32_t FirstStatus = 0; // into SlotStatus, in slots
+		uint32_t NumSlots = 0;
+	};
+
+	using FChunk = std::array<uint32_t, FVTableView::ChunkSize>;
+
+	struct FChunkHash
+	{
+		size_t operator()(const FChunk& Chunk) const
+		{
+			uint64_t Hash = 0xCBF29CE484222325ull;
+			for (uint32_t Value : Chunk)
+			{
+				Hash = (Hash ^ Value) * 0x100000001B3ull;
+			}
+			return static_cast<size_t>(Hash);
+		}
+	};
+
+	std::vector<FVTableEntry> VTables; // indexed by ClassID
+	std::vector<uint32_t> ChunkRefs; // chunk indices, every vtable owns a contiguous run
+	std::vector<uint32_t> ChunkData; // ChunkSize function indices per chunk, the tail of a partial chunk is InvalidIndex
+	std::unordered_map<FChunk, uint32_t, FChunkHash> ChunkLookup; // only used while vtables are added
+	size_t NumSlots = 0;
+
+	std::vector<uint8_t> SlotStatus; // 2 bits per slot
+	std::vector<FFunctionSlot> Owners; // indexed by function
+	std::vector<uint32_t> Sizes; // indexed by function
+	std::vector<uint64_t> Hashes; // indexed by function
+	std::unordered_map<uint64_t, uint32_t> HashLookup; // hash -> function, InvalidIndex for shared hashes
+
+	// reverse index, the slots of a function are ReverseSlots[ReverseStarts[Function], ReverseStarts[Function + 1])
+	std::vector<FFunctionSlot> ReverseSlots;
+	std::vector<uint32_t> ReverseStarts;
+
+	// function index -> name index, names are shared between functions with the same name
+	mutable std::mutex NameMutex;
+	std::vector<uint32_t> NameIndices;
+	std::vector<ENameSource> NameSources;
+	std::vector<std::string> Names;
+	std::unordered_map<std::string, uint32_t> NameLookup;
+};
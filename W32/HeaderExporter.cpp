@@ -0,0 +1,536 @@
+#include "HeaderExporter.h"
+#include "RTTI.h"
+#include "../Util/Strings.h"
+#include <unordered_set>
+
+namespace
+{
+	// interned name of a slot that holds a destructor, declared as ~Class() in every class
+	const std::string DestructorName = "~";
+
+	bool IsKeyword(std::string_view Name)
+	{
+		static const std::unordered_set<std::string_view> Keywords = {
+			"alignas", "alignof", "asm", "auto", "bool", "break", "case", "catch", "char", "class", "const", "constexpr",
+			"continue", "decltype", "default", "delete", "do", "double", "else", "enum", "explicit", "export", "extern",
+			"false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new",
+			"noexcept", "nullptr", "operator", "private", "protected", "public", "register", "return", "short", "signed",
+			"sizeof", "static", "struct", "switch", "template", "this", "throw", "true", "try", "typedef", "typeid",
+			"typename", "union", "unsigned", "using", "virtual", "void", "volatile", "while"
+		};
+
+		return Keywords.contains(Name);
+	}
+
+	const char* GetFieldType(EFieldKind Kind)
+	{
+		switch (Kind)
+		{
+		case EFieldKind::VTable:
+		case EFieldKind::ModulePointer:
+		case EFieldKind::HeapPointer:
+			return "void*";
+		case EFieldKind::StringPointer:
+			return "const char*";
+		case EFieldKind::Float:
+			return "float";
+		default:
+			return "uintptr_t";
+		}
+	}
+}
+
+FHeaderExporter::FHeaderExporter(RTTI& InTarget, const FHeaderExportSettings& InSettings)
+	: Target(InTarget), Functions(InTarget.GetFunctionTable()), Settings(InSettings)
+{
+}
+
+bool FHeaderExporter::Export(const std::string& Path)
+{
+	if (!Out.Open(Path))
+	{
+		return false;
+	}
+
+	CollectClasses();
+	AssignIdentifiers();
+
+	WritePreamble();
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		WriteClass(CMeta);
+	}
+
+	Stats.BytesWritten = Out.GetBytesWritten();
+	return Out.Close();
+}
+
+std::string FHeaderExporter::MakeIdentifier(std::string_view Name)
+{
+	std::string Identifier;
+	Identifier.reserve(Name.size() + 1);
+
+	if (Name.empty() || isdigit(static_cast<unsigned char>(Name[0])))
+	{
+		Identifier += '_';
+	}
+
+	for (char Character : Name)
+	{
+		Identifier += isalnum(static_cast<unsigned char>(Character)) ? Character : '_';
+	}
+
+	if (IsKeyword(Identifier))
+	{
+		Identifier += '_';
+	}
+
+	return Identifier;
+}
+
+void FHeaderExporter::CollectClasses()
+{
+	const std::vector<std::shared_ptr<ClassMetaData>> AllClasses = Target.GetClasses();
+	std::unordered_set<uintptr_t> CompleteTypes;
+
+	for (const std::shared_ptr<ClassMetaData>& CMeta : AllClasses)
+	{
+		if (CMeta->VTableOffset == 0)
+		{
+			// the first primary vtable of a type is its complete class, the same one LinkSecondaryVTables picks
+			if (CompleteTypes.insert(CMeta->TypeDescriptor).second)
+			{
+				Classes.push_back(CMeta);
+			}
+		}
+		else if (std::shared_ptr<ClassMetaData> Complete = Target.GetCompleteClass(CMeta))
+		{
+			SecondaryVTables[Complete->ClassID].push_back(CMeta);
+		}
+	}
+
+	// a base always has fewer base classes than its children, so this is a dependency order
+	std::sort(Classes.begin(), Classes.end(), [](const std::shared_ptr<ClassMetaData>& A, const std::shared_ptr<ClassMetaData>& B)
+		{
+			if (A->numBaseClasses != B->numBaseClasses) return A->numBaseClasses < B->numBaseClasses;
+			if (A->Name != B->Name) return A->Name < B->Name;
+			if (A->MangledName != B->MangledName) return A->MangledName < B->MangledName;
+			return A->TypeDescriptor < B->TypeDescriptor;
+		});
+
+	for (auto& [ClassID, VTables] : SecondaryVTables)
+	{
+		std::sort(VTables.begin(), VTables.end(), [](const std::shared_ptr<ClassMetaData>& A, const std::shared_ptr<ClassMetaData>& B) { return A->VTableOffset < B->VTableOffset; });
+	}
+
+	// direct bases without a vtable of their own, abstract interfaces built with novtable and plain structs
+	std::unordered_set<uintptr_t> StubTypes;
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		for (const std::shared_ptr<ParentClass>& Parent : CMeta->Parents)
+		{
+			if (Parent->TreeDepth == 0 && !CompleteTypes.contains(Parent->TypeDescriptor) && StubTypes.insert(Parent->TypeDescriptor).second)
+			{
+				Stubs.push_back(Parent);
+			}
+		}
+	}
+
+	std::sort(Stubs.begin(), Stubs.end(), [](const std::shared_ptr<ParentClass>& A, const std::shared_ptr<ParentClass>& B)
+		{
+			if (A->Name != B->Name) return A->Name < B->Name;
+			if (A->MangledName != B->MangledName) return A->MangledName < B->MangledName;
+			return A->TypeDescriptor < B->TypeDescriptor;
+		});
+
+	SlotNames.assign(AllClasses.size(), {});
+	SlotNamesResolved.assign(AllClasses.size(), false);
+	EmittedSizes.assign(AllClasses.size(), UnknownOffset);
+
+	Stats.NumClasses = Classes.size();
+	Stats.NumStubs = Stubs.size();
+}
+
+void FHeaderExporter::AssignIdentifiers()
+{
+	struct FNamedType
+	{
+		const std::string* Name;
+		const std::string* MangledName;
+		uintptr_t TypeDescriptor;
+	};
+
+	std::vector<FNamedType> Types;
+	Types.reserve(Classes.size() + Stubs.size());
+
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		Types.push_back({ &CMeta->Name, &CMeta->MangledName, CMeta->TypeDescriptor });
+	}
+
+	for (const std::shared_ptr<ParentClass>& Stub : Stubs)
+	{
+		Types.push_back({ &Stub->Name, &Stub->MangledName, Stub->TypeDescriptor });
+	}
+
+	// collisions are resolved in name order so the same names always get the same suffixes
+	std::sort(Types.begin(), Types.end(), [](const FNamedType& A, const FNamedType& B)
+		{
+			if (*A.Name != *B.Name) return *A.Name < *B.Name;
+			if (*A.MangledName != *B.MangledName) return *A.MangledName < *B.MangledName;
+			return A.TypeDescriptor < B.TypeDescriptor;
+		});
+
+	std::unordered_set<std::string> Used;
+	Identifiers.reserve(Types.size());
+
+	for (const FNamedType& Type : Types)
+	{
+		std::string Identifier = MakeIdentifier(*Type.Name);
+		for (uint32_t Suffix = 2; !Used.insert(Identifier).second; Suffix++)
+		{
+			Identifier = MakeIdentifier(*Type.Name) + "_" + std::to_string(Suffix);
+		}
+
+		IdentifierIndices[Type.TypeDescriptor] = static_cast<uint32_t>(Identifiers.size());
+		Identifiers.push_back(std::move(Identifier));
+	}
+}
+
+const std::string& FHeaderExporter::GetIdentifier(uintptr_t TypeDescriptor) const
+{
+	static const std::string Unknown = "_";
+
+	auto it = IdentifierIndices.find(TypeDescriptor);
+	return it != IdentifierIndices.end() ? Identifiers[it->second] : Unknown;
+}
+
+uint32_t FHeaderExporter::InternMethodName(const std::string& Name)
+{
+	auto [it, bInserted] = MethodNameLookup.try_emplace(Name, static_cast<uint32_t>(MethodNames.size()));
+	if (bInserted)
+	{
+		MethodNames.push_back(Name);
+	}
+
+	return it->second;
+}
+
+const std::vector<uint32_t>& FHeaderExporter::ResolveSlotNames(const std::shared_ptr<ClassMetaData>& VTable)
+{
+	std::vector<uint32_t>& Names = SlotNames[VTable->ClassID];
+	if (SlotNamesResolved[VTable->ClassID])
+	{
+		return Names;
+	}
+
+	SlotNamesResolved[VTable->ClassID] = true;
+
+	const FVTableView Slots = Functions.GetVTable(VTable->ClassID);
+
+	// slots of the base vtable keep the name the base gave them, so a redeclaration is an override
+	if (std::shared_ptr<ClassMetaData> Base = Target.GetVTableBase(VTable))
+	{
+		const std::vector<uint32_t>& BaseNames = ResolveSlotNames(Base);
+		Names.assign(BaseNames.begin(), BaseNames.begin() + std::min(BaseNames.size(), Slots.size()));
+	}
+
+	std::unordered_set<uint32_t> Used(Names.begin(), Names.end());
+	const std::string& ClassIdentifier = GetIdentifier(VTable->TypeDescriptor);
+
+	for (uint32_t Slot = static_cast<uint32_t>(Names.size()); Slot < Slots.size(); Slot++)
+	{
+		// unnamed functions are called after their slot, sub_<address> would differ between builds
+		std::string Name;
+		const uint32_t FunctionIndex = Slots[Slot];
+		if (FunctionIndex < Functions.GetNumFunctions() && Functions.HasName(FunctionIndex))
+		{
+			Name = GetUnqualifiedName(Functions.GetName(FunctionIndex));
+			Name = !Name.empty() && Name[0] == '~' ? DestructorName : MakeIdentifier(Name);
+		}
+
+		// a method named after its class would be a constructor
+		uint32_t NameIndex = Name.empty() || Name == ClassIdentifier ? FAddressIndex::InvalidIndex : InternMethodName(Name);
+		if (NameIndex == FAddressIndex::InvalidIndex || !Used.insert(NameIndex).second)
+		{
+			Name = "vf" + std::to_string(Slot);
+			while (!Used.insert(NameIndex = InternMethodName(Name)).second)
+			{
+				Name += '_';
+			}
+		}
+
+		Names.push_back(NameIndex);
+	}
+
+	return Names;
+}
+
+void FHeaderExporter::WritePreamble()
+{
+	Out.Write("// Generated by ClassDumper3 from ");
+	Out.Write(Target.GetModuleName());
+	Out.Write("\n// ");
+	Out.WriteDecimal(Classes.size());
+	Out.Write(" classes, bases before derived classes\n\n#pragma once\n#include <cstdint>\n");
+
+	if (!Stubs.empty())
+	{
+		Out.Write("\n// bases without a vtable\n");
+		for (const std::shared_ptr<ParentClass>& Stub : Stubs)
+		{
+			Out.Write("struct ");
+			Out.Write(GetIdentifier(Stub->TypeDescriptor));
+			Out.Write(" {};\n");
+		}
+	}
+
+	// members may point to classes declared further down
+	if (Settings.bIncludeMembers && !Classes.empty())
+	{
+		Out.Write('\n');
+		for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+		{
+			Out.Write(CMeta->bStruct ? "struct " : "class ");
+			Out.Write(GetIdentifier(CMeta->TypeDescriptor));
+			Out.Write(";\n");
+		}
+	}
+}
+
+void FHeaderExporter::WriteClass(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	const std::string& Identifier = GetIdentifier(CMeta->TypeDescriptor);
+
+	Out.Write("\n// ");
+	Out.Write(CMeta->Name);
+	if (CMeta->ObjectSize > 0)
+	{
+		Out.Write(", sizeof 0x");
+		Out.WriteHex(CMeta->ObjectSize);
+		Out.Write(" from ");
+		Out.Write(RTTI::GetObjectSizeSourceName(CMeta->ObjectSizeSource));
+	}
+	if (Settings.bIncludeAddresses)
+	{
+		Out.Write(", vftable +0x");
+		Out.WriteHex(CMeta->VTable - Target.GetLoadAddress());
+	}
+
+	Out.Write('\n');
+	Out.Write(CMeta->bStruct ? "struct " : "class ");
+	Out.Write(Identifier);
+
+	char Separator = ':';
+	for (const std::shared_ptr<ParentClass>& Parent : CMeta->Parents)
+	{
+		if (Parent->TreeDepth != 0)
+		{
+			continue;
+		}
+
+		Out.Write(' ');
+		Out.Write(Separator);
+		Out.Write(Parent->where.pdisp != -1 ? " virtual public " : " public ");
+		Out.Write(GetIdentifier(Parent->TypeDescriptor));
+		Separator = ',';
+	}
+
+	Out.Write(CMeta->bStruct ? "\n{\n" : "\n{\npublic:\n");
+
+	WriteVirtualFunctions(CMeta, Identifier);
+
+	const uint32_t Start = GetMemberStart(CMeta);
+	if (Start != UnknownOffset)
+	{
+		const uint32_t End = Settings.bIncludeMembers ? WriteMembers(CMeta, Start) : Start;
+		if (CMeta->ObjectSize >= End)
+		{
+			WritePadding(End, CMeta->ObjectSize - End);
+			EmittedSizes[CMeta->ClassID] = CMeta->ObjectSize;
+		}
+	}
+
+	Out.Write("};\n");
+}
+
+void FHeaderExporter::WriteVirtualFunctions(const std::shared_ptr<ClassMetaData>& CMeta, const std::string& Identifier)
+{
+	std::vector<uint32_t> Declared;
+
+	auto Declare = [&](const std::shared_ptr<ClassMetaData>& VTable, uint32_t Slot, uint32_t NameIndex)
+		{
+			if (std::find(Declared.begin(), Declared.end(), NameIndex) != Declared.end())
+			{
+				return;
+			}
+
+			Declared.push_back(NameIndex);
+			Stats.NumFunctions++;
+
+			const std::string& Name = MethodNames[NameIndex];
+			if (Name == DestructorName)
+			{
+				Out.Write("\tvirtual ~");
+				Out.Write(Identifier);
+			}
+			else
+			{
+				Out.Write("\tvirtual void ");
+				Out.Write(Name);
+			}
+
+			Out.Write("(); // ");
+			if (VTable != CMeta)
+			{
+				Out.Write("+0x");
+				Out.WriteHex(VTable->VTableOffset);
+				Out.Write(' ');
+			}
+			Out.Write("slot ");
+			Out.WriteDecimal(Slot);
+
+			if (Settings.bIncludeAddresses)
+			{
+				Out.Write(", +0x");
+				Out.WriteHex(Functions.GetAddress(Functions.GetVTable(VTable->ClassID)[Slot]) - Target.GetLoadAddress());
+			}
+
+			Out.Write('\n');
+		};
+
+	// new slots are appended in declaration order, overrides only need a declaration with the base's name
+	const std::vector<uint32_t>& Names = ResolveSlotNames(CMeta);
+	for (uint32_t Slot = 0; Slot < Names.size(); Slot++)
+	{
+		if (Functions.GetSlotStatus(CMeta->ClassID, Slot) != ESlotStatus::Inherited)
+		{
+			Declare(CMeta, Slot, Names[Slot]);
+		}
+	}
+
+	auto it = SecondaryVTables.find(CMeta->ClassID);
+	if (it == SecondaryVTables.end())
+	{
+		return;
+	}
+
+	for (const std::shared_ptr<ClassMetaData>& VTable : it->second)
+	{
+		const std::vector<uint32_t>& SecondaryNames = ResolveSlotNames(VTable);
+		for (uint32_t Slot = 0; Slot < SecondaryNames.size(); Slot++)
+		{
+			if (Functions.GetSlotStatus(VTable->ClassID, Slot) == ESlotStatus::Overridden)
+			{
+				Declare(VTable, Slot, SecondaryNames[Slot]);
+			}
+		}
+	}
+}
+
+uint32_t FHeaderExporter::GetMemberStart(const std::shared_ptr<ClassMetaData>& CMeta) const
+{
+	const std::shared_ptr<ParentClass>* DirectBase = nullptr;
+	for (const std::shared_ptr<ParentClass>& Parent : CMeta->Parents)
+	{
+		if (Parent->TreeDepth != 0)
+		{
+			continue;
+		}
+
+		// the layout of multiple bases is left to the compiler, offsets would only be guesses
+		if (DirectBase)
+		{
+			return UnknownOffset;
+		}
+
+		DirectBase = &Parent;
+	}
+
+	if (!DirectBase)
+	{
+		return Functions.GetVTable(CMeta->ClassID).empty() ? 0 : static_cast<uint32_t>(sizeof(uintptr_t));
+	}
+
+	const std::shared_ptr<ParentClass>& Parent = *DirectBase;
+	if (Parent->where.pdisp != -1 || Parent->where.mdisp != 0)
+	{
+		return UnknownOffset;
+	}
+
+	// members start at sizeof(base), which is only right if the base was padded to its real size
+	std::shared_ptr<ClassMetaData> Base = Target.GetCompleteClass(Parent->Class.lock());
+	if (!Base || Base->TypeDescriptor != Parent->TypeDescriptor)
+	{
+		return UnknownOffset;
+	}
+
+	return EmittedSizes[Base->ClassID];
+}
+
+uint32_t FHeaderExporter::WriteMembers(const std::shared_ptr<ClassMetaData>& CMeta, uint32_t Start)
+{
+	constexpr uint32_t FieldSize = sizeof(uintptr_t);
+	uint32_t Offset = Start;
+
+	for (const FFieldLayout& Field : CMeta->Members)
+	{
+		if (Field.Kind == EFieldKind::Unknown || Field.Offset < Offset || Field.Offset % FieldSize != 0)
+		{
+			continue;
+		}
+
+		if (CMeta->ObjectSize > 0 && Field.Offset + FieldSize > CMeta->ObjectSize)
+		{
+			break;
+		}
+
+		WritePadding(Offset, Field.Offset - Offset);
+
+		Out.Write('\t');
+		std::shared_ptr<ClassMetaData> Pointee = Field.Kind == EFieldKind::ClassPointer ? Target.GetCompleteClass(Target.GetClass(Field.ClassID)) : nullptr;
+		if (Pointee && IdentifierIndices.contains(Pointee->TypeDescriptor))
+		{
+			Out.Write(GetIdentifier(Pointee->TypeDescriptor));
+			Out.Write('*');
+		}
+		else
+		{
+			Out.Write(GetFieldType(Field.Kind));
+		}
+
+		Out.Write(Field.Kind == EFieldKind::VTable ? " vftable_" : " field_");
+		Out.WriteHex(Field.Offset);
+		if (Field.Kind == EFieldKind::Float && FieldSize > sizeof(float))
+		{
+			Out.Write('[');
+			Out.WriteDecimal(FieldSize / sizeof(float));
+			Out.Write(']');
+		}
+
+		Out.Write("; // ");
+		Out.Write(FLayoutSampler::GetFieldKindName(Field.Kind));
+		Out.Write(", ");
+		Out.WriteDecimal(Field.Agreement);
+		Out.Write("%\n");
+
+		Offset = Field.Offset + FieldSize;
+		Stats.NumMembers++;
+	}
+
+	return Offset;
+}
+
+void FHeaderExporter::WritePadding(uint32_t Offset, uint32_t Size)
+{
+	if (Size == 0)
+	{
+		return;
+	}
+
+	Out.Write("\tuint8_t pad_");
+	Out.WriteHex(Offset);
+	Out.Write("[0x");
+	Out.WriteHex(Size);
+	Out.Write("];\n");
+}
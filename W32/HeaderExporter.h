@@ -0,0 +1,87 @@
+#pragma once
+#include "../Util/BufferedWriter.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class RTTI;
+class FFunctionTable;
+struct ClassMetaData;
+struct ParentClass;
+
+struct FHeaderExportSettings
+{
+	bool bIncludeAddresses = false; // vtable and function RVAs as comments, they change with every build
+	bool bIncludeMembers = true; // fields inferred by RTTI::SampleLayout
+};
+
+struct FHeaderExportStats
+{
+	size_t NumClasses = 0;
+	size_t NumStubs = 0; // bases without a vtable, emitted as empty structs
+	size_t NumFunctions = 0;
+	size_t NumMembers = 0;
+	uint64_t BytesWritten = 0;
+};
+
+/**
+ * Writes every complete class of an RTTI scan as a compilable C++ declaration. Classes are emitted
+ * bases first, ordered by depth and then by name, and nothing that depends on load addresses is
+ * written unless asked for, so the headers of two builds of a game diff cleanly.
+ * Virtual functions keep the name of the class that introduced the slot so overrides line up, and
+ * classes of known size are padded to it so derived members land at their real offsets.
+ * Output is streamed through a buffered writer, only names and slot names are kept in memory.
+ */
+class FHeaderExporter
+{
+public:
+	static constexpr uint32_t UnknownOffset = 0xFFFFFFFF;
+
+	FHeaderExporter(RTTI& InTarget, const FHeaderExportSettings& InSettings);
+
+	bool Export(const std::string& Path);
+	const FHeaderExportStats& GetStats() const { return Stats; }
+
+	// valid C++ identifier for a demangled name, ns::Foo<int> -> ns__Foo_int_
+	static std::string MakeIdentifier(std::string_view Name);
+
+protected:
+	void CollectClasses();
+	void AssignIdentifiers();
+	const std::string& GetIdentifier(uintptr_t TypeDescriptor) const;
+
+	// interned method names of every slot of the vtable, inherited slots keep the base's name
+	const std::vector<uint32_t>& ResolveSlotNames(const std::shared_ptr<ClassMetaData>& VTable);
+	uint32_t InternMethodName(const std::string& Name);
+
+	void WritePreamble();
+	void WriteClass(const std::shared_ptr<ClassMetaData>& CMeta);
+	void WriteVirtualFunctions(const std::shared_ptr<ClassMetaData>& CMeta, const std::string& Identifier);
+	uint32_t WriteMembers(const std::shared_ptr<ClassMetaData>& CMeta, uint32_t Start);
+	void WritePadding(uint32_t Offset, uint32_t Size);
+
+	// where the class's own members start, UnknownOffset if the layout of its bases is unknown
+	uint32_t GetMemberStart(const std::shared_ptr<ClassMetaData>& CMeta) const;
+
+	RTTI& Target;
+	FFunctionTable& Functions;
+	FHeaderExportSettings Settings;
+	FHeaderExportStats Stats;
+	FBufferedWriter Out;
+
+	std::vector<std::shared_ptr<ClassMetaData>> Classes; // complete classes in declaration order
+	std::unordered_map<uint32_t, std::vector<std::shared_ptr<ClassMetaData>>> SecondaryVTables; // by complete ClassID
+	std::vector<std::shared_ptr<ParentClass>> Stubs; // direct bases without a vtable
+
+	std::unordered_map<uintptr_t, uint32_t> IdentifierIndices; // type descriptor -> Identifiers
+	std::vector<std::string> Identifiers;
+
+	std::vector<std::vector<uint32_t>> SlotNames; // by ClassID
+	std::vector<bool> SlotNamesResolved;
+	std::vector<std::string> MethodNames;
+	std::unordered_map<std::string, uint32_t> MethodNameLookup;
+
+	std::vector<uint32_t> EmittedSizes; // by ClassID, sizeof the emitted declaration if it was padded to the object size
+};
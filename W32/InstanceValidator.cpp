@@ -0,0 +1,225 @@
+#include "InstanceValidator.h"
+#include "RTTI.h"
+#include <algorithm>
+
+FInstanceValidator::FInstanceValidator(FTargetProcess* InProcess, const std::vector<std::shared_ptr<ClassMetaData>>& Classes, const FInstanceValidationSettings& InSettings)
+	: Process(InProcess), Settings(InSettings)
+{
+	auto ByStart = [](const FMemoryRange& A, const FMemoryRange& B) { return A.Start < B.Start; };
+
+	Ranges = Process->MemoryMap.Ranges;
+	std::sort(Ranges.begin(), Ranges.end(), ByStart);
+
+	Stacks = Process->GetThreadStackRanges();
+	std::sort(Stacks.begin(), Stacks.end(), ByStart);
+
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		std::shared_ptr<ClassMetaData> Complete = CMeta->CompleteClass.lock();
+		if (Complete)
+		{
+			SecondaryVTables[Complete.get()].emplace_back(CMeta->VTableOffset, CMeta->VTable);
+		}
+	}
+}
+
+size_t FInstanceValidator::Validate(std::vector<FInstanceHit>& Hits)
+{
+	if (Hits.empty())
+	{
+		return 0;
+	}
+
+	// the window has to cover the furthest secondary vtable of any class we are validating
+	size_t WindowSize = Settings.NeighbourWords * sizeof(uintptr_t);
+	for (const FInstanceHit& Hit : Hits)
+	{
+		auto it = SecondaryVTables.find(Hit.Class);
+		if (it == SecondaryVTables.end())
+		{
+			continue;
+		}
+
+		for (const auto& [Offset, VTable] : it->second)
+		{
+			WindowSize = std::max<size_t>(WindowSize, Offset + sizeof(uintptr_t));
+		}
+	}
+	WindowSize = std::min(WindowSize, std::max(Settings.MaxWindowSize, sizeof(uintptr_t)));
+
+	std::vector<uintptr_t> Addresses;
+	Addresses.reserve(Hits.size());
+	for (const FInstanceHit& Hit : Hits)
+	{
+		Addresses.push_back(Hit.Instance.Address);
+	}
+	std::sort(Addresses.begin(), Addresses.end());
+	Addresses.erase(std::unique(Addresses.begin(), Addresses.end()), Addresses.end());
+
+	std::vector<uint8_t> Windows = Process->ReadBatched(Addresses, WindowSize);
+
+	for (FInstanceHit& Hit : Hits)
+	{
+		size_t Index = std::lower_bound(Addresses.begin(), Addresses.end(), Hit.Instance.Address) - Addresses.begin();
+		Hit.Instance.Confidence = Score(Hit, &Windows[Index * WindowSize], WindowSize);
+	}
+
+	const size_t NumHits = Hits.size();
+	Hits.erase(std::remove_if(Hits.begin(), Hits.end(), [this](const FInstanceHit& Hit) { return Hit.Instance.Confidence < Settings.ConfidenceThreshold; }), Hits.end());
+
+	return NumHits - Hits.size();
+}
+
+const char* FInstanceValidator::GetRegionName(EInstanceRegion Region)
+{
+	switch (Region)
+	{
+	case EInstanceRegion::Image: return "image";
+	case EInstanceRegion::Heap: return "heap";
+	case EInstanceRegion::Stack: return "stack";
+	case EInstanceRegion::Mapped: return "mapped";
+	default: return "unknown";
+	}
+}
+
+const FMemoryRange* FInstanceValidator::FindRange(uintptr_t Address) const
+{
+	auto it = std::upper_bound(Ranges.begin(), Ranges.end(), Address, [](uintptr_t Value, const FMemoryRange& Range) { return Value < Range.Start; });
+	if (it == Ranges.begin())
+	{
+		return nullptr;
+	}
+
+	--it;
+	return Address < it->End ? &*it : nullptr;
+}
+
+EInstanceRegion FInstanceValidator::ClassifyRegion(uintptr_t Address, const FMemoryRange* Range) const
+{
+	auto it = std::upper_bound(Stacks.begin(), Stacks.end(), Address, [](uintptr_t Value, const FMemoryRange& Stack) { return Value < Stack.Start; });
+	if (it != Stacks.begin() && Address < std::prev(it)->End)
+	{
+		return EInstanceRegion::Stack;
+	}
+
+	if (!Range)
+	{
+		return EInstanceRegion::Unknown;
+	}
+
+	switch (Range->Type)
+	{
+	case MEM_IMAGE: return EInstanceRegion::Image;
+	case MEM_MAPPED: return EInstanceRegion::Mapped;
+	case MEM_PRIVATE: return EInstanceRegion::Heap;
+	default: return EInstanceRegion::Unknown;
+	}
+}
+
+bool FInstanceValidator::IsFloatLike(uint32_t Value)
+{
+	const uint32_t Exponent = (Value >> 23) & 0xFF;
+	return Value == 0 || (Exponent >= 100 && Exponent <= 154);
+}
+
+bool FInstanceValidator::IsPlausibleMember(uintptr_t Value) const
+{
+	// null, small integers and flags, small negative numbers
+	if (Value < 0x10000 || Value > static_cast<uintptr_t>(-0x10000))
+	{
+		return true;
+	}
+
+	if (FindRange(Value))
+	{
+		return true;
+	}
+
+	// one or two packed floats
+	if constexpr (sizeof(uintptr_t) == 8)
+	{
+		return IsFloatLike(static_cast<uint32_t>(Value)) && IsFloatLike(static_cast<uint32_t>(static_cast<uint64_t>(Value) >> 32));
+	}
+	else
+	{
+		return IsFloatLike(static_cast<uint32_t>(Value));
+	}
+}
+
+uint8_t FInstanceValidator::Score(FInstanceHit& Hit, const uint8_t* Window, size_t WindowSize) const
+{
+	auto ReadWord = [&](size_t Offset)
+		{
+			uintptr_t Value = 0;
+			memcpy(&Value, Window + Offset, sizeof(uintptr_t));
+			return Value;
+		};
+
+	// the object changed or was freed since the scan
+	if (ReadWord(0) != Hit.Class->VTable)
+	{
+		return 0;
+	}
+
+	const FMemoryRange* Range = FindRange(Hit.Instance.Address);
+	Hit.Instance.Region = ClassifyRegion(Hit.Instance.Address, Range);
+
+	int Score = 50;
+
+	// read-only hits are the vtable's own entries, RTTI data or other constant tables
+	Score += (Range && Range->bWritable) ? 15 : -40;
+
+	switch (Hit.Instance.Region)
+	{
+	case EInstanceRegion::Heap:
+	case EInstanceRegion::Image:
+		Score += 10;
+		break;
+	case EInstanceRegion::Stack:
+		Score -= 15;
+		break;
+	case EInstanceRegion::Mapped:
+		Score -= 5;
+		break;
+	default:
+		Score -= 20;
+		break;
+	}
+
+	const size_t NeighbourWords = std::min(Settings.NeighbourWords, WindowSize / sizeof(uintptr_t));
+	if (NeighbourWords > 1)
+	{
+		size_t Plausible = 0;
+		for (size_t i = 1; i < NeighbourWords; i++)
+		{
+			Plausible += IsPlausibleMember(ReadWord(i * sizeof(uintptr_t))) ? 1 : 0;
+		}
+
+		Score += static_cast<int>(40 * Plausible / (NeighbourWords - 1)) - 20;
+	}
+
+	auto it = SecondaryVTables.find(Hit.Class);
+	if (it != SecondaryVTables.end())
+	{
+		size_t Expected = 0;
+		size_t Present = 0;
+
+		for (const auto& [Offset, VTable] : it->second)
+		{
+			if (Offset + sizeof(uintptr_t) > WindowSize)
+			{
+				continue;
+			}
+
+			Expected++;
+			Present += ReadWord(Offset) == VTable ? 1 : 0;
+		}
+
+		if (Expected > 0)
+		{
+			Score += Present == Expected ? 20 : -30;
+		}
+	}
+
+	return static_cast<uint8_t>(std::clamp(Score, 0, 100));
+}
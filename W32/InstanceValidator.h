@@ -0,0 +1,57 @@
+#pragma once
+#include "Memory.h"
+#include <memory>
+#include <unordered_map>
+
+struct ClassMetaData;
+struct FInstanceHit;
+
+enum class EInstanceRegion : uint8_t
+{
+	Unknown,
+	Image,
+	Heap,
+	Stack,
+	Mapped
+};
+
+struct FInstanceValidationSettings
+{
+	uint8_t ConfidenceThreshold = 50; // hits scoring below this are dropped
+	size_t NeighbourWords = 8; // words after the vtable pointer checked for plausible members
+	size_t MaxWindowSize = 0x400; // largest window read per hit when looking for secondary vtables
+};
+
+/**
+ * Scores instance hits after a scan. Every hit is classified by the region it lives in (module image, heap,
+ * thread stack or mapped view), whether that region is writable, whether the words following the vtable pointer
+ * look like members, and whether the secondary vtables of the class sit at their COL offsets.
+ * All windows are fetched with one batched read.
+ */
+class FInstanceValidator
+{
+public:
+	FInstanceValidator(FTargetProcess* InProcess, const std::vector<std::shared_ptr<ClassMetaData>>& Classes, const FInstanceValidationSettings& InSettings);
+
+	// scores every hit and removes the ones below the threshold, returns the number of hits removed
+	size_t Validate(std::vector<FInstanceHit>& Hits);
+
+	static const char* GetRegionName(EInstanceRegion Region);
+
+protected:
+	const FMemoryRange* FindRange(uintptr_t Address) const;
+	EInstanceRegion ClassifyRegion(uintptr_t Address, const FMemoryRange* Range) const;
+	bool IsPlausibleMember(uintptr_t Value) const;
+	static bool IsFloatLike(uint32_t Value);
+
+	uint8_t Score(FInstanceHit& Hit, const uint8_t* Window, size_t WindowSize) const;
+
+	FTargetProcess* Process = nullptr;
+	FInstanceValidationSettings Settings;
+
+	std::vector<FMemoryRange> Ranges; // sorted by start
+	std::vector<FMemoryRange> Stacks; // sorted by start
+
+	// complete class -> (offset, vtable) of each secondary vtable
+	std::unordered_map<const ClassMetaData*, std::vector<std::pair<uintptr_t, uintptr_t>>> SecondaryVTables;
+};
@@ -0,0 +1,313 @@
+#include "JsonExporter.h"
+#include "RTTI.h"
+
+namespace
+{
+	const char* GetSlotStatusName(ESlotStatus Status)
+	{
+		switch (Status)
+		{
+		case ESlotStatus::Inherited: return "inherited";
+		case ESlotStatus::Overridden: return "overridden";
+		default: return "introduced";
+		}
+	}
+
+	bool NeedsEscape(char Character)
+	{
+		return Character == '"' || Character == '\\' || static_cast<unsigned char>(Character) < 0x20;
+	}
+}
+
+FJsonExporter::FJsonExporter(RTTI& InTarget)
+	: Target(InTarget), Functions(InTarget.GetFunctionTable()), ModuleBase(InTarget.GetLoadAddress()),
+	ModuleEnd(InTarget.GetLoadAddress() + InTarget.GetSizeOfImage())
+{
+}
+
+bool FJsonExporter::Export(const std::string& Path)
+{
+	if (!Out.Open(Path))
+	{
+		return false;
+	}
+
+	const std::vector<std::shared_ptr<ClassMetaData>> Classes = Target.GetClasses();
+
+	WriteModule(Classes.size());
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		WriteClass(CMeta);
+	}
+
+	Stats.BytesWritten = Out.GetBytesWritten();
+	return Out.Close();
+}
+
+bool FJsonExporter::Benchmark(const std::string& Path, size_t NumRecords)
+{
+	const std::vector<std::shared_ptr<ClassMetaData>> Classes = Target.GetClasses();
+	if (Classes.empty() || !Out.Open(Path))
+	{
+		return false;
+	}
+
+	WriteModule(NumRecords);
+	for (size_t i = 0; i < NumRecords; i++)
+	{
+		WriteClass(Classes[i % Classes.size()]);
+	}
+
+	Stats.BytesWritten = Out.GetBytesWritten();
+	return Out.Close();
+}
+
+void FJsonExporter::WriteModule(size_t NumClasses)
+{
+	Out.Write("{\"type\":\"module\"");
+	WriteKey("version");
+	Out.WriteDecimal(FormatVersion);
+	WriteKey("name");
+	WriteString(Target.GetModuleName());
+	WriteKey("base");
+	Out.WriteDecimal(ModuleBase);
+	WriteKey("pointer_size");
+	Out.WriteDecimal(sizeof(uintptr_t));
+	WriteKey("classes");
+	Out.WriteDecimal(NumClasses);
+	WriteKey("functions");
+	Out.WriteDecimal(Functions.GetNumFunctions());
+	Out.Write("}\n");
+}
+
+void FJsonExporter::WriteClass(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	Out.Write("{\"type\":\"class\"");
+	WriteKey("id");
+	Out.WriteDecimal(CMeta->ClassID);
+	WriteKey("name");
+	WriteString(CMeta->Name);
+	WriteKey("mangled_name");
+	WriteString(CMeta->MangledName);
+	WriteKey("vtable_rva");
+	Out.WriteDecimal(CMeta->VTable - ModuleBase);
+	WriteKey("col_rva");
+	Out.WriteDecimal(CMeta->CompleteObjectLocator - ModuleBase);
+	WriteKey("type_descriptor_rva");
+	Out.WriteDecimal(CMeta->TypeDescriptor - ModuleBase);
+	WriteKey("vtable_offset");
+	Out.WriteDecimal(CMeta->VTableOffset);
+	WriteKey("cd_offset");
+	Out.WriteDecimal(CMeta->ConstructorDisplacementOffset);
+
+	if (std::shared_ptr<ClassMetaData> Complete = Target.GetCompleteClass(CMeta); Complete && Complete != CMeta)
+	{
+		WriteKey("complete_id");
+		Out.WriteDecimal(Complete->ClassID);
+	}
+
+	WriteKey("flags");
+	Out.Write('[');
+	char Separator = 0;
+	auto WriteFlag = [&](bool bSet, std::string_view Flag)
+		{
+			if (!bSet) return;
+			if (Separator) Out.Write(Separator);
+			Out.Write('"');
+			Out.Write(Flag);
+			Out.Write('"');
+			Separator = ',';
+		};
+	WriteFlag(CMeta->bMultipleInheritance, "multiple_inheritance");
+	WriteFlag(CMeta->bVirtualInheritance, "virtual_inheritance");
+	WriteFlag(CMeta->bAmbigious, "ambiguous");
+	WriteFlag(CMeta->bStruct, "struct");
+	WriteFlag(CMeta->bInterface, "interface");
+	Out.Write(']');
+
+	if (CMeta->ObjectSize > 0)
+	{
+		WriteKey("object_size");
+		Out.WriteDecimal(CMeta->ObjectSize);
+		WriteKey("object_size_source");
+		WriteString(RTTI::GetObjectSizeSourceName(CMeta->ObjectSizeSource));
+	}
+
+	WriteParents(CMeta);
+	WriteFunctions(CMeta);
+	WriteFunctionRVAs("constructors", CMeta->Constructors);
+	WriteFunctionRVAs("destructors", CMeta->Destructors);
+	WriteReferences(CMeta);
+	WriteInstances(CMeta);
+
+	Out.Write("}\n");
+	Stats.NumClasses++;
+}
+
+void FJsonExporter::WriteParents(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	WriteKey("parents");
+	Out.Write('[');
+
+	for (size_t i = 0; i < CMeta->Parents.size(); i++)
+	{
+		const ParentClass& Parent = *CMeta->Parents[i];
+		Out.Write(i == 0 ? "{\"name\":" : ",{\"name\":");
+		WriteString(Parent.Name);
+		WriteKey("mangled_name");
+		WriteString(Parent.MangledName);
+		WriteKey("depth");
+		Out.WriteDecimal(Parent.TreeDepth);
+		WriteKey("contained_bases");
+		Out.WriteDecimal(Parent.numContainedBases);
+		WriteKey("mdisp");
+		Out.WriteDecimal(Parent.where.mdisp);
+		WriteKey("pdisp");
+		Out.WriteDecimal(Parent.where.pdisp);
+		WriteKey("vdisp");
+		Out.WriteDecimal(Parent.where.vdisp);
+		WriteKey("attributes");
+		Out.WriteDecimal(Parent.attributes);
+		Out.Write('}');
+	}
+
+	Out.Write(']');
+}
+
+void FJsonExporter::WriteFunctions(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	WriteKey("functions");
+	Out.Write('[');
+
+	const FVTableView VTable = Functions.GetVTable(CMeta->ClassID);
+	for (uint32_t Slot = 0; Slot < VTable.size(); Slot++)
+	{
+		const uint32_t FunctionIndex = VTable[Slot];
+		Out.Write(Slot == 0 ? "{\"slot\":" : ",{\"slot\":");
+		Out.WriteDecimal(Slot);
+		WriteKey("rva");
+		Out.WriteDecimal(Functions.GetAddress(FunctionIndex) - ModuleBase);
+		WriteKey("name");
+		WriteString(Target.GetFunctionName(FunctionIndex));
+		WriteKey("status");
+		WriteString(GetSlotStatusName(Functions.GetSlotStatus(CMeta->ClassID, Slot)));
+
+		if (const uint32_t Size = Functions.GetSize(FunctionIndex))
+		{
+			WriteKey("size");
+			Out.WriteDecimal(Size);
+		}
+
+		Out.Write('}');
+	}
+
+	Out.Write(']');
+	Stats.NumFunctions += VTable.size();
+}
+
+void FJsonExporter::WriteReferences(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	// an rva of code in another module would wrap around, those are written as they are
+	auto WriteList = [&](const char* Key, bool bInModule)
+	{
+		WriteKey(Key);
+		Out.Write('[');
+
+		bool bFirst = true;
+		for (uintptr_t Address : CMeta->CodeReferences)
+		{
+			if ((Address >= ModuleBase && Address < ModuleEnd) != bInModule)
+			{
+				continue;
+			}
+
+			if (!bFirst) Out.Write(',');
+			Out.WriteDecimal(bInModule ? Address - ModuleBase : Address);
+			bFirst = false;
+		}
+
+		Out.Write(']');
+	};
+
+	WriteList("references", true);
+	WriteList("external_references", false);
+	Stats.NumReferences += CMeta->CodeReferences.size();
+}
+
+void FJsonExporter::WriteFunctionRVAs(const char* Key, const std::vector<uint32_t>& FunctionIndices)
+{
+	WriteKey(Key);
+	Out.Write('[');
+
+	for (size_t i = 0; i < FunctionIndices.size(); i++)
+	{
+		if (i > 0) Out.Write(',');
+		Out.WriteDecimal(Functions.GetAddress(FunctionIndices[i]) - ModuleBase);
+	}
+
+	Out.Write(']');
+}
+
+void FJsonExporter::WriteInstances(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	WriteKey("instances");
+	Out.Write('[');
+
+	for (size_t i = 0; i < CMeta->ClassInstances.size(); i++)
+	{
+		const FClassInstance& Instance = CMeta->ClassInstances[i];
+		Out.Write(i == 0 ? "{\"address\":" : ",{\"address\":");
+		Out.WriteDecimal(Instance.Address);
+		WriteKey("confidence");
+		Out.WriteDecimal(Instance.Confidence);
+		WriteKey("region");
+		WriteString(FInstanceValidator::GetRegionName(Instance.Region));
+		Out.Write('}');
+	}
+
+	Out.Write(']');
+	Stats.NumInstances += CMeta->ClassInstances.size();
+}
+
+void FJsonExporter::WriteKey(const char* Key)
+{
+	Out.Write(",\"");
+	Out.Write(Key);
+	Out.Write("\":");
+}
+
+void FJsonExporter::WriteString(std::string_view Text)
+{
+	static const char HexDigits[] = "0123456789abcdef";
+
+	Out.Write('"');
+
+	// runs of plain characters are copied in one go, names almost never need escaping
+	size_t RunStart = 0;
+	for (size_t i = 0; i < Text.size(); i++)
+	{
+		const char Character = Text[i];
+		if (!NeedsEscape(Character))
+		{
+			continue;
+		}
+
+		Out.Write(Text.substr(RunStart, i - RunStart));
+		RunStart = i + 1;
+
+		if (Character == '"' || Character == '\\')
+		{
+			Out.Write('\\');
+			Out.Write(Character);
+		}
+		else
+		{
+			Out.Write("\\u00");
+			Out.Write(HexDigits[(Character >> 4) & 0xF]);
+			Out.Write(HexDigits[Character & 0xF]);
+		}
+	}
+
+	Out.Write(Text.substr(RunStart));
+	Out.Write('"');
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "../Util/BufferedWriter.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+class RTTI;
+class FFunctionTable;
+struct ClassMetaData;
+
+struct FJsonExportStats
+{
+	size_t NumClasses = 0;
+	size_t NumFunctions = 0;
+	size_t NumReferences = 0;
+	size_t NumInstances = 0;
+	uint64_t BytesWritten = 0;
+};
+
+/**
+ * Streams the class database as newline delimited JSON. The first line describes the module, every
+ * following line is one vtable with its names, RVAs, flags, parents and their PMD, virtual functions,
+ * constructors, code references and instances. Addresses inside the module are written as RVAs,
+ * instances and code references into other modules as absolute addresses.
+ * Records are formatted straight into the writer's buffer, so memory use does not depend on the
+ * number of classes.
+ */
+class FJsonExporter
+{
+public:
+	static constexpr uint32_t FormatVersion = 2;
+
+	explicit FJsonExporter(RTTI& InTarget);
+
+	bool Export(const std::string& Path);
+
+	// writes NumRecords class records, cycling through the classes, to measure throughput on large databases
+	bool Benchmark(const std::string& Path, size_t NumRecords);
+
+	const FJsonExportStats& GetStats() const { return Stats; }
+
+protected:
+	void WriteModule(size_t NumClasses);
+	void WriteClass(const std::shared_ptr<ClassMetaData>& CMeta);
+	void WriteParents(const std::shared_ptr<ClassMetaData>& CMeta);
+	void WriteFunctions(const std::shared_ptr<ClassMetaData>& CMeta);
+	void WriteReferences(const std::shared_ptr<ClassMetaData>& CMeta);
+	void WriteFunctionRVAs(const char* Key, const std::vector<uint32_t>& FunctionIndices);
+	void WriteInstances(const std::shared_ptr<ClassMetaData>& CMeta);
+
+	// ,"Key": every record starts with its type, so keys always follow another field
+	void WriteKey(const char* Key);
+	void WriteString(std::string_view Text);
+
+	RTTI& Target;
+	FFunctionTable& Functions;
+	uintptr_t ModuleBase = 0; // load address of the module, rva fields are relative to it on x86 and x64
+	uintptr_t ModuleEnd = 0;
+	FJsonExportStats Stats;
+	FBufferedWriter Out;
+};
@@ -0,0 +1,235 @@
+#include "LayoutSampler.h"
+#include <algorithm>
+#include <array>
+
+FLayoutSampler::FLayoutSampler(FTargetProcess* InProcess, const FAddressIndex& InVTables, const FLayoutSamplerSettings& InSettings)
+	: Process(InProcess), VTables(InVTables), Settings(InSettings)
+{
+	Ranges = Process->MemoryMap.Ranges;
+	std::sort(Ranges.begin(), Ranges.end(), [](const FMemoryRange& A, const FMemoryRange& B) { return A.Start < B.Start; });
+}
+
+std::vector<FFieldLayout> FLayoutSampler::Sample(std::vector<uintptr_t> Instances, size_t ObjectSize)
+{
+	constexpr size_t NumKinds = static_cast<size_t>(EFieldKind::SmallInt) + 1;
+
+	std::sort(Instances.begin(), Instances.end());
+	Instances.erase(std::unique(Instances.begin(), Instances.end()), Instances.end());
+
+	// spread the samples over the whole set instead of taking the lowest addresses
+	if (Instances.size() > Settings.MaxSamples)
+	{
+		std::vector<uintptr_t> Picked;
+		Picked.reserve(Settings.MaxSamples);
+		for (size_t i = 0; i < Settings.MaxSamples; i++)
+		{
+			Picked.push_back(Instances[i * Instances.size() / Settings.MaxSamples]);
+		}
+		Instances = std::move(Picked);
+	}
+
+	if (Instances.empty())
+	{
+		return {};
+	}
+
+	ObjectSize = ObjectSize ? ObjectSize : Settings.DefaultObjectSize;
+	ObjectSize = std::min(ObjectSize, Settings.MaxObjectSize) / sizeof(uintptr_t) * sizeof(uintptr_t);
+	const size_t NumFields = ObjectSize / sizeof(uintptr_t);
+
+	std::vector<uint8_t> Objects = Process->ReadBatched(Instances, ObjectSize);
+
+	auto ReadField = [&](size_t Sample, size_t Field)
+		{
+			uintptr_t Value = 0;
+			memcpy(&Value, &Objects[Sample * ObjectSize + Field * sizeof(uintptr_t)], sizeof(uintptr_t));
+			return Value;
+		};
+
+	// every distinct pointer is probed once, with one batched read
+	std::vector<uintptr_t> Pointers;
+	for (size_t Sample = 0; Sample < Instances.size(); Sample++)
+	{
+		for (size_t Field = 0; Field < NumFields; Field++)
+		{
+			const uintptr_t Value = ReadField(Sample, Field);
+			if (VTables.Find(Value) == FAddressIndex::InvalidIndex && FindRange(Value))
+			{
+				Pointers.push_back(Value);
+			}
+		}
+	}
+
+	std::sort(Pointers.begin(), Pointers.end());
+	Pointers.erase(std::unique(Pointers.begin(), Pointers.end()), Pointers.end());
+
+	const std::vector<uint8_t> Probes = Process->ReadBatched(Pointers, Settings.ProbeSize);
+
+	std::vector<FPointee> Pointees(Pointers.size());
+	for (size_t i = 0; i < Pointers.size(); i++)
+	{
+		Pointees[i] = ClassifyPointee(*FindRange(Pointers[i]), &Probes[i * Settings.ProbeSize]);
+	}
+
+	std::vector<FFieldLayout> Layout;
+	Layout.reserve(NumFields);
+
+	for (size_t Field = 0; Field < NumFields; Field++)
+	{
+		std::array<size_t, NumKinds> Votes = {};
+		std::array<uintptr_t, NumKinds> Examples = {};
+		std::array<uint32_t, NumKinds> ClassIDs;
+		ClassIDs.fill(FAddressIndex::InvalidIndex);
+
+		bool bSameValue = true;
+		const uintptr_t FirstValue = ReadField(0, Field);
+
+		for (size_t Sample = 0; Sample < Instances.size(); Sample++)
+		{
+			const uintptr_t Value = ReadField(Sample, Field);
+			bSameValue &= Value == FirstValue;
+
+			EFieldKind Kind = EFieldKind::Unknown;
+			uint32_t ClassID = FAddressIndex::InvalidIndex;
+
+			if (Value == 0)
+			{
+				Kind = EFieldKind::Zero;
+			}
+			else if ((ClassID = VTables.Find(Value)) != FAddressIndex::InvalidIndex)
+			{
+				Kind = EFieldKind::VTable;
+			}
+			else if (auto it = std::lower_bound(Pointers.begin(), Pointers.end(), Value); it != Pointers.end() && *it == Value)
+			{
+				const FPointee& Pointee = Pointees[it - Pointers.begin()];
+				Kind = Pointee.Kind;
+				ClassID = Pointee.ClassID;
+			}
+			else if (Value < 0x10000 || Value > static_cast<uintptr_t>(-0x10000))
+			{
+				Kind = EFieldKind::SmallInt;
+			}
+			else if (IsFloatLike(static_cast<uint32_t>(Value)) && (sizeof(uintptr_t) == 4 || IsFloatLike(static_cast<uint32_t>(static_cast<uint64_t>(Value) >> 32))))
+			{
+				Kind = EFieldKind::Float;
+			}
+
+			const size_t KindIndex = static_cast<size_t>(Kind);
+			if (Votes[KindIndex]++ == 0)
+			{
+				Examples[KindIndex] = Value;
+				ClassIDs[KindIndex] = ClassID;
+			}
+		}
+
+		FFieldLayout& Member = Layout.emplace_back();
+		Member.Offset = static_cast<uint32_t>(Field * sizeof(uintptr_t));
+
+		// a null pointer in some samples does not make the field any less of a pointer
+		size_t Best = static_cast<size_t>(EFieldKind::Zero);
+		for (size_t Kind = 0; Kind < NumKinds; Kind++)
+		{
+			if (Kind != static_cast<size_t>(EFieldKind::Zero) && Votes[Kind] > 0 && (Best == static_cast<size_t>(EFieldKind::Zero) || Votes[Kind] > Votes[Best]))
+			{
+				Best = Kind;
+			}
+		}
+
+		Member.Kind = static_cast<EFieldKind>(Best);
+		Member.Example = Examples[Best];
+		Member.ClassID = ClassIDs[Best];
+		Member.Agreement = static_cast<uint8_t>(100 * (Votes[Best] + (Best != static_cast<size_t>(EFieldKind::Zero) ? Votes[static_cast<size_t>(EFieldKind::Zero)] : 0)) / Instances.size());
+
+		if (bSameValue && Instances.size() > 1 && (Member.Kind == EFieldKind::SmallInt || Member.Kind == EFieldKind::Float || Member.Kind == EFieldKind::Unknown))
+		{
+			Member.Kind = EFieldKind::Constant;
+		}
+	}
+
+	return Layout;
+}
+
+const char* FLayoutSampler::GetFieldKindName(EFieldKind Kind)
+{
+	switch (Kind)
+	{
+	case EFieldKind::Zero: return "zero";
+	case EFieldKind::Constant: return "constant";
+	case EFieldKind::VTable: return "vtable";
+	case EFieldKind::ClassPointer: return "object pointer";
+	case EFieldKind::StringPointer: return "string pointer";
+	case EFieldKind::ModulePointer: return "module pointer";
+	case EFieldKind::HeapPointer: return "pointer";
+	case EFieldKind::Float: return "float";
+	case EFieldKind::SmallInt: return "integer";
+	default: return "unknown";
+	}
+}
+
+const FMemoryRange* FLayoutSampler::FindRange(uintptr_t Address) const
+{
+	auto it = std::upper_bound(Ranges.begin(), Ranges.end(), Address, [](uintptr_t Value, const FMemoryRange& Range) { return Value < Range.Start; });
+	if (it == Ranges.begin())
+	{
+		return nullptr;
+	}
+
+	--it;
+	return Address < it->End ? &*it : nullptr;
+}
+
+FLayoutSampler::FPointee FLayoutSampler::ClassifyPointee(const FMemoryRange& Range, const uint8_t* Probe) const
+{
+	FPointee Pointee;
+
+	uintptr_t FirstWord = 0;
+	memcpy(&FirstWord, Probe, sizeof(uintptr_t));
+
+	if ((Pointee.ClassID = VTables.Find(FirstWord)) != FAddressIndex::InvalidIndex)
+	{
+		Pointee.Kind = EFieldKind::ClassPointer;
+	}
+	else if (!Range.bExecutable && IsText(Probe, Settings.ProbeSize))
+	{
+		Pointee.Kind = EFieldKind::StringPointer;
+	}
+	else if (Range.Type == MEM_IMAGE)
+	{
+		Pointee.Kind = EFieldKind::ModulePointer;
+	}
+
+	return Pointee;
+}
+
+bool FLayoutSampler::IsFloatLike(uint32_t Value)
+{
+	const uint32_t Exponent = (Value >> 23) & 0xFF;
+	return Value == 0 || (Exponent >= 100 && Exponent <= 154);
+}
+
+bool FLayoutSampler::IsText(const uint8_t* Data, size_t Size)
+{
+	constexpr size_t MinLength = 4;
+
+	auto IsPrintable = [](uint8_t Char) { return (Char >= 0x20 && Char < 0x7F) || Char == '\t' || Char == '\n' || Char == '\r'; };
+
+	// ASCII / UTF-8 with a plain prefix
+	size_t Length = 0;
+	while (Length < Size && IsPrintable(Data[Length]))
+	{
+		Length++;
+	}
+	if (Length >= MinLength && (Length == Size || Data[Length] == 0))
+	{
+		return true;
+	}
+
+	// UTF-16 with ASCII characters
+	Length = 0;
+	while (Length + 1 < Size && IsPrintable(Data[Length]) && Data[Length + 1] == 0)
+	{
+		Length += 2;
+	}
+	return Length / 2 >= MinLength;
+}
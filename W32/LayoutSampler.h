@@ -0,0 +1,69 @@
+#pragma once
+#include "Memory.h"
+#include "../Util/AddressIndex.h"
+
+enum class EFieldKind : uint8_t
+{
+	Unknown,
+	Zero, // null in every sample
+	Constant, // the same non-pointer value in every sample
+	VTable, // a vtable of a known class, a secondary vtable pointer or an embedded object
+	ClassPointer, // points to an object whose first word is a known vtable
+	StringPointer, // points to ASCII or UTF-16 text
+	ModulePointer, // points into a module image, functions or global data
+	HeapPointer, // points to other readable memory
+	Float, // one or two IEEE floats in the usual range
+	SmallInt // small integers, flags, enums and small negative numbers
+};
+
+struct FFieldLayout
+{
+	uint32_t Offset = 0;
+	EFieldKind Kind = EFieldKind::Unknown;
+	uint8_t Agreement = 0; // percent of the samples classified as Kind
+	uintptr_t Example = 0; // value of the first sample of that kind
+	uint32_t ClassID = FAddressIndex::InvalidIndex; // class of the vtable, or of the pointee for ClassPointer
+};
+
+struct FLayoutSamplerSettings
+{
+	size_t MaxSamples = 64; // instances read per class
+	size_t DefaultObjectSize = 0x100; // bytes sampled when the object size is unknown
+	size_t MaxObjectSize = 0x1000;
+	size_t ProbeSize = 16; // bytes read behind every pointer to recognise objects and strings
+};
+
+/**
+ * Infers the member layout of a class from live instances. Every pointer sized field is classified in
+ * each sample and the kind most samples agree on is reported. The objects are fetched with one batched
+ * read, and the targets of every pointer field with a second one, so the cost does not grow with the
+ * number of fields.
+ */
+class FLayoutSampler
+{
+public:
+	FLayoutSampler(FTargetProcess* InProcess, const FAddressIndex& InVTables, const FLayoutSamplerSettings& InSettings);
+
+	// ObjectSize 0 samples Settings.DefaultObjectSize bytes
+	std::vector<FFieldLayout> Sample(std::vector<uintptr_t> Instances, size_t ObjectSize);
+
+	static const char* GetFieldKindName(EFieldKind Kind);
+
+protected:
+	struct FPointee
+	{
+		EFieldKind Kind = EFieldKind::HeapPointer;
+		uint32_t ClassID = FAddressIndex::InvalidIndex;
+	};
+
+	const FMemoryRange* FindRange(uintptr_t Address) const;
+	FPointee ClassifyPointee(const FMemoryRange& Range, const uint8_t* Probe) const;
+	static bool IsFloatLike(uint32_t Value);
+	static bool IsText(const uint8_t* Data, size_t Size);
+
+	FTargetProcess* Process = nullptr;
+	const FAddressIndex& VTables;
+	FLayoutSamplerSettings Settings;
+
+	std::vector<FMemoryRange> Ranges; // sorted by start
+};
@@ -1,5 +1,5 @@
 #include "Memory.h"
-#include "../ClassDumper3.h"
+#include "../Util/Log.h"
 
 #pragma comment(lib, "advapi32.lib")
 #pragma comment(lib, "psapi.lib")
@@ -174,7 +174,7 @@ FProcess::FProcess(DWORD InPID) : PID(InPID)
 	}
 	else
 	{
-		ClassDumper3::LogF("Failed to open process - error code: %u", GetLastError());
+		FLog::WriteF("Failed to open process - error code: %u", GetLastError());
 		return;
 	}
 }
@@ -185,7 +185,7 @@ FProcess::FProcess(const std::string& InProcessName)
 	ProcessHandle = OpenProcess(PROCESS_ALL_ACCESS, FALSE, PID);
 	if (ProcessHandle == INVALID_HANDLE_VALUE)
 	{
-		ClassDumper3::LogF("Failed to open process %s", InProcessName.c_str());
+		FLog::WriteF("Failed to open process %s", InProcessName.c_str());
 		return;
 	}
 	char szProcessName[MAX_PATH] = "<unknown>";
@@ -270,14 +270,15 @@ FMemoryMap::FMemoryMap(const FProcess& Process)
 		{
 			Ranges.push_back(FMemoryRange((uintptr_t)MBI.BaseAddress, (uintptr_t)MBI.BaseAddress + MBI.RegionSize, (MBI.Protect & ExecuteFlags),
 										  MBI.Protect & ReadFlags, MBI.Protect & WriteFlags));
+			Ranges.back().Type = MBI.Type;
 		}
 	}
 	if (Ranges.empty())
 	{
-		ClassDumper3::LogF("Failed to get memory ranges error code: %u", GetLastError());
+		FLog::WriteF("Failed to get memory ranges error code: %u", GetLastError());
 	}
 
-	ClassDumper3::LogF("Found %u memory regions", Ranges.size());
+	FLog::WriteF("Found %u memory regions", Ranges.size());
 }
 
 FMemoryBlock::FMemoryBlock(void* InAddress, size_t InSize) : Address(InAddress), Size(InSize), Copy(InSize) {}
@@ -319,7 +320,7 @@ FModule::FModule(void* InBaseAddress, const std::vector<FModuleSection>& InSecti
 {
 }
 
-FModule::FModule(const FModule& Other) : BaseAddress(Other.BaseAddress), Sections(Other.Sections), Name(Other.Name) {}
+FModule::FModule(const FModule& Other) : BaseAddress(Other.BaseAddress), Sections(Other.Sections), Name(Other.Name), Path(Other.Path) {}
 
 FModuleMap::FModuleMap(const FProcess& Process)
 {
@@ -376,6 +377,7 @@ FModule FModuleMap::ParseModule(const FProcess& Process, const MODULEENTRY32& En
 	FModule Module;
 	Module.BaseAddress = Entry.modBaseAddr;
 	Module.Name = Entry.szModule;
+	Module.Path = Entry.szExePath;
 	Module.Sections = ParseSections(Process, Entry);
 	return Module;
 }
@@ -540,6 +542,95 @@ std::vector<std::future<FMemoryBlock>> FTargetProcess::AsyncGetExecutableMemory(
 	return Futures;
 }
 
+std::vector<FMemoryRange> FTargetProcess::GetReadableRanges() const
+{
+	std::vector<FMemoryRange> Ranges;
+	std::copy_if(MemoryMap.Ranges.begin(), MemoryMap.Ranges.end(), std::back_inserter(Ranges),
+		[](const FMemoryRange& Range) { return Range.bReadable && !Range.bExecutable; });
+	return Ranges;
+}
+
+std::vector<FMemoryRange> FTargetProcess::GetExecutableRanges() const
+{
+	std::vector<FMemoryRange> Ranges;
+	std::copy_if(MemoryMap.Ranges.begin(), MemoryMap.Ranges.end(), std::back_inserter(Ranges),
+		[](const FMemoryRange& Range) { return Range.bExecutable; });
+	return Ranges;
+}
+
+std::vector<FMemoryRange> FTargetProcess::GetThreadStackRanges() const
+{
+	struct FThreadBasicInformation
+	{
+		NTSTATUS ExitStatus;
+		PVOID TebBaseAddress;
+		PVOID ClientId[2];
+		ULONG_PTR AffinityMask;
+		LONG Priority;
+		LONG BasePriority;
+	};
+
+	using NtQueryInformationThreadFn = NTSTATUS(__stdcall*)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+
+	std::vector<FMemoryRange> Stacks;
+
+	HMODULE NTDLL = GetModuleHandleA("ntdll.dll");
+	if (!NTDLL)
+	{
+		return Stacks;
+	}
+
+	auto NtQueryInformationThread = (NtQueryInformationThreadFn)GetProcAddress(NTDLL, "NtQueryInformationThread");
+	if (!NtQueryInformationThread)
+	{
+		return Stacks;
+	}
+
+	HANDLE Snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+	if (Snapshot == INVALID_HANDLE_VALUE)
+	{
+		return Stacks;
+	}
+
+	THREADENTRY32 Entry = { sizeof(THREADENTRY32) };
+	for (BOOL bEntry = Thread32First(Snapshot, &Entry); bEntry; bEntry = Thread32Next(Snapshot, &Entry))
+	{
+		if (Entry.th32OwnerProcessID != Process.PID)
+		{
+			continue;
+		}
+
+		HANDLE Thread = OpenThread(THREAD_QUERY_INFORMATION, FALSE, Entry.th32ThreadID);
+		if (!Thread)
+		{
+			continue;
+		}
+
+		FThreadBasicInformation BasicInformation{};
+		NT_TIB Tib{};
+
+		// ThreadBasicInformation = 0
+		if (NtQueryInformationThread(Thread, 0, &BasicInformation, sizeof(BasicInformation), nullptr) >= 0
+			&& ReadProcessMemory(Process.ProcessHandle, BasicInformation.TebBaseAddress, &Tib, sizeof(Tib), nullptr))
+		{
+			// the TIB only knows the committed part, the whole reservation belongs to the stack
+			MEMORY_BASIC_INFORMATION MBI{};
+			uintptr_t StackStart = (uintptr_t)Tib.StackLimit;
+			if (VirtualQueryEx(Process.ProcessHandle, Tib.StackLimit, &MBI, sizeof(MBI)))
+			{
+				StackStart = (uintptr_t)MBI.AllocationBase;
+			}
+
+			Stacks.emplace_back(StackStart, (uintptr_t)Tib.StackBase, false, true, true);
+		}
+
+		CloseHandle(Thread);
+	}
+
+	CloseHandle(Snapshot);
+	return Stacks;
+}
+
 void FTargetProcess::Read(uintptr_t Address, void* Buffer, size_t Size)
 {
 	if (!ReadProcessMemory(Process.ProcessHandle, reinterpret_cast<void*>(Address), Buffer, Size, NULL))
@@ -548,6 +639,54 @@ void FTargetProcess::Read(uintptr_t Address, void* Buffer, size_t Size)
 	}
 }
 
+std::vector<uint8_t> FTargetProcess::ReadBatched(const std::vector<uintptr_t>& Addresses, size_t WindowSize, size_t MaxGap)
+{
+	constexpr size_t MaxSpanSize = 0x100000;
+	std::vector<uint8_t> Output(Addresses.size() * WindowSize, 0);
+	std::vector<uint8_t> SpanBuffer;
+
+	size_t First = 0;
+	while (First < Addresses.size())
+	{
+		// grow the span while the next window starts close to the end of the current one
+		size_t Last = First;
+		uintptr_t SpanStart = Addresses[First];
+		uintptr_t SpanEnd = SpanStart + WindowSize;
+
+		while (Last + 1 < Addresses.size()
+			&& Addresses[Last + 1] <= SpanEnd + MaxGap
+			&& Addresses[Last + 1] + WindowSize - SpanStart <= MaxSpanSize)
+		{
+			Last++;
+			SpanEnd = std::max(SpanEnd, Addresses[Last] + WindowSize);
+		}
+
+		SpanBuffer.resize(SpanEnd - SpanStart);
+		if (ReadProcessMemory(Process.ProcessHandle, reinterpret_cast<void*>(SpanStart), SpanBuffer.data(), SpanBuffer.size(), nullptr))
+		{
+			for (size_t i = First; i <= Last; i++)
+			{
+				memcpy(&Output[i * WindowSize], &SpanBuffer[Addresses[i] - SpanStart], WindowSize);
+			}
+		}
+		else
+		{
+			// part of the span is not readable, fall back to the individual windows
+			for (size_t i = First; i <= Last; i++)
+			{
+				if (!ReadProcessMemory(Process.ProcessHandle, reinterpret_cast<void*>(Addresses[i]), &Output[i * WindowSize], WindowSize, nullptr))
+				{
+					memset(&Output[i * WindowSize], 0, WindowSize);
+				}
+			}
+		}
+
+		First = Last + 1;
+	}
+
+	return Output;
+}
+
 std::future<std::vector<uint8_t>> FTargetProcess::AsyncRead(uintptr_t Address, size_t Size)
 {
 	return std::async(std::launch::async,
@@ -68,6 +68,7 @@ struct FMemoryRange {
 	bool bExecutable = false;
 	bool bReadable = false;
 	bool bWritable = false;
+	DWORD Type = 0; // MEM_IMAGE, MEM_MAPPED or MEM_PRIVATE
 
 	FMemoryRange() = default;
 	FMemoryRange(uintptr_t InStart, uintptr_t InEnd, bool InbExecutable, bool InbReadable, bool InbWritable);
@@ -127,6 +128,7 @@ struct FModule
 	void* BaseAddress = nullptr;
 	std::vector<FModuleSection> Sections;
 	std::string Name;
+	std::string Path;
 };
 
 struct FModuleMap {
@@ -173,9 +175,18 @@ struct FTargetProcess {
 	std::vector<FMemoryBlock> GetReadableMemoryBlocking();
 	std::vector<std::future<FMemoryBlock>> AsyncGetReadableMemory();
 	std::vector<std::future<FMemoryBlock>> AsyncGetExecutableMemory();
+	std::vector<FMemoryRange> GetReadableRanges() const;
+	std::vector<FMemoryRange> GetExecutableRanges() const;
+	std::vector<FMemoryRange> GetThreadStackRanges() const;
 
 	void Read(uintptr_t Address, void* Buffer, size_t Size);
 
+	/**
+	 * Reads WindowSize bytes at every address in sorted Addresses, coalescing windows that lie close together
+	 * into a single ReadProcessMemory call. Returns Addresses.size() * WindowSize bytes, unreadable windows are zeroed
+	 */
+	std::vector<uint8_t> ReadBatched(const std::vector<uintptr_t>& Addresses, size_t WindowSize, size_t MaxGap = 0x1000);
+
 	std::future<std::vector<uint8_t>> AsyncRead(uintptr_t Address, size_t Size);
 
 	template<typename T>
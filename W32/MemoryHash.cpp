@@ -0,0 +1,65 @@
+#include "MemoryHash.h"
+#include <algorithm>
+
+std::vector<FMemoryRange> FBlockHash::Diff(const FBlockHash& Other) const
+{
+	std::vector<FMemoryRange> Changes;
+
+	// blocks at different addresses are compared page by page from their start
+	const size_t NumPages = std::max(PageHashes.size(), Other.PageHashes.size());
+	for (size_t Page = 0; Page < NumPages; Page++)
+	{
+		const bool bChanged = Page >= PageHashes.size()
+			|| Page >= Other.PageHashes.size()
+			|| PageHashes[Page] != Other.PageHashes[Page];
+
+		if (!bChanged)
+		{
+			continue;
+		}
+
+		const uintptr_t Start = Address + Page * FHash::PageSize;
+		const uintptr_t End = Address + std::min((Page + 1) * FHash::PageSize, std::max(Size, Other.Size));
+
+		if (!Changes.empty() && Changes.back().End == Start)
+		{
+			Changes.back().End = End;
+			continue;
+		}
+
+		Changes.emplace_back(Start, End, false, true, false);
+	}
+
+	return Changes;
+}
+
+FBlockHash HashMemoryBlock(const FMemoryBlock& Block, size_t NumThreads)
+{
+	FBlockHash Hash;
+	Hash.Address = reinterpret_cast<uintptr_t>(Block.Address);
+	Hash.Size = Block.Copy.size();
+	Hash.PageHashes = FHash::HashPages(Block.Copy.data(), Block.Copy.size(), NumThreads);
+	Hash.Hash = FHash::HashPageArray(Hash.PageHashes, Hash.Size);
+	return Hash;
+}
+
+std::vector<FSectionHash> HashModuleSections(FTargetProcess* Process, const FModule& Module, size_t NumThreads)
+{
+	std::vector<FSectionHash> Hashes;
+
+	for (const FModuleSection& Section : Module.Sections)
+	{
+		// discardable sections such as .reloc are often no longer mapped
+		FMemoryBlock Block(Section.Start, Section.Size());
+		if (!Block.IsValid() || !ReadProcessMemory(Process->Process.ProcessHandle, Block.Address, Block.Copy.data(), Block.Size, NULL))
+		{
+			continue;
+		}
+
+		FSectionHash& Hash = Hashes.emplace_back();
+		Hash.Name = Section.Name;
+		Hash.Block = HashMemoryBlock(Block, NumThreads);
+	}
+
+	return Hashes;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Memory.h"
+#include "../Util/Hash.h"
+
+// page hashes of a copy of target memory, compared against an older copy to find what changed
+struct FBlockHash
+{
+	uintptr_t Address = 0;
+	size_t Size = 0;
+	FHash128 Hash; // over the page hashes, see FHash::HashPageArray
+	std::vector<uint64_t> PageHashes; // FHash::PageSize bytes each
+
+	// merged ranges of pages that differ, pages only one of the blocks covers count as changed
+	std::vector<FMemoryRange> Diff(const FBlockHash& Other) const;
+};
+
+struct FSectionHash
+{
+	std::string Name;
+	FBlockHash Block;
+};
+
+FBlockHash HashMemoryBlock(const FMemoryBlock& Block, size_t NumThreads = 0);
+
+// reads and hashes every section of the module, sections that cannot be read are skipped
+std::vector<FSectionHash> HashModuleSections(FTargetProcess* Process, const FModule& Module, size_t NumThreads = 0);
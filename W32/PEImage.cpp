@@ -0,0 +1,334 @@
+#include "PEImage.h"
+#include <algorithm>
+
+bool FPEImage::LoadFromProcess(FTargetProcess* Process, const FModule& Module)
+{
+	const uintptr_t Base = reinterpret_cast<uintptr_t>(Module.BaseAddress);
+	ImageBase = Base;
+
+	return Parse([Process, Base](uint32_t Rva, void* Buffer, size_t Size)
+		{
+			return ReadProcessMemory(Process->Process.ProcessHandle, reinterpret_cast<void*>(Base + Rva), Buffer, Size, nullptr) != FALSE;
+		});
+}
+
+bool FPEImage::LoadFromFile(const std::string& Path, uintptr_t RuntimeBase)
+{
+	ImageBase = RuntimeBase;
+
+	HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER FileSize{};
+	HANDLE Mapping = GetFileSizeEx(File, &FileSize) ? CreateFileMapping(File, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	if (!Mapping)
+	{
+		CloseHandle(File);
+		return false;
+	}
+
+	const uint8_t* View = static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!View)
+	{
+		CloseHandle(Mapping);
+		CloseHandle(File);
+		return false;
+	}
+
+	const size_t ViewSize = static_cast<size_t>(FileSize.QuadPart);
+
+	// the headers sit at file offset 0, everything else is found through the section table
+	bool bResult = Parse([this, View, ViewSize](uint32_t Rva, void* Buffer, size_t Size)
+		{
+			size_t Offset = Rva;
+			for (const IMAGE_SECTION_HEADER& Section : Sections)
+			{
+				if (Rva >= Section.VirtualAddress && Rva < Section.VirtualAddress + Section.SizeOfRawData)
+				{
+					Offset = Section.PointerToRawData + (Rva - Section.VirtualAddress);
+					break;
+				}
+			}
+
+			if (Offset + Size > ViewSize)
+			{
+				return false;
+			}
+
+			memcpy(Buffer, View + Offset, Size);
+			return true;
+		});
+
+	UnmapViewOfFile(View);
+	CloseHandle(Mapping);
+	CloseHandle(File);
+	return bResult;
+}
+
+bool FPEImage::Parse(const FReadFunction& Read)
+{
+	bValid = false;
+	Sections.clear();
+	Relocations.clear();
+	RuntimeFunctions.clear();
+
+	IMAGE_DOS_HEADER DosHeader{};
+	IMAGE_NT_HEADERS NtHeaders{};
+
+	if (!Read(0, &DosHeader, sizeof(DosHeader)) || DosHeader.e_magic != IMAGE_DOS_SIGNATURE)
+	{
+		return false;
+	}
+
+	if (!Read(DosHeader.e_lfanew, &NtHeaders, sizeof(NtHeaders)) || NtHeaders.Signature != IMAGE_NT_SIGNATURE)
+	{
+		return false;
+	}
+
+	SizeOfImage = NtHeaders.OptionalHeader.SizeOfImage;
+	TimeDateStamp = NtHeaders.FileHeader.TimeDateStamp;
+	CheckSum = NtHeaders.OptionalHeader.CheckSum;
+	memcpy(Directories, NtHeaders.OptionalHeader.DataDirectory, sizeof(Directories));
+
+	Sections.resize(NtHeaders.FileHeader.NumberOfSections);
+	const uint32_t SectionTable = DosHeader.e_lfanew + offsetof(IMAGE_NT_HEADERS, OptionalHeader) + NtHeaders.FileHeader.SizeOfOptionalHeader;
+	if (!Sections.empty() && !Read(SectionTable, Sections.data(), Sections.size() * sizeof(IMAGE_SECTION_HEADER)))
+	{
+		Sections.clear();
+		return false;
+	}
+
+	ParseRelocations(Read);
+
+	if (IsRunning64Bits())
+	{
+		ParseRuntimeFunctions(Read);
+	}
+
+	bValid = true;
+	return true;
+}
+
+void FPEImage::ParseRelocations(const FReadFunction& Read)
+{
+	const IMAGE_DATA_DIRECTORY& Directory = Directories[IMAGE_DIRECTORY_ENTRY_BASERELOC];
+	if (Directory.VirtualAddress == 0 || Directory.Size < sizeof(IMAGE_BASE_RELOCATION))
+	{
+		return;
+	}
+
+	std::vector<uint8_t> Data(Directory.Size);
+	if (!Read(Directory.VirtualAddress, Data.data(), Data.size()))
+	{
+		return;
+	}
+
+	constexpr WORD PointerFixup = sizeof(uintptr_t) == 8 ? IMAGE_REL_BASED_DIR64 : IMAGE_REL_BASED_HIGHLOW;
+	Relocations.reserve(Data.size() / sizeof(WORD));
+
+	size_t Offset = 0;
+	while (Offset + sizeof(IMAGE_BASE_RELOCATION) <= Data.size())
+	{
+		IMAGE_BASE_RELOCATION Block;
+		memcpy(&Block, &Data[Offset], sizeof(Block));
+
+		if (Block.SizeOfBlock < sizeof(IMAGE_BASE_RELOCATION) || Offset + Block.SizeOfBlock > Data.size())
+		{
+			break;
+		}
+
+		const size_t NumEntries = (Block.SizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(WORD);
+		const uint8_t* Entries = &Data[Offset + sizeof(IMAGE_BASE_RELOCATION)];
+
+		for (size_t i = 0; i < NumEntries; i++)
+		{
+			WORD Entry;
+			memcpy(&Entry, Entries + i * sizeof(WORD), sizeof(WORD));
+
+			if ((Entry >> 12) == PointerFixup)
+			{
+				Relocations.push_back(Block.VirtualAddress + (Entry & 0xFFF));
+			}
+		}
+
+		Offset += Block.SizeOfBlock;
+	}
+
+	// blocks are emitted per page in ascending order by the linker, but nothing guarantees it
+	if (!std::is_sorted(Relocations.begin(), Relocations.end()))
+	{
+		std::sort(Relocations.begin(), Relocations.end());
+	}
+	Relocations.erase(std::unique(Relocations.begin(), Relocations.end()), Relocations.end());
+}
+
+void FPEImage::ParseRuntimeFunctions(const FReadFunction& Read)
+{
+	constexpr uint8_t UnwindFlagChainInfo = 0x4;
+	constexpr size_t MaxChainDepth = 32;
+	constexpr size_t EntrySize = 3 * sizeof(DWORD); // BeginAddress, EndAddress, UnwindInfoAddress
+
+	const IMAGE_DATA_DIRECTORY& Directory = Directories[IMAGE_DIRECTORY_ENTRY_EXCEPTION];
+	if (Directory.VirtualAddress == 0 || Directory.Size < EntrySize)
+	{
+		return;
+	}
+
+	std::vector<DWORD> Entries(Directory.Size / sizeof(DWORD));
+	if (!Read(Directory.VirtualAddress, Entries.data(), Entries.size() * sizeof(DWORD)))
+	{
+		return;
+	}
+
+	const size_t NumEntries = Directory.Size / EntrySize;
+	uint32_t MinUnwind = UINT32_MAX;
+	uint32_t MaxUnwind = 0;
+
+	RuntimeFunctions.reserve(NumEntries);
+	std::vector<uint32_t> UnwindInfos;
+	UnwindInfos.reserve(NumEntries);
+
+	for (size_t i = 0; i < NumEntries; i++)
+	{
+		const DWORD Begin = Entries[i * 3];
+		const DWORD End = Entries[i * 3 + 1];
+		const DWORD Unwind = Entries[i * 3 + 2];
+
+		if (End <= Begin)
+		{
+			continue;
+		}
+
+		RuntimeFunctions.push_back({ Begin, End, Begin });
+		UnwindInfos.push_back(Unwind);
+		MinUnwind = std::min<uint32_t>(MinUnwind, Unwind);
+		MaxUnwind = std::max<uint32_t>(MaxUnwind, Unwind);
+	}
+
+	if (RuntimeFunctions.empty())
+	{
+		return;
+	}
+
+	// all unwind info lives together in .rdata/.xdata, one read covers every header and its chained entry
+	constexpr size_t MaxUnwindInfoSize = 4 + 255 * sizeof(WORD) + EntrySize;
+	std::vector<uint8_t> UnwindData(MaxUnwind - MinUnwind + MaxUnwindInfoSize);
+	if (!Read(MinUnwind, UnwindData.data(), UnwindData.size()))
+	{
+		// the last unwind info may end closer to the section end than the worst case
+		UnwindData.resize(MaxUnwind - MinUnwind + 4);
+		if (!Read(MinUnwind, UnwindData.data(), UnwindData.size()))
+		{
+			UnwindData.clear();
+		}
+	}
+
+	// follows UNW_FLAG_CHAININFO to the primary function, the chained entry sits after the even-padded unwind codes
+	auto ResolvePrimary = [&](uint32_t Begin, uint32_t Unwind)
+		{
+			for (size_t Depth = 0; Depth < MaxChainDepth; Depth++)
+			{
+				const size_t Offset = static_cast<size_t>(Unwind) - MinUnwind;
+				if (Unwind < MinUnwind || Offset + 4 > UnwindData.size())
+				{
+					break;
+				}
+
+				const uint8_t Flags = UnwindData[Offset] >> 3;
+				const uint8_t CountOfCodes = UnwindData[Offset + 2];
+				if ((Flags & UnwindFlagChainInfo) == 0)
+				{
+					break;
+				}
+
+				const size_t ChainOffset = Offset + 4 + ((CountOfCodes + 1) & ~1) * sizeof(WORD);
+				if (ChainOffset + EntrySize > UnwindData.size())
+				{
+					break;
+				}
+
+				DWORD Chained[3];
+				memcpy(Chained, &UnwindData[ChainOffset], EntrySize);
+				Begin = Chained[0];
+				Unwind = Chained[2];
+			}
+
+			return Begin;
+		};
+
+	for (size_t i = 0; i < RuntimeFunctions.size(); i++)
+	{
+		RuntimeFunctions[i].PrimaryBegin = ResolvePrimary(RuntimeFunctions[i].Begin, UnwindInfos[i]);
+	}
+
+	if (!std::is_sorted(RuntimeFunctions.begin(), RuntimeFunctions.end(), [](const FRuntimeFunction& A, const FRuntimeFunction& B) { return A.Begin < B.Begin; }))
+	{
+		std::sort(RuntimeFunctions.begin(), RuntimeFunctions.end(), [](const FRuntimeFunction& A, const FRuntimeFunction& B) { return A.Begin < B.Begin; });
+	}
+}
+
+bool FPEImage::FindFunction(uintptr_t Address, FFunctionExtent& OutExtent) const
+{
+	uint32_t Rva = 0;
+	if (!ToRva(Address, Rva))
+	{
+		return false;
+	}
+
+	auto it = std::upper_bound(RuntimeFunctions.begin(), RuntimeFunctions.end(), Rva, [](uint32_t Value, const FRuntimeFunction& Function) { return Value < Function.Begin; });
+	if (it == RuntimeFunctions.begin())
+	{
+		return false;
+	}
+
+	--it;
+	if (Rva >= it->End)
+	{
+		return false;
+	}
+
+	OutExtent.Start = ImageBase + it->Begin;
+	OutExtent.End = ImageBase + it->End;
+	OutExtent.PrimaryStart = ImageBase + it->PrimaryBegin;
+	return true;
+}
+
+bool FPEImage::ToRva(uintptr_t Address, uint32_t& OutRva) const
+{
+	if (Address < ImageBase || Address - ImageBase >= SizeOfImage)
+	{
+		return false;
+	}
+
+	OutRva = static_cast<uint32_t>(Address - ImageBase);
+	return true;
+}
+
+bool FPEImage::HasRelocation(uintptr_t Address) const
+{
+	uint32_t Rva = 0;
+	return ToRva(Address, Rva) && std::binary_search(Relocations.begin(), Relocations.end(), Rva);
+}
+
+size_t FPEImage::CountRelocatedSlots(uintptr_t Address, size_t MaxSlots) const
+{
+	uint32_t Rva = 0;
+	if (!ToRva(Address, Rva))
+	{
+		return 0;
+	}
+
+	auto it = std::lower_bound(Relocations.begin(), Relocations.end(), Rva);
+
+	size_t Count = 0;
+	while (Count < MaxSlots && it != Relocations.end() && *it == Rva + Count * sizeof(uintptr_t))
+	{
+		++Count;
+		++it;
+	}
+
+	return Count;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "Memory.h"
+#include <functional>
+
+// ---------------------------------------------
+// PE Image
+// ---------------------------------------------
+
+struct FRuntimeFunction
+{
+	uint32_t Begin = 0; // RVA of the first byte
+	uint32_t End = 0; // RVA one past the last byte
+	uint32_t PrimaryBegin = 0; // RVA of the function this range belongs to, follows chained unwind info
+};
+
+struct FFunctionExtent
+{
+	uintptr_t Start = 0;
+	uintptr_t End = 0;
+	uintptr_t PrimaryStart = 0; // differs from Start for separated fragments such as cold blocks
+
+	bool IsValid() const { return End > Start; }
+	size_t Size() const { return End - Start; }
+};
+
+/**
+ * Headers and directories of a PE image, read either from a module mapped in the target or from its file on disk.
+ * All addresses handed out are runtime addresses (ImageBase + RVA), so an image parsed from disk describes the
+ * module exactly as it is loaded in the target.
+ */
+class FPEImage
+{
+public:
+	FPEImage() = default;
+
+	// reads the headers and directories of a module mapped in the target
+	bool LoadFromProcess(FTargetProcess* Process, const FModule& Module);
+
+	// reads the headers and directories of an image file, rebased onto the runtime address of the module
+	bool LoadFromFile(const std::string& Path, uintptr_t RuntimeBase);
+
+	bool IsValid() const { return bValid; }
+	uintptr_t GetImageBase() const { return ImageBase; }
+	uint32_t GetSizeOfImage() const { return SizeOfImage; }
+	uint32_t GetTimeDateStamp() const { return TimeDateStamp; }
+	uint32_t GetCheckSum() const { return CheckSum; }
+	const std::vector<IMAGE_SECTION_HEADER>& GetSections() const { return Sections; }
+	const IMAGE_DATA_DIRECTORY& GetDirectory(uint32_t Index) const { return Directories[Index]; }
+
+	/************************************************************************/
+	/*	Base Relocations
+	/************************************************************************/
+
+	// sorted RVAs of every pointer sized fixup (DIR64 on x64, HIGHLOW on x86)
+	const std::vector<uint32_t>& GetRelocations() const { return Relocations; }
+	bool HasRelocations() const { return !Relocations.empty(); }
+	bool HasRelocation(uintptr_t Address) const;
+
+	// number of consecutive pointer sized fixups starting at Address
+	size_t CountRelocatedSlots(uintptr_t Address, size_t MaxSlots) const;
+
+	/************************************************************************/
+	/*	Exception Directory (x64)
+	/************************************************************************/
+
+	// RUNTIME_FUNCTION entries sorted by begin address
+	const std::vector<FRuntimeFunction>& GetRuntimeFunctions() const { return RuntimeFunctions; }
+	bool HasRuntimeFunctions() const { return !RuntimeFunctions.empty(); }
+
+	// range of the function containing Address, binary search over the exception directory
+	bool FindFunction(uintptr_t Address, FFunctionExtent& OutExtent) const;
+
+protected:
+	// Read copies Size bytes at Rva into Buffer, returns false if the range is not available
+	using FReadFunction = std::function<bool(uint32_t Rva, void* Buffer, size_t Size)>;
+
+	bool Parse(const FReadFunction& Read);
+	void ParseRelocations(const FReadFunction& Read);
+	void ParseRuntimeFunctions(const FReadFunction& Read);
+	bool ToRva(uintptr_t Address, uint32_t& OutRva) const;
+
+	bool bValid = false;
+	uintptr_t ImageBase = 0;
+	uint32_t SizeOfImage = 0;
+	uint32_t TimeDateStamp = 0;
+	uint32_t CheckSum = 0;
+	IMAGE_DATA_DIRECTORY Directories[IMAGE_NUMBEROF_DIRECTORY_ENTRIES] = {};
+	std::vector<IMAGE_SECTION_HEADER> Sections;
+	std::vector<uint32_t> Relocations;
+	std::vector<FRuntimeFunction> RuntimeFunctions;
+};
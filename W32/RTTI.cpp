@@ -1,7 +1,10 @@
 #include "RTTI.h"
 #include <DbgHelp.h>
+#include <chrono>
 #include <numeric>
-#include "../ClassDumper3.h"
+#include <unordered_set>
+#include <tuple>
+#include "../Util/Log.h"
 #include "../Util/Strings.h"
 #include "../Util/ThreadPool.h"
 
@@ -86,6 +89,16 @@ std::vector<std::shared_ptr<ClassMetaData>> RTTI::GetClasses()
 void RTTI::ProcessRTTI()
 {
 	FindValidSections();
+	LoadImage();
+	ComputeFingerprint();
+
+	if (bUseResultCache && LoadCachedResults())
+	{
+		LoadDisassemblyCache();
+		ApplyAnnotations();
+		bIsProcessing.store(false, std::memory_order_release);
+		return;
+	}
 
 	std::vector<PotentialClass> PotentialClasses;
 	ScanForClasses(PotentialClasses);
@@ -93,6 +106,15 @@ void RTTI::ProcessRTTI()
 	if (!PotentialClasses.empty())
 	{
 		ValidateClasses(PotentialClasses);
+		LoadDisassemblyCache();
+		AnalyzeCode();
+
+		if (bUseResultCache && !Classes.empty())
+		{
+			SaveCachedResults();
+		}
+
+		ApplyAnnotations();
 	}
 
 	bIsProcessing.store(false, std::memory_order_release);
@@ -124,8 +146,16 @@ std::vector<uintptr_t> RTTI::ScanForCodeReferences(const std::shared_ptr<ClassMe
 		return {};
 	}
 
-	std::vector<std::future<FMemoryBlock>> Blocks = Process->AsyncGetExecutableMemory();
-	std::vector<uintptr_t> References = ScanMemory(CMeta, Blocks, false);
+	FAddressIndex Targets;
+	Targets.Insert(CMeta->VTable, CMeta->ClassID);
+
+	std::vector<uintptr_t> References;
+	for (const FCodeReference& Reference : FindCodeReferences(Targets, "Code reference scan"))
+	{
+		FLog::WriteF("Found reference to %s at 0x%p", CMeta->Name.c_str(), Reference.Instruction);
+		References.push_back(Reference.Instruction);
+	}
+
 	CMeta->CodeReferences = References;
 	bIsScanning.store(false, std::memory_order_release);
 	return References;
@@ -138,471 +168,2610 @@ std::vector<uintptr_t> RTTI::ScanForClassInstances(const std::shared_ptr<ClassMe
 		return {};
 	}
 
-	std::vector<std::future<FMemoryBlock>> Blocks = Process->AsyncGetReadableMemory();
-	std::vector<uintptr_t> Instances = ScanMemory(CMeta, Blocks, true);
-	CMeta->ClassInstances = Instances;
-	bIsScanning.store(false, std::memory_order_release);
-	return Instances;
-}
-
-void RTTI::ProcessMemoryBlock(const FMemoryBlock& MemoryBlock, bool isForInstances, std::mutex& mtx)
-{
-	auto HandleCandidate = [&](uintptr_t Candidate, uintptr_t RealAddress)
-		{
-			auto it = VTableClassMap.find(Candidate);
-			if (it != VTableClassMap.end())
-			{
-				const char* logMessage = isForInstances
-					? "Found %s instance at 0x%p"
-					: "Found reference to %s at 0x%p";
+	std::vector<uintptr_t> Instances;
+	CMeta->ClassInstances.clear();
 
-				ClassDumper3::LogF(logMessage, it->second->Name.c_str(), RealAddress);
+	for (const FInstanceHit& Hit : ScanInstances({ CMeta }, "Instance scan"))
+	{
+		FLog::WriteF("Found %s Instance at 0x%p (confidence %u, %s)", CMeta->Name.c_str(), Hit.Instance.Address,
+			Hit.Instance.Confidence, FInstanceValidator::GetRegionName(Hit.Instance.Region));
+		Instances.push_back(Hit.Instance.Address);
+		CMeta->ClassInstances.push_back(Hit.Instance);
+	}
 
-				std::scoped_lock Lock(mtx);
-				if (isForInstances)
-				{
-					it->second->ClassInstances.push_back(RealAddress);
-				}
-				else
-				{
-					it->second->CodeReferences.push_back(RealAddress);
-				}
-			}
-		};
+	EstimateObjectSizesFromInstances();
 
-	ScanBlock(MemoryBlock, isForInstances, HandleCandidate);
+	bIsScanning.store(false, std::memory_order_release);
+	return Instances;
 }
 
-
-void RTTI::ScanBlock(const FMemoryBlock& MemoryBlock, bool isForInstances, FScanCallback Callback)
+void RTTI::SampleLayout(const std::shared_ptr<ClassMetaData>& CMeta)
 {
-	auto MemoryBlockCopy = reinterpret_cast<uintptr_t>(MemoryBlock.Copy.data());
-	auto MemoryBlockAddress = reinterpret_cast<uintptr_t>(MemoryBlock.Address);
-
-	for (uintptr_t i = MemoryBlockCopy; i < MemoryBlockCopy + MemoryBlock.Size; i += (isForInstances ? 4 : 1))
+	std::shared_ptr<ClassMetaData> Complete = GetCompleteClass(CMeta);
+	if (!Complete)
 	{
-		uintptr_t Candidate = 0;
-		uintptr_t RealAddress = i - MemoryBlockCopy + MemoryBlockAddress;
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
 
-		if (bUse64BitScanner && !isForInstances)
-		{
-			Candidate = *reinterpret_cast<DWORD*>(i);
-			Candidate += RealAddress + 4;
-		}
-		else
+	// instance addresses are already complete object starts, see ScanInstances; a scan started from a
+	// secondary vtable files them under that entry, so every entry of the complete class is collected
+	std::vector<uintptr_t> Instances;
+	for (const std::shared_ptr<ClassMetaData>& VTable : Classes)
+	{
+		if (GetCompleteClass(VTable) != Complete)
 		{
-			Candidate = *reinterpret_cast<uintptr_t*>(i);
+			continue;
 		}
 
-		// Unaligned, likely invalid ptr
-		if (Candidate % sizeof(void*) != 0)
+		for (const FClassInstance& Instance : VTable->ClassInstances)
 		{
-			continue;
+			Instances.push_back(Instance.Address);
 		}
-
-		Callback(Candidate, RealAddress);
 	}
-}
 
-std::vector<uintptr_t> RTTI::ScanMemory(const std::shared_ptr<ClassMetaData>& CMeta, std::vector<std::future<FMemoryBlock>>& Blocks, bool bInstanceScan)
-{
-	std::vector<uintptr_t> Results;
+	std::sort(Instances.begin(), Instances.end());
+	Instances.erase(std::unique(Instances.begin(), Instances.end()), Instances.end());
 
-	for (auto& Block : Blocks)
+	if (Instances.empty())
 	{
-		Block.wait();
-		FMemoryBlock MemoryBlock = Block.get();
+		FLog::WriteF("Layout sampling: no instances of %s, scan for instances first", Complete->Name.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
 
-		ScanBlock(MemoryBlock, bInstanceScan,
-				  [&](uintptr_t Candidate, uintptr_t RealAddress)
-				  {
-					  if (Candidate == CMeta->VTable)
-					  {
-						  const char* logMessage = bInstanceScan ? "Found %s Instance at 0x%p" : "Found reference to %s at 0x%p";
+	FLayoutSampler Sampler(Process, VTableIndex, LayoutSettings);
+	Complete->Members = Sampler.Sample(Instances, Complete->ObjectSize);
 
-						  ClassDumper3::LogF(logMessage, CMeta->Name.c_str(), RealAddress);
-						  Results.push_back(RealAddress);
-					  }
-				  });
-	}
+	FLog::WriteF("Layout sampling: %u fields of %s from %u instances",
+		Complete->Members.size(),
+		Complete->Name.c_str(),
+		std::min(Instances.size(), LayoutSettings.MaxSamples));
 
-	return Results;
+	bIsScanning.store(false, std::memory_order_release);
 }
 
-void RTTI::ScanForAllCodeReferences()
+void RTTI::ExportHeader(std::string Path, FHeaderExportSettings Settings)
 {
-	std::vector<std::future<FMemoryBlock>> Blocks = Process->AsyncGetExecutableMemory();
-	ScanAllMemory(Blocks, false);
-}
+	const auto StartTime = std::chrono::steady_clock::now();
 
-void RTTI::ScanForAllClassInstances()
-{
-	std::vector<std::future<FMemoryBlock>> Blocks = Process->AsyncGetReadableMemory();
-	ScanAllMemory(Blocks, true);
+	FHeaderExporter Exporter(*this, Settings);
+	if (!Exporter.Export(Path))
+	{
+		FLog::WriteF("Header export: failed to write %s", Path.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
+
+	const FHeaderExportStats& Stats = Exporter.GetStats();
+	const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+	FLog::WriteF("Header export: %u classes (%u bases without vtable), %u virtual functions, %u members, %.1f MB to %s in %.2f ms",
+		Stats.NumClasses,
+		Stats.NumStubs,
+		Stats.NumFunctions,
+		Stats.NumMembers,
+		Stats.BytesWritten / (1024.0 * 1024.0),
+		Path.c_str(),
+		ElapsedMs);
+
+	bIsScanning.store(false, std::memory_order_release);
 }
 
-void RTTI::ScanAll()
+void RTTI::ExportJson(std::string Path)
 {
-	for (const std::shared_ptr<ClassMetaData>& Class : Classes)
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	FJsonExporter Exporter(*this);
+	if (!Exporter.Export(Path))
 	{
-		Class->CodeReferences.clear();
-		Class->ClassInstances.clear();
+		FLog::WriteF("JSON export: failed to write %s", Path.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
 	}
 
-	ScanForAllCodeReferences();
-	ScanForAllClassInstances();
+	const FJsonExportStats& Stats = Exporter.GetStats();
+	const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+	FLog::WriteF("JSON export: %u classes, %u functions, %u references, %u instances, %.1f MB to %s in %.2f ms",
+		Stats.NumClasses,
+		Stats.NumFunctions,
+		Stats.NumReferences,
+		Stats.NumInstances,
+		Stats.BytesWritten / (1024.0 * 1024.0),
+		Path.c_str(),
+		ElapsedMs);
 
 	bIsScanning.store(false, std::memory_order_release);
 }
 
-void RTTI::ScanAllAsync()
+void RTTI::BenchmarkJsonExport(size_t NumRecords)
 {
-	if (bIsScanning.load(std::memory_order_acquire))
+	char TempDirectory[MAX_PATH] = { 0 };
+	GetTempPathA(MAX_PATH, TempDirectory);
+	const std::string Path = std::string(TempDirectory) + "ClassDumper3_benchmark.ndjson";
+
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	FJsonExporter Exporter(*this);
+	const bool bWritten = Exporter.Benchmark(Path, NumRecords);
+
+	const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+	DeleteFileA(Path.c_str());
+
+	if (!bWritten)
 	{
+		FLog::WriteF("JSON export benchmark: failed to write %s", Path.c_str());
+		bIsScanning.store(false, std::memory_order_release);
 		return;
 	}
 
-	bIsScanning.store(true, std::memory_order_release);
-	ScannerThread = std::thread(&RTTI::ScanAll, this);
-	ScannerThread.detach();
+	const FJsonExportStats& Stats = Exporter.GetStats();
+	const double Megabytes = Stats.BytesWritten / (1024.0 * 1024.0);
+	FLog::WriteF("JSON export benchmark: %u class records (%u functions), %.1f MB in %.2f ms, %.0f MB/s, %.0f classes/s",
+		Stats.NumClasses,
+		Stats.NumFunctions,
+		Megabytes,
+		ElapsedMs,
+		Megabytes / (ElapsedMs / 1000.0),
+		Stats.NumClasses / (ElapsedMs / 1000.0));
+
+	bIsScanning.store(false, std::memory_order_release);
 }
 
-void RTTI::ScanForCodeReferencesAsync(const std::shared_ptr<ClassMetaData>& CMeta)
+void RTTI::BenchmarkClassDiff(size_t NumClasses)
 {
-	if (bIsScanning.load(std::memory_order_acquire))
+	char TempDirectory[MAX_PATH] = { 0 };
+	GetTempPathA(MAX_PATH, TempDirectory);
+	const std::string OldPath = std::string(TempDirectory) + "ClassDumper3_benchmark_old.cd3db";
+	const std::string NewPath = std::string(TempDirectory) + "ClassDumper3_benchmark_new.cd3db";
+
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	FSyntheticDatabaseWriter OldWriter(NumClasses, 0);
+	FSyntheticDatabaseWriter NewWriter(NumClasses, 1);
+	FClassDatabase OldDatabase;
+	FClassDatabase NewDatabase;
+	const bool bOpened = OldWriter.Write(OldPath) && NewWriter.Write(NewPath) && OldDatabase.Open(OldPath) && NewDatabase.Open(NewPath);
+
+	const double GenerateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+
+	if (!bOpened)
 	{
+		FLog::WriteF("Class diff benchmark: failed to write %s and %s", OldPath.c_str(), NewPath.c_str());
+		OldDatabase.Close();
+		NewDatabase.Close();
+		DeleteFileA(OldPath.c_str());
+		DeleteFileA(NewPath.c_str());
+		bIsScanning.store(false, std::memory_order_release);
 		return;
 	}
 
-	bIsScanning.store(true, std::memory_order_release);
-	ScannerThread = std::thread(&RTTI::ScanForCodeReferences, this, CMeta);
-	ScannerThread.detach();
+	FClassDiff Diff(OldDatabase, NewDatabase);
+	Diff.Run();
+
+	const FClassDiffStats& Stats = Diff.GetStats();
+	FLog::WriteF("Class diff benchmark: %zu and %zu synthetic classes generated in %.2f ms, diffed in %.2f ms",
+		OldDatabase.GetClasses().size(),
+		NewDatabase.GetClasses().size(),
+		GenerateMs,
+		Stats.ElapsedMs);
+	FLog::WriteF("Class diff benchmark: %u matched (%u by name, %u by content, %u by shape), %u added, %u removed, %u vtables changed, %u names carried over",
+		Diff.GetMatches().size(),
+		Stats.NumMatchedByName,
+		Stats.NumMatchedByContent,
+		Stats.NumMatchedByShape,
+		Stats.NumAdded,
+		Stats.NumRemoved,
+		Stats.NumChangedVTables,
+		Stats.NumRenames);
+
+	OldDatabase.Close();
+	NewDatabase.Close();
+	DeleteFileA(OldPath.c_str());
+	DeleteFileA(NewPath.c_str());
+
+	bIsScanning.store(false, std::memory_order_release);
 }
 
-void RTTI::ScanForClassInstancesAsync(const std::shared_ptr<ClassMetaData>& CMeta)
+void RTTI::SaveDatabase(std::string Path)
 {
-	if (bIsScanning.load(std::memory_order_acquire))
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	FClassDatabaseWriter Writer(*this);
+	if (!Writer.Write(Path))
 	{
+		FLog::WriteF("Class database: failed to write %s", Path.c_str());
+		bIsScanning.store(false, std::memory_order_release);
 		return;
 	}
 
-	bIsScanning.store(true, std::memory_order_release);
-	ScannerThread = std::thread(&RTTI::ScanForClassInstances, this, CMeta);
-	ScannerThread.detach();
+	const auto WrittenTime = std::chrono::steady_clock::now();
+
+	// reopen what was written, checks the file and shows what a consumer pays to load it
+	FClassDatabase Database;
+	const bool bOpened = Database.Open(Path);
+	const auto OpenedTime = std::chrono::steady_clock::now();
+
+	if (!bOpened)
+	{
+		FLog::WriteF("Class database: %s was written but could not be opened", Path.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
+
+	FLog::WriteF("Class database: %zu classes, %zu functions, %.1f MB to %s in %.2f ms, opened in %.3f ms",
+		Database.GetClasses().size(),
+		Database.GetFunctions().size(),
+		Database.GetHeader().FileSize / (1024.0 * 1024.0),
+		Path.c_str(),
+		std::chrono::duration<double, std::milli>(WrittenTime - StartTime).count(),
+		std::chrono::duration<double, std::milli>(OpenedTime - WrittenTime).count());
+
+	bIsScanning.store(false, std::memory_order_release);
 }
 
-void RTTI::FindValidSections()
+void RTTI::DiffWithDatabase(std::string OldPath, std::string ReportPath)
 {
-	SetProcessingStage("Finding valid PE sections");
-	bool bFoundExecutable = false;
-	bool bFoundReadOnly = false;
+	FClassDatabase OldDatabase;
+	if (!OldDatabase.Open(OldPath))
+	{
+		FLog::WriteF("Class diff: failed to open %s", OldPath.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
 
-	// find valid executable or read only sections
-	for (auto& section : Module->Sections)
+	// the diff works on two databases, the current results are written to a temporary one
+	char TempDirectory[MAX_PATH] = { 0 };
+	GetTempPathA(MAX_PATH, TempDirectory);
+	const std::string NewPath = std::string(TempDirectory) + "ClassDumper3_diff.cd3db";
+
+	FClassDatabaseWriter Writer(*this);
+	FClassDatabase NewDatabase;
+	if (!Writer.Write(NewPath) || !NewDatabase.Open(NewPath))
 	{
-		if (section.bFlagExecutable)
-		{
-			ExecutableSections.push_back(section);
-			bFoundExecutable = true;
-			continue;
-		}
+		FLog::WriteF("Class diff: failed to write %s", NewPath.c_str());
+		DeleteFileA(NewPath.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
 
-		if (section.bFlagReadonly)
+	FClassDiff Diff(OldDatabase, NewDatabase);
+	Diff.Run();
+
+	size_t NumApplied = 0;
+	for (const FFunctionRename& Rename : Diff.GetRenames())
+	{
+		const uint32_t FunctionIndex = FunctionTable.FindFunction(NewDatabase.GetFunctionAddress(Rename.NewFunction));
+		if (FunctionIndex != FFunctionTable::InvalidIndex && !FunctionTable.HasUserName(FunctionIndex))
 		{
-			ReadOnlySections.push_back(section);
-			bFoundReadOnly = true;
+			FunctionTable.SetName(FunctionIndex, std::string(Rename.Name));
+			NumApplied++;
 		}
 	}
 
-	if (!bFoundExecutable || !bFoundReadOnly)
+	// carried names are recorded like user renames, so the next session of this build keeps them
+	if (NumApplied > 0)
 	{
-		ClassDumper3::Log("Failed to find valid sections for RTTI scan");
-		SetProcessingStage("Error: Failed to find valid sections for RTTI scan");
+		SaveAnnotations();
 	}
+
+	const FClassDiffStats& Stats = Diff.GetStats();
+	const bool bWroteReport = Diff.WriteReport(ReportPath);
+
+	NewDatabase.Close();
+	DeleteFileA(NewPath.c_str());
+
+	FLog::WriteF("Class diff: %u matched (%u by name, %u by content, %u by shape), %u added, %u removed, %u vtables changed in %.2f ms",
+		Diff.GetMatches().size(),
+		Stats.NumMatchedByName,
+		Stats.NumMatchedByContent,
+		Stats.NumMatchedByShape,
+		Stats.NumAdded,
+		Stats.NumRemoved,
+		Stats.NumChangedVTables,
+		Stats.ElapsedMs);
+	FLog::WriteF("Class diff: %u function names carried over, %u conflicts, report %s %s",
+		NumApplied,
+		Stats.NumRenameConflicts,
+		bWroteReport ? "written to" : "could not be written to",
+		ReportPath.c_str());
+
+	bIsScanning.store(false, std::memory_order_release);
 }
 
-bool RTTI::IsInExecutableSection(uintptr_t Address)
+std::shared_ptr<ClassMetaData> RTTI::GetCompleteClass(const std::shared_ptr<ClassMetaData>& CMeta) const
 {
-	return std::any_of(ExecutableSections.begin(), ExecutableSections.end(), [&](const FModuleSection& Section) { return Section.Contains(Address); });
+	if (!CMeta)
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<ClassMetaData> Complete = CMeta->CompleteClass.lock();
+	return Complete ? Complete : CMeta;
 }
 
-bool RTTI::IsInReadOnlySection(uintptr_t Address)
+std::vector<std::shared_ptr<ClassMetaData>> RTTI::GetPolymorphicVTables(const std::shared_ptr<ClassMetaData>& Root) const
 {
-	return std::any_of(ReadOnlySections.begin(), ReadOnlySections.end(), [&](const FModuleSection& Section) { return Section.Contains(Address); });
+	std::vector<std::shared_ptr<ClassMetaData>> VTables;
+	std::shared_ptr<ClassMetaData> RootClass = GetCompleteClass(Root);
+
+	if (!RootClass)
+	{
+		return VTables;
+	}
+
+	// every vtable (primary or secondary) whose complete class is the root or derives from it
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		if (CMeta->TypeDescriptor == RootClass->TypeDescriptor || CMeta->IsChildOf(RootClass))
+		{
+			VTables.push_back(CMeta);
+		}
+	}
+
+	return VTables;
 }
 
-void RTTI::ScanForClasses(std::vector<PotentialClass>& PotentialClasses)
+std::vector<FInstanceGroup> RTTI::ScanForPolymorphicInstances(const std::shared_ptr<ClassMetaData>& Root)
 {
-	SetProcessingStage("Scanning for potential classes...");
+	std::vector<FInstanceGroup> Groups;
+	std::vector<std::shared_ptr<ClassMetaData>> VTables = GetPolymorphicVTables(Root);
+
+	if (VTables.empty())
+	{
+		bIsScanning.store(false, std::memory_order_release);
+		return Groups;
+	}
 
-	auto Accumulator = [](size_t sum, const FModuleSection& Section) { return sum + Section.Size(); };
+	FLog::WriteF("Scanning for instances of %s using %u vtables", Root->Name.c_str(), VTables.size());
 
-	size_t TotalSectionSize = std::accumulate(ReadOnlySections.begin(), ReadOnlySections.end(), size_t(0), Accumulator);
+	// hits come back normalized and sorted by complete class, so every run of equal classes is one group
+	std::vector<FInstanceHit> Hits = ScanInstances(VTables, "Polymorphic instance scan");
 
-	auto SectionBuffer = std::vector<uintptr_t>(TotalSectionSize / sizeof(uintptr_t));
+	for (const std::shared_ptr<ClassMetaData>& CMeta : VTables)
+	{
+		CMeta->ClassInstances.clear();
+	}
 
-	for (const FModuleSection& Section : ReadOnlySections)
+	for (const FInstanceHit& Hit : Hits)
 	{
-		size_t SectionSize = Section.Size();
-		size_t SectionMax = SectionSize / sizeof(uintptr_t);
+		if (Groups.empty() || Groups.back().Class.get() != Hit.Class)
+		{
+			Groups.push_back({ Classes[Hit.Class->ClassID], {} });
+		}
 
-		Process->Read(Section.Start, SectionBuffer.data(), SectionSize);
+		Groups.back().Instances.push_back(Hit.Instance);
+	}
 
-		for (size_t Index = 0; Index < SectionMax; Index++)
-		{
-			if (Index >= SectionBuffer.size() || Index + 1 >= SectionBuffer.size())
-			{
-				ClassDumper3::Log("Error: Index out of bounds in RTTI scan");
-				break;
-			}
+	for (FInstanceGroup& Group : Groups)
+	{
+		Group.Class->ClassInstances = Group.Instances;
+	}
 
-			// if nullptr or we are at the end of the section
-			if (SectionBuffer[Index] == 0 || Index + 1 > SectionMax)
-			{
-				continue;
-			}
+	std::sort(Groups.begin(), Groups.end(), [](const FInstanceGroup& A, const FInstanceGroup& B) { return A.Class->Name < B.Class->Name; });
 
-			// first pointer is not a valid RTTI object or the second pointer is not a valid VTable function ptr
-			if (!IsInReadOnlySection(SectionBuffer[Index]) || !IsInExecutableSection(SectionBuffer[Index + 1]))
-			{
-				continue;
-			}
+	FLog::WriteF("Found %u instances of %s and its descendants in %u classes", Hits.size(), Root->Name.c_str(), Groups.size());
 
-			PotentialClass& PClass = PotentialClasses.emplace_back();
-			PClass.CompleteObjectLocator = SectionBuffer[Index];
-			// VTables are in order in MSVC so we can just add the index to the start of the section
-			PClass.VTable = Section.Start + (Index + 1) * sizeof(uintptr_t);
-		}
+	{
+		std::scoped_lock Lock(PolymorphicScanMutex);
+		PolymorphicScanRoot = GetCompleteClass(Root);
+		PolymorphicScanResults = Groups;
 	}
 
-	SortClasses(PotentialClasses);
-
-	ClassDumper3::LogF("Found %u potential classes in %s\n", PotentialClasses.size(), ModuleName.c_str());
+	bIsScanning.store(false, std::memory_order_release);
+	return Groups;
 }
 
-void RTTI::ValidateClasses(std::vector<PotentialClass>& PotentialClasses)
+std::vector<FInstanceHit> RTTI::ScanInstances(const std::vector<std::shared_ptr<ClassMetaData>>& VTables, const char* ScanName)
 {
-	SetProcessingStage("Validating potential classes...");
+	struct FRawHit
+	{
+		uintptr_t Base = 0; // start of the complete object
+		uint32_t VTableIdx = 0;
+		bool bVerified = false;
+	};
 
-	std::vector<PotentialClass> ValidatedClasses;
-	ValidatedClasses.reserve(PotentialClasses.size());
+	struct FScanVTable
+	{
+		ClassMetaData* Complete = nullptr;
+		uintptr_t Offset = 0; // offset of this vtable pointer inside the complete object
+		uintptr_t PrimaryVTable = 0;
+	};
 
-	DWORD signatureMatch = IsRunning64Bits() ? 1 : 0;
+	std::vector<FScanVTable> ScanVTables(VTables.size());
+	FAddressIndex ScanIndex;
+	ScanIndex.Reserve(VTables.size());
 
-	for (PotentialClass& PClass : PotentialClasses)
+	for (size_t i = 0; i < VTables.size(); i++)
 	{
-		RTTICompleteObjectLocator CompleteObjectLocator;
-		RTTITypeDescriptor TypeDescriptor;
+		std::shared_ptr<ClassMetaData> Complete = GetCompleteClass(VTables[i]);
+		FScanVTable& Entry = ScanVTables[i];
+		Entry.Complete = Complete.get();
+		Entry.Offset = Complete != VTables[i] ? VTables[i]->VTableOffset : 0;
+		Entry.PrimaryVTable = Complete->VTable;
+		ScanIndex.Insert(VTables[i]->VTable, static_cast<uint32_t>(i));
+	}
 
-		Process->Read(PClass.CompleteObjectLocator, &CompleteObjectLocator, sizeof(RTTICompleteObjectLocator));
+	FScanPipeline Pipeline(Process->Process.ProcessHandle, ScanSettings);
+	std::vector<std::vector<FRawHit>> ScannerHits(Pipeline.GetNumScanners());
+
+	Pipeline.Run(Process->GetReadableRanges(),
+				 [&](const FMemoryBlock& Chunk, size_t ScannerIndex)
+				 {
+					 std::vector<FRawHit>& Hits = ScannerHits[ScannerIndex];
+					 const uintptr_t ChunkStart = reinterpret_cast<uintptr_t>(Chunk.Address);
+					 const uintptr_t ChunkEnd = ChunkStart + Chunk.Size;
+
+					 ScanBlock(Chunk, true,
+							   [&](uintptr_t Candidate, uintptr_t RealAddress)
+							   {
+								   const uint32_t VTableIdx = ScanIndex.Find(Candidate);
+								   if (VTableIdx == FAddressIndex::InvalidIndex)
+								   {
+									   return;
+								   }
+
+								   const FScanVTable& Entry = ScanVTables[VTableIdx];
+								   FRawHit Hit{ RealAddress - Entry.Offset, VTableIdx, Entry.Offset == 0 };
+
+								   // secondary vtable hit, check the primary vtable is where the object should start
+								   if (!Hit.bVerified && Hit.Base >= ChunkStart && Hit.Base + sizeof(uintptr_t) <= ChunkEnd)
+								   {
+									   uintptr_t PrimaryVTable = 0;
+									   memcpy(&PrimaryVTable, &Chunk.Copy[Hit.Base - ChunkStart], sizeof(uintptr_t));
+									   if (PrimaryVTable != Entry.PrimaryVTable)
+									   {
+										   return;
+									   }
+									   Hit.bVerified = true;
+								   }
+
+								   Hits.push_back(Hit);
+							   });
+				 });
+
+	RecordScanStats(Pipeline, ScanName);
+
+	std::vector<FRawHit> RawHits;
+	for (const std::vector<FRawHit>& Hits : ScannerHits)
+	{
+		RawHits.insert(RawHits.end(), Hits.begin(), Hits.end());
+	}
 
-		if (signatureMatch != CompleteObjectLocator.signature)
+	// cross-validate the secondary hits whose object start fell outside of the scanned chunk in one batched read
+	std::vector<uintptr_t> PendingBases;
+	for (const FRawHit& Hit : RawHits)
+	{
+		if (!Hit.bVerified)
 		{
-			continue;
+			PendingBases.push_back(Hit.Base);
 		}
+	}
 
-		uintptr_t pTypeDescriptor = CompleteObjectLocator.pTypeDescriptor + ModuleBase;
+	size_t Rejected = 0;
 
-		if (!IsInReadOnlySection(pTypeDescriptor))
+	if (!PendingBases.empty())
+	{
+		std::sort(PendingBases.begin(), PendingBases.end());
+		PendingBases.erase(std::unique(PendingBases.begin(), PendingBases.end()), PendingBases.end());
+		std::vector<uint8_t> PrimaryWords = Process->ReadBatched(PendingBases, sizeof(uintptr_t));
+
+		for (FRawHit& Hit : RawHits)
 		{
-			continue;
+			if (Hit.bVerified)
+			{
+				continue;
+			}
+
+			size_t Index = std::lower_bound(PendingBases.begin(), PendingBases.end(), Hit.Base) - PendingBases.begin();
+			uintptr_t PrimaryVTable = 0;
+			memcpy(&PrimaryVTable, &PrimaryWords[Index * sizeof(uintptr_t)], sizeof(uintptr_t));
+			Hit.bVerified = PrimaryVTable == ScanVTables[Hit.VTableIdx].PrimaryVTable;
+			Rejected += Hit.bVerified ? 0 : 1;
 		}
+	}
 
-		Process->Read(pTypeDescriptor, &TypeDescriptor, sizeof(RTTITypeDescriptor));
+	std::vector<FInstanceHit> Instances;
+	Instances.reserve(RawHits.size());
 
-		if (!IsInReadOnlySection(TypeDescriptor.pVTable))
+	for (const FRawHit& Hit : RawHits)
+	{
+		if (Hit.bVerified)
 		{
-			continue;
+			Instances.push_back({ { Hit.Base }, ScanVTables[Hit.VTableIdx].Complete });
 		}
+	}
 
-		char Name[StandardBufferSize];
-		Process->Read(pTypeDescriptor + offsetof(RTTITypeDescriptor, name), Name, StandardBufferSize);
-		Name[StandardBufferSize - 1] = 0;
-		PClass.Name = Name;
-		PClass.DemangledName = DemangleMSVC(Name);
+	// an object with several vtable pointers is hit once per vtable, keep a single entry per complete object
+	std::sort(Instances.begin(), Instances.end(), [](const FInstanceHit& A, const FInstanceHit& B)
+		{
+			return A.Class != B.Class ? A.Class->ClassID < B.Class->ClassID : A.Instance.Address < B.Instance.Address;
+		});
+	Instances.erase(std::unique(Instances.begin(), Instances.end(), [](const FInstanceHit& A, const FInstanceHit& B)
+		{
+			return A.Class == B.Class && A.Instance.Address == B.Instance.Address;
+		}), Instances.end());
 
-		ValidatedClasses.push_back(PClass);
-	}
+	FLog::WriteF("%s: %u raw hits, %u rejected by primary vtable check, %u complete objects", ScanName, RawHits.size(), Rejected, Instances.size());
 
-	ProcessClasses(ValidatedClasses);
+	FInstanceValidator Validator(Process, Classes, ValidationSettings);
+	const size_t LowConfidence = Validator.Validate(Instances);
 
-	ClassDumper3::LogF("Found %u valid classes in %s\n", Classes.size(), ModuleName.c_str());
+	FLog::WriteF("%s: %u hits below confidence %u dropped, %u instances kept", ScanName, LowConfidence, ValidationSettings.ConfidenceThreshold, Instances.size());
+
+	return Instances;
 }
 
-void RTTI::ProcessClasses(const std::vector<PotentialClass>& FinalClasses)
+std::shared_ptr<ClassMetaData> RTTI::GetPolymorphicScanRoot()
 {
-	SetProcessingStage("Processing class data...");
+	std::scoped_lock Lock(PolymorphicScanMutex);
+	return PolymorphicScanRoot;
+}
 
-	std::string LastClassName = "";
-	std::shared_ptr<ClassMetaData> LastClass = nullptr;
+std::vector<FInstanceGroup> RTTI::GetPolymorphicScanResults()
+{
+	std::scoped_lock Lock(PolymorphicScanMutex);
+	return PolymorphicScanResults;
+}
 
-	for (const PotentialClass& PClassFinal : FinalClasses)
-	{
-		RTTICompleteObjectLocator CompleteObjectLocator;
-		RTTIClassHierarchyDescriptor ClassHierarchyDescriptor;
+void RTTI::ScanBlock(const FMemoryBlock& MemoryBlock, bool isForInstances, const FScanCallback& Callback)
+{
+	auto MemoryBlockCopy = reinterpret_cast<uintptr_t>(MemoryBlock.Copy.data());
+	auto MemoryBlockAddress = reinterpret_cast<uintptr_t>(MemoryBlock.Address);
+	const size_t ReadSize = (bUse64BitScanner && !isForInstances) ? sizeof(DWORD) : sizeof(uintptr_t);
 
-		Process->Read(PClassFinal.CompleteObjectLocator, &CompleteObjectLocator, sizeof(RTTICompleteObjectLocator));
-		uintptr_t pClassDescriptor = CompleteObjectLocator.pClassDescriptor + ModuleBase;
+	if (MemoryBlock.Size < ReadSize)
+	{
+		return;
+	}
 
-		Process->Read(pClassDescriptor, &ClassHierarchyDescriptor, sizeof(RTTIClassHierarchyDescriptor));
+	for (uintptr_t i = MemoryBlockCopy; i + ReadSize <= MemoryBlockCopy + MemoryBlock.Size; i += (isForInstances ? 4 : 1))
+	{
+		uintptr_t Candidate = 0;
+		uintptr_t RealAddress = i - MemoryBlockCopy + MemoryBlockAddress;
+
+		if (bUse64BitScanner && !isForInstances)
+		{
+			Candidate = *reinterpret_cast<DWORD*>(i);
+			Candidate += RealAddress + 4;
+		}
+		else
+		{
+			Candidate = *reinterpret_cast<uintptr_t*>(i);
+		}
+
+		// Unaligned, likely invalid ptr
+		if (Candidate % sizeof(void*) != 0)
+		{
+			continue;
+		}
+
+		Callback(Candidate, RealAddress);
+	}
+}
+
+void RTTI::RecordScanStats(const FScanPipeline& Pipeline, const char* ScanName)
+{
+	const FScanPipelineStats Stats = Pipeline.GetStats();
+
+	{
+		std::scoped_lock Lock(ScanStatsMutex);
+		LastScanStats = Stats;
+	}
+
+	FLog::WriteF("%s: %llu MB in %llu chunks (%llu failed) took %.2f ms, reader stall %.2f ms, scanner stall %.2f ms",
+		ScanName,
+		Stats.BytesRead >> 20,
+		Stats.ChunksRead,
+		Stats.ChunksFailed,
+		Stats.TotalNs / 1e6,
+		Stats.ReaderStallNs / 1e6,
+		Stats.ScannerStallNs / 1e6);
+}
+
+FScanPipelineStats RTTI::GetLastScanStats()
+{
+	std::scoped_lock Lock(ScanStatsMutex);
+	return LastScanStats;
+}
+
+void RTTI::ScanForAllCodeReferences()
+{
+	for (const FCodeReference& Reference : FindCodeReferences(VTableIndex, "Code reference scan (all classes)"))
+	{
+		Classes[Reference.TargetIndex]->CodeReferences.push_back(Reference.Instruction);
+	}
+}
+
+std::vector<FCodeReference> RTTI::FindCodeReferences(const FAddressIndex& Targets, const char* ScanName)
+{
+	FCodeScanner Scanner(Process);
+	std::vector<FCodeReference> References;
+
+	if (!IsRunning64Bits() && Image.HasRelocations())
+	{
+		// every absolute address in 32 bit code has a fixup, so only the module's own code has to be read
+		if (!Scanner.LoadRanges(GetExecutableSectionRanges()))
+		{
+			FLog::WriteF("%s: failed to read executable sections of %s", ScanName, ModuleName.c_str());
+			return {};
+		}
+
+		References = Scanner.FindRelocatedReferences(Targets, Image);
+	}
+	else
+	{
+		if (!Scanner.LoadRanges(Process->GetExecutableRanges()))
+		{
+			FLog::WriteF("%s: failed to read executable memory", ScanName);
+			return {};
+		}
+
+		References = Scanner.FindReferences(Targets);
+	}
+
+	const FCodeScanStats& Stats = Scanner.GetStats();
+
+	{
+		std::scoped_lock Lock(ScanStatsMutex);
+		LastScanStats = FScanPipelineStats();
+		LastScanStats.BytesRead = Stats.BytesLoaded;
+		LastScanStats.TotalNs = Stats.LoadNs + Stats.DecodeNs;
+	}
+
+	FLog::WriteF("%s: decoded %llu MB in %llu ranges (%llu instructions, %llu bytes skipped), load %.2f ms, decode %.2f ms, %u references",
+		ScanName,
+		Stats.BytesDecoded >> 20,
+		Stats.WorkRanges,
+		Stats.Instructions,
+		Stats.DecodeFailures,
+		Stats.LoadNs / 1e6,
+		Stats.DecodeNs / 1e6,
+		References.size());
+
+	return References;
+}
+
+void RTTI::BenchmarkCodeReferenceScan()
+{
+	// byte-wise heuristic: every offset of executable memory is treated as a rel32 (x64) or an absolute pointer (x86)
+	FScanPipeline Pipeline(Process->Process.ProcessHandle, ScanSettings);
+	std::vector<std::vector<std::pair<uintptr_t, uint32_t>>> ScannerHits(Pipeline.GetNumScanners());
+
+	Pipeline.Run(Process->GetExecutableRanges(),
+				 [&](const FMemoryBlock& Chunk, size_t ScannerIndex)
+				 {
+					 ScanBlock(Chunk, false,
+							   [&](uintptr_t Candidate, uintptr_t RealAddress)
+							   {
+								   const uint32_t ClassID = VTableIndex.Find(Candidate);
+								   if (ClassID != FAddressIndex::InvalidIndex)
+								   {
+									   ScannerHits[ScannerIndex].emplace_back(RealAddress, ClassID);
+								   }
+							   });
+				 });
+
+	const FScanPipelineStats ByteStats = Pipeline.GetStats();
+
+	FCodeScanner Scanner(Process);
+	Scanner.LoadRanges(Process->GetExecutableRanges());
+	const std::vector<FCodeReference> References = Scanner.FindReferences(VTableIndex);
+	const FCodeScanStats& DecodeStats = Scanner.GetStats();
+
+	// a byte hit is confirmed when it lies inside a decoded instruction that references the same vtable
+	std::vector<bool> bMatched(References.size(), false);
+	size_t NumByteHits = 0;
+	size_t NumConfirmed = 0;
+
+	for (const auto& Hits : ScannerHits)
+	{
+		NumByteHits += Hits.size();
+
+		for (const auto& [Address, ClassID] : Hits)
+		{
+			auto it = std::upper_bound(References.begin(), References.end(), Address, [](uintptr_t Value, const FCodeReference& Reference) { return Value < Reference.Instruction; });
+			if (it == References.begin())
+			{
+				continue;
+			}
+
+			--it;
+			if (Address < it->Instruction + it->Length && it->TargetIndex == ClassID)
+			{
+				NumConfirmed++;
+				bMatched[it - References.begin()] = true;
+			}
+		}
+	}
+
+	const size_t NumMissed = std::count(bMatched.begin(), bMatched.end(), false);
+
+	FLog::WriteF("Code reference benchmark: byte scan %.2f ms, %u hits (%u confirmed, %u junk)",
+		ByteStats.TotalNs / 1e6,
+		NumByteHits,
+		NumConfirmed,
+		NumByteHits - NumConfirmed);
+
+	FLog::WriteF("Code reference benchmark: decoder %.2f ms (load %.2f ms, decode %.2f ms), %u references (%u missed by byte scan)",
+		(DecodeStats.LoadNs + DecodeStats.DecodeNs) / 1e6,
+		DecodeStats.LoadNs / 1e6,
+		DecodeStats.DecodeNs / 1e6,
+		References.size(),
+		NumMissed);
+
+	bIsScanning.store(false, std::memory_order_release);
+}
+
+void RTTI::BenchmarkHashing()
+{
+	std::vector<FMemoryBlock> Sections;
+	size_t TotalSize = 0;
+
+	for (const FModuleSection& Section : Module->Sections)
+	{
+		FMemoryBlock& Block = Sections.emplace_back(Section.Start, Section.Size());
+		if (!ReadProcessMemory(Process->Process.ProcessHandle, Block.Address, Block.Copy.data(), Block.Size, NULL))
+		{
+			Sections.pop_back();
+			continue;
+		}
+		TotalSize += Block.Size;
+	}
+
+	if (TotalSize == 0)
+	{
+		FLog::WriteF("Hash benchmark: no readable sections in %s", ModuleName.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
+
+	// enough rounds for a few hundred megabytes, small modules are done in microseconds otherwise
+	constexpr size_t MinBytes = 256 * 1024 * 1024;
+	const size_t NumRounds = std::max<size_t>(MinBytes / TotalSize, 1);
+	const std::vector<FMemoryBlock> Copies = Sections;
+	uint64_t Sink = 0;
+
+	auto Measure = [&](const char* Name, const std::function<uint64_t(const FMemoryBlock&, const FMemoryBlock&)>& Function)
+	{
+		const auto StartTime = std::chrono::steady_clock::now();
+		for (size_t Round = 0; Round < NumRounds; Round++)
+		{
+			for (size_t i = 0; i < Sections.size(); i++)
+			{
+				Sink += Function(Sections[i], Copies[i]);
+			}
+		}
+
+		const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+		FLog::WriteF("Hash benchmark: %-22s %8.2f ms, %6.2f GB/s", Name, ElapsedMs, (TotalSize * NumRounds) / (ElapsedMs * 1e6));
+	};
+
+	FLog::WriteF("Hash benchmark: %u sections of %s, %.1f MB, %u rounds", Sections.size(), ModuleName.c_str(), TotalSize / (1024.0 * 1024.0), NumRounds);
+
+	Measure("memcmp", [](const FMemoryBlock& Block, const FMemoryBlock& Copy) { return static_cast<uint64_t>(memcmp(Block.Copy.data(), Copy.Copy.data(), Block.Size)); });
+	Measure("CRC-32", [](const FMemoryBlock& Block, const FMemoryBlock&) { return static_cast<uint64_t>(FHash::Crc32(Block.Copy.data(), Block.Size)); });
+	Measure("CRC-32C", [](const FMemoryBlock& Block, const FMemoryBlock&) { return static_cast<uint64_t>(FHash::Crc32C(Block.Copy.data(), Block.Size)); });
+	Measure("Hash64", [](const FMemoryBlock& Block, const FMemoryBlock&) { return FHash::Hash64(Block.Copy.data(), Block.Size); });
+	Measure("Page hashes, 1 thread", [](const FMemoryBlock& Block, const FMemoryBlock&) { return HashMemoryBlock(Block, 1).Hash.Low; });
+	Measure("Page hashes, parallel", [](const FMemoryBlock& Block, const FMemoryBlock&) { return HashMemoryBlock(Block).Hash.Low; });
+
+	// keeps the optimizer from dropping the loops
+	FLog::WriteF("Hash benchmark: done (%016llX)", static_cast<unsigned long long>(Sink));
+
+	bIsScanning.store(false, std::memory_order_release);
+}
+
+void RTTI::ScanForVirtualCalls()
+{
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	FCodeScanner Scanner(Process);
+	if (!Scanner.LoadRanges(GetExecutableSectionRanges()))
+	{
+		FLog::WriteF("Virtual call scan: failed to read executable sections of %s", ModuleName.c_str());
+		bIsScanning.store(false, std::memory_order_release);
+		return;
+	}
+
+	std::vector<FVirtualCall> Calls = Scanner.FindVirtualCalls(FunctionTable.GetAddressIndex());
+
+	std::vector<uint32_t> Counts;
+	std::vector<FVirtualCall> Bound;
+	for (const FVirtualCall& Call : Calls)
+	{
+		if (Call.Slot >= Counts.size())
+		{
+			Counts.resize(Call.Slot + 1);
+		}
+		Counts[Call.Slot]++;
+
+		if (Call.Caller != FAddressIndex::InvalidIndex)
+		{
+			Bound.push_back(Call);
+		}
+	}
+
+	std::sort(Bound.begin(), Bound.end(), [](const FVirtualCall& A, const FVirtualCall& B) { return A.Caller != B.Caller ? A.Caller < B.Caller : A.Slot < B.Slot; });
+
+	const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+	FLog::WriteF("Virtual call scan: %u call sites through %u distinct slots, %u bound to the calling class, %.2f ms (%llu instructions)",
+		Calls.size(),
+		std::count_if(Counts.begin(), Counts.end(), [](uint32_t Count) { return Count > 0; }),
+		Bound.size(),
+		ElapsedMs,
+		Scanner.GetStats().Instructions);
+
+	{
+		std::scoped_lock Lock(VirtualCallMutex);
+		BoundVirtualCalls = std::move(Bound);
+		SlotCallCounts = std::move(Counts);
+	}
+
+	bIsScanning.store(false, std::memory_order_release);
+}
+
+std::vector<FSlotCallCount> RTTI::GetVirtualCallCounts(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	std::scoped_lock Lock(VirtualCallMutex);
+	if (!CMeta || SlotCallCounts.empty())
+	{
+		return {};
+	}
+
+	const FVTableView VTable = FunctionTable.GetVTable(CMeta->ClassID);
+	std::vector<FSlotCallCount> Counts(VTable.size());
+
+	for (size_t Slot = 0; Slot < VTable.size() && Slot < SlotCallCounts.size(); Slot++)
+	{
+		Counts[Slot].Total = SlotCallCounts[Slot];
+	}
+
+	// calls made by the class's own virtual functions dispatch on an object of this class or a derived one
+	std::vector<uint32_t> Callers;
+	Callers.reserve(VTable.size());
+	for (uint32_t FunctionIndex : VTable)
+	{
+		Callers.push_back(FunctionIndex);
+	}
+	std::sort(Callers.begin(), Callers.end());
+	Callers.erase(std::unique(Callers.begin(), Callers.end()), Callers.end());
+
+	for (uint32_t Caller : Callers)
+	{
+		auto it = std::lower_bound(BoundVirtualCalls.begin(), BoundVirtualCalls.end(), Caller, [](const FVirtualCall& Call, uint32_t Value) { return Call.Caller < Value; });
+		for (; it != BoundVirtualCalls.end() && it->Caller == Caller; ++it)
+		{
+			if (it->Slot < Counts.size())
+			{
+				Counts[it->Slot].FromThis++;
+			}
+		}
+	}
+
+	return Counts;
+}
+
+void RTTI::ScanForAllClassInstances()
+{
+	for (const FInstanceHit& Hit : ScanInstances(Classes, "Instance scan (all classes)"))
+	{
+		Hit.Class->ClassInstances.push_back(Hit.Instance);
+	}
+
+	EstimateObjectSizesFromInstances();
+}
+
+void RTTI::ScanAll()
+{
+	for (const std::shared_ptr<ClassMetaData>& Class : Classes)
+	{
+		Class->CodeReferences.clear();
+		Class->ClassInstances.clear();
+	}
+
+	ScanForAllCodeReferences();
+	ScanForAllClassInstances();
+
+	bIsScanning.store(false, std::memory_order_release);
+}
+
+void RTTI::RunClassCensus(size_t SamplesPerClass)
+{
+	// only primary vtables are counted so an object with several vtable pointers is counted once
+	FAddressIndex CensusIndex;
+	CensusIndex.Reserve(Classes.size());
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		if (CMeta->CompleteClass.expired())
+		{
+			CensusIndex.Insert(CMeta->VTable, CMeta->ClassID);
+		}
+	}
+
+	struct FScannerCensus
+	{
+		std::vector<uint64_t> Counts;
+		std::vector<uintptr_t> Samples; // SamplesPerClass slots per class
+		uint64_t RandomState = 0;
+	};
+
+	FScanPipeline Pipeline(Process->Process.ProcessHandle, ScanSettings);
+	std::vector<FScannerCensus> Scanners(Pipeline.GetNumScanners());
+
+	for (size_t i = 0; i < Scanners.size(); i++)
+	{
+		Scanners[i].Counts.assign(Classes.size(), 0);
+		Scanners[i].Samples.assign(Classes.size() * SamplesPerClass, 0);
+		Scanners[i].RandomState = 0x9E3779B97F4A7C15ull * (i + 1);
+	}
+
+	auto NextRandom = [](uint64_t& State)
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return State;
+		};
+
+	Pipeline.Run(Process->GetReadableRanges(),
+				 [&](const FMemoryBlock& Chunk, size_t ScannerIndex)
+				 {
+					 FScannerCensus& Census = Scanners[ScannerIndex];
+
+					 ScanBlock(Chunk, true,
+							   [&](uintptr_t Candidate, uintptr_t RealAddress)
+							   {
+								   const uint32_t ClassID = CensusIndex.Find(Candidate);
+								   if (ClassID == FAddressIndex::InvalidIndex)
+								   {
+									   return;
+								   }
+
+								   const uint64_t Seen = ++Census.Counts[ClassID];
+								   if (SamplesPerClass == 0)
+								   {
+									   return;
+								   }
+
+								   // reservoir sampling, every hit has the same chance to end up as an example
+								   uint64_t Slot = Seen - 1;
+								   if (Seen > SamplesPerClass)
+								   {
+									   Slot = NextRandom(Census.RandomState) % Seen;
+								   }
+
+								   if (Slot < SamplesPerClass)
+								   {
+									   Census.Samples[ClassID * SamplesPerClass + Slot] = RealAddress;
+								   }
+							   });
+				 });
+
+	RecordScanStats(Pipeline, "Class census");
+
+	FClassCensus Census;
+	std::vector<uint64_t> Counts(Classes.size(), 0);
+	uint64_t MergeRandom = 0x2545F4914F6CDD1Dull;
+
+	for (size_t ClassID = 0; ClassID < Classes.size(); ClassID++)
+	{
+		for (const FScannerCensus& Scanner : Scanners)
+		{
+			Counts[ClassID] += Scanner.Counts[ClassID];
+		}
+
+		const uint64_t Previous = ClassID < PreviousCensusCounts.size() ? PreviousCensusCounts[ClassID] : 0;
+		if (Counts[ClassID] == 0 && Previous == 0)
+		{
+			continue;
+		}
+
+		FCensusEntry& Entry = Census.Entries.emplace_back();
+		Entry.Class = Classes[ClassID];
+		Entry.Count = Counts[ClassID];
+		Entry.Delta = static_cast<int64_t>(Counts[ClassID]) - static_cast<int64_t>(Previous);
+		Census.TotalInstances += Counts[ClassID];
+
+		// merge the per-scanner reservoirs, picking each scanner with a probability proportional to its count
+		std::vector<std::pair<uint64_t, std::vector<uintptr_t>>> Pools;
+		for (const FScannerCensus& Scanner : Scanners)
+		{
+			const uint64_t Count = Scanner.Counts[ClassID];
+			if (Count == 0 || SamplesPerClass == 0)
+			{
+				continue;
+			}
+
+			auto First = Scanner.Samples.begin() + ClassID * SamplesPerClass;
+			Pools.emplace_back(Count, std::vector<uintptr_t>(First, First + std::min<uint64_t>(Count, SamplesPerClass)));
+		}
+
+		uint64_t Remaining = Entry.Count;
+		while (Entry.Samples.size() < SamplesPerClass && Remaining > 0)
+		{
+			uint64_t Pick = NextRandom(MergeRandom) % Remaining;
+			auto Pool = Pools.begin();
+			while (Pick >= Pool->first)
+			{
+				Pick -= Pool->first;
+				++Pool;
+			}
+
+			Entry.Samples.push_back(Pool->second.back());
+			Pool->second.pop_back();
+
+			// every sample stands for an equal share of the scanner's hits
+			const uint64_t Share = Pool->second.empty() ? Pool->first : Pool->first / (Pool->second.size() + 1);
+			Pool->first -= Share;
+			Remaining -= Share;
+		}
+	}
+
+	std::sort(Census.Entries.begin(), Census.Entries.end(), [](const FCensusEntry& A, const FCensusEntry& B)
+		{
+			return A.Count != B.Count ? A.Count > B.Count : A.Class->Name < B.Class->Name;
+		});
+
+	FLog::WriteF("Class census: %llu instances of %u classes", Census.TotalInstances, Census.Entries.size());
+
+	{
+		std::scoped_lock Lock(CensusMutex);
+		Census.Generation = LastCensus.Generation + 1;
+		LastCensus = std::move(Census);
+		PreviousCensusCounts = std::move(Counts);
+	}
+
+	bIsScanning.store(false, std::memory_order_release);
+}
+
+void RTTI::RunClassCensusAsync(size_t SamplesPerClass)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::RunClassCensus, this, SamplesPerClass);
+	ScannerThread.detach();
+}
+
+FClassCensus RTTI::GetClassCensus(size_t TopN)
+{
+	std::scoped_lock Lock(CensusMutex);
+	FClassCensus Census;
+	Census.TotalInstances = LastCensus.TotalInstances;
+	Census.Generation = LastCensus.Generation;
+	Census.Entries.assign(LastCensus.Entries.begin(), LastCensus.Entries.begin() + std::min(TopN, LastCensus.Entries.size()));
+	return Census;
+}
+
+uint32_t RTTI::GetClassCensusGeneration()
+{
+	std::scoped_lock Lock(CensusMutex);
+	return LastCensus.Generation;
+}
+
+void RTTI::ScanAllAsync()
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::ScanAll, this);
+	ScannerThread.detach();
+}
+
+void RTTI::ScanForCodeReferencesAsync(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::ScanForCodeReferences, this, CMeta);
+	ScannerThread.detach();
+}
+
+void RTTI::SampleLayoutAsync(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::SampleLayout, this, CMeta);
+	ScannerThread.detach();
+}
+
+void RTTI::ExportHeaderAsync(const std::string& Path, const FHeaderExportSettings& Settings)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::ExportHeader, this, Path, Settings);
+	ScannerThread.detach();
+}
+
+void RTTI::ExportJsonAsync(const std::string& Path)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::ExportJson, this, Path);
+	ScannerThread.detach();
+}
+
+void RTTI::BenchmarkJsonExportAsync(size_t NumRecords)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::BenchmarkJsonExport, this, NumRecords);
+	ScannerThread.detach();
+}
+
+void RTTI::BenchmarkClassDiffAsync(size_t NumClasses)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::BenchmarkClassDiff, this, NumClasses);
+	ScannerThread.detach();
+}
+
+void RTTI::SaveDatabaseAsync(const std::string& Path)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::SaveDatabase, this, Path);
+	ScannerThread.detach();
+}
+
+void RTTI::DiffWithDatabaseAsync(const std::string& OldPath, const std::string& ReportPath)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::DiffWithDatabase, this, OldPath, ReportPath);
+	ScannerThread.detach();
+}
+
+void RTTI::BenchmarkCodeReferenceScanAsync()
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::BenchmarkCodeReferenceScan, this);
+	ScannerThread.detach();
+}
+
+void RTTI::BenchmarkHashingAsync()
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::BenchmarkHashing, this);
+	ScannerThread.detach();
+}
+
+void RTTI::ScanForVirtualCallsAsync()
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::ScanForVirtualCalls, this);
+	ScannerThread.detach();
+}
+
+void RTTI::ScanForClassInstancesAsync(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::ScanForClassInstances, this, CMeta);
+	ScannerThread.detach();
+}
+
+void RTTI::ScanForPolymorphicInstancesAsync(const std::shared_ptr<ClassMetaData>& Root)
+{
+	if (bIsScanning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	bIsScanning.store(true, std::memory_order_release);
+	ScannerThread = std::thread(&RTTI::ScanForPolymorphicInstances, this, Root);
+	ScannerThread.detach();
+}
+
+void RTTI::FindValidSections()
+{
+	SetProcessingStage("Finding valid PE sections");
+	bool bFoundExecutable = false;
+	bool bFoundReadOnly = false;
+
+	// find valid executable or read only sections
+	for (auto& section : Module->Sections)
+	{
+		if (section.bFlagExecutable)
+		{
+			ExecutableSections.push_back(section);
+			bFoundExecutable = true;
+			continue;
+		}
+
+		if (section.bFlagReadonly)
+		{
+			ReadOnlySections.push_back(section);
+			bFoundReadOnly = true;
+		}
+	}
+
+	if (!bFoundExecutable || !bFoundReadOnly)
+	{
+		FLog::Write("Failed to find valid sections for RTTI scan");
+		SetProcessingStage("Error: Failed to find valid sections for RTTI scan");
+	}
+}
+
+void RTTI::LoadImage()
+{
+	SetProcessingStage("Reading PE headers and relocations");
+
+	if (!Image.LoadFromProcess(Process, *Module) || !Image.HasRelocations())
+	{
+		// .reloc is discardable, if it is not mapped use the file on disk instead
+		FPEImage FileImage;
+		if (FileImage.LoadFromFile(Module->Path, reinterpret_cast<uintptr_t>(Module->BaseAddress)))
+		{
+			Image = std::move(FileImage);
+		}
+	}
+
+	if (!Image.HasRelocations())
+	{
+		FLog::WriteF("No base relocations found for %s, vtable sizes will be estimated", ModuleName.c_str());
+		return;
+	}
+
+	FLog::WriteF("Found %u pointer relocations in %s", Image.GetRelocations().size(), ModuleName.c_str());
+}
+
+void RTTI::ComputeFingerprint()
+{
+	SetProcessingStage("Fingerprinting module...");
+
+	const auto StartTime = std::chrono::steady_clock::now();
+	Fingerprint = FResultCache::ComputeFingerprint(Process, *Module, Image);
+	const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+
+	FLog::WriteF("Module fingerprint of %s: %08X %08X %08X %016llX in %.2f ms",
+		ModuleName.c_str(),
+		Fingerprint.TimeDateStamp,
+		Fingerprint.SizeOfImage,
+		Fingerprint.CheckSum,
+		static_cast<unsigned long long>(Fingerprint.RDataHash),
+		ElapsedMs);
+}
+
+bool RTTI::LoadCachedResults()
+{
+	const std::string Path = FResultCache::GetPath(ModuleName, Fingerprint);
+	if (Path.empty() || GetFileAttributesA(Path.c_str()) == INVALID_FILE_ATTRIBUTES)
+	{
+		return false;
+	}
+
+	SetProcessingStage("Loading cached results...");
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	FClassDatabase Database;
+	if (!Database.Open(Path) || !(Database.GetHeader().Fingerprint == Fingerprint) || Database.GetClasses().empty())
+	{
+		FLog::WriteF("Result cache: ignoring invalid entry %s", Path.c_str());
+		return false;
+	}
+
+	LoadDatabase(Database);
+
+	const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+	FLog::WriteF("Result cache: loaded %u classes and %u functions of %s from %s in %.2f ms",
+		Classes.size(),
+		FunctionTable.GetNumFunctions(),
+		ModuleName.c_str(),
+		Path.c_str(),
+		ElapsedMs);
+
+	return true;
+}
+
+void RTTI::SaveCachedResults()
+{
+	const std::string Path = FResultCache::GetPath(ModuleName, Fingerprint);
+
+	FClassDatabaseWriter Writer(*this);
+	if (Path.empty() || !Writer.Write(Path))
+	{
+		FLog::WriteF("Result cache: failed to store the results of %s", ModuleName.c_str());
+		DeleteFileA(Path.c_str());
+		return;
+	}
+
+	FLog::WriteF("Result cache: stored the results of %s in %s", ModuleName.c_str(), Path.c_str());
+}
+
+void RTTI::LoadDatabase(const FClassDatabase& Database)
+{
+	SetProcessingStage("Rebuilding classes from the database...");
+
+	const uintptr_t LoadAddress = GetLoadAddress();
+	const std::span<const FDatabaseClass> Records = Database.GetClasses();
+
+	Classes.clear();
+	Classes.reserve(Records.size());
+	VTableClassMap.clear();
+	NameClassMap.clear();
+	VTableIndex = FAddressIndex();
+	VTableIndex.Reserve(Records.size());
+
+	for (const FDatabaseClass& Record : Records)
+	{
+		std::shared_ptr<ClassMetaData> CMeta = std::make_shared<ClassMetaData>();
+		CMeta->ClassID = static_cast<uint32_t>(Classes.size());
+		CMeta->CompleteObjectLocator = LoadAddress + Record.CompleteObjectLocator;
+		CMeta->VTable = LoadAddress + Record.VTable;
+		CMeta->TypeDescriptor = LoadAddress + Record.TypeDescriptor;
+		CMeta->Name = Database.GetString(Record.Name);
+		CMeta->MangledName = Database.GetString(Record.MangledName);
+		CMeta->VTableOffset = Record.VTableOffset;
+		CMeta->ConstructorDisplacementOffset = Record.ConstructorDisplacementOffset;
+
+		// the base class array holds the class itself followed by every parent
+		CMeta->numBaseClasses = Record.Parents.Count + 1;
+
+		CMeta->bMultipleInheritance = (Record.Flags & DatabaseClassMultipleInheritance) != 0;
+		CMeta->bVirtualInheritance = (Record.Flags & DatabaseClassVirtualInheritance) != 0;
+		CMeta->bAmbigious = (Record.Flags & DatabaseClassAmbiguous) != 0;
+		CMeta->bStruct = (Record.Flags & DatabaseClassStruct) != 0;
+		CMeta->bInterface = (Record.Flags & DatabaseClassInterface) != 0;
+
+		CMeta->ObjectSize = Record.ObjectSize;
+		CMeta->ObjectSizeSource = static_cast<EObjectSizeSource>(Record.ObjectSizeSource);
+
+		const std::span<const uint32_t> Constructors = Database.GetConstructors(Record);
+		const std::span<const uint32_t> Destructors = Database.GetDestructors(Record);
+		CMeta->Constructors.assign(Constructors.begin(), Constructors.end());
+		CMeta->Destructors.assign(Destructors.begin(), Destructors.end());
+
+		for (int64_t Reference : Database.GetReferences(Record))
+		{
+			CMeta->CodeReferences.push_back(LoadAddress + static_cast<uintptr_t>(Reference));
+		}
+
+		// instances belong to the process the database was written from, they are rescanned instead
+
+		VTableIndex.Insert(CMeta->VTable, CMeta->ClassID);
+		VTableClassMap.insert(std::pair<uintptr_t, std::shared_ptr<ClassMetaData>>(CMeta->VTable, CMeta));
+		NameClassMap.insert(std::pair<std::string, std::shared_ptr<ClassMetaData>>(CMeta->Name, CMeta));
+		Classes.push_back(CMeta);
+	}
+
+	std::shared_ptr<ClassMetaData> LastClass = nullptr;
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		const FDatabaseClass& Record = Records[CMeta->ClassID];
+
+		// same grouping as ProcessClasses, interfaces follow the class they belong to
+		if (CMeta->bInterface && LastClass)
+		{
+			LastClass->Interfaces.push_back(CMeta);
+		}
+		else
+		{
+			LastClass = CMeta;
+		}
+
+		if (Record.CompleteClass < Classes.size() && Record.CompleteClass != CMeta->ClassID)
+		{
+			CMeta->CompleteClass = Classes[Record.CompleteClass];
+		}
+
+		for (const FDatabaseParent& ParentRecord : Database.GetParents(Record))
+		{
+			std::shared_ptr<ParentClass> ParentClassNode = std::make_shared<ParentClass>();
+			ParentClassNode->Name = Database.GetString(ParentRecord.Name);
+			ParentClassNode->MangledName = Database.GetString(ParentRecord.MangledName);
+			ParentClassNode->TypeDescriptor = LoadAddress + ParentRecord.TypeDescriptor;
+			ParentClassNode->numContainedBases = ParentRecord.NumContainedBases;
+			ParentClassNode->where = { ParentRecord.MemberDisplacement, ParentRecord.VBTableDisplacement, ParentRecord.VBTableOffset };
+			ParentClassNode->attributes = ParentRecord.Attributes;
+			ParentClassNode->TreeDepth = ParentRecord.TreeDepth;
+			ParentClassNode->ChildClass = CMeta;
+
+			if (ParentRecord.Class < Classes.size())
+			{
+				ParentClassNode->Class = Classes[ParentRecord.Class];
+			}
+
+			CMeta->Parents.push_back(ParentClassNode);
+		}
+	}
+
+	// functions are added in database order first so constructor and destructor indices stay valid
+	FunctionTable.Reset();
+	for (uint32_t FunctionIndex = 0; FunctionIndex < Database.GetFunctions().size(); FunctionIndex++)
+	{
+		FunctionTable.AddFunction(LoadAddress + static_cast<uintptr_t>(Database.GetFunction(FunctionIndex).Offset));
+	}
+
+	std::vector<uintptr_t> VTable;
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		VTable.clear();
+		for (const FDatabaseSlot& Slot : Database.GetSlots(Records[CMeta->ClassID]))
+		{
+			VTable.push_back(FunctionTable.GetAddress(Slot.Function));
+		}
+		FunctionTable.AddVTable(CMeta->ClassID, VTable);
+	}
+	FunctionTable.Finalize();
+
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		const std::span<const FDatabaseSlot> Slots = Database.GetSlots(Records[CMeta->ClassID]);
+		for (uint32_t Slot = 0; Slot < Slots.size(); Slot++)
+		{
+			FunctionTable.SetSlotStatus(CMeta->ClassID, Slot, static_cast<ESlotStatus>(Slots[Slot].Status));
+		}
+	}
+
+	for (uint32_t FunctionIndex = 0; FunctionIndex < Database.GetFunctions().size(); FunctionIndex++)
+	{
+		const FDatabaseFunction& Function = Database.GetFunction(FunctionIndex);
+		FunctionTable.SetOwner(FunctionIndex, { Function.OwnerClass, Function.OwnerSlot });
+		FunctionTable.SetSize(FunctionIndex, Function.Size);
+		FunctionTable.SetHash(FunctionIndex, Function.Hash);
+
+		if (Function.Name.Length > 0)
+		{
+			const ENameSource Source = (Function.Flags & DatabaseFunctionInferredName) ? ENameSource::Inferred : ENameSource::User;
+			FunctionTable.SetName(FunctionIndex, std::string(Database.GetString(Function.Name)), Source);
+		}
+	}
+
+	FunctionTable.BuildHashIndex();
+}
+
+std::vector<FMemoryRange> RTTI::GetExecutableSectionRanges() const
+{
+	std::vector<FMemoryRange> Ranges;
+	for (const FModuleSection& Section : ExecutableSections)
+	{
+		Ranges.emplace_back(Section.Start, Section.End, true, true, false);
+	}
+	return Ranges;
+}
+
+bool RTTI::IsInExecutableSection(uintptr_t Address)
+{
+	return std::any_of(ExecutableSections.begin(), ExecutableSections.end(), [&](const FModuleSection& Section) { return Section.Contains(Address); });
+}
+
+bool RTTI::IsInReadOnlySection(uintptr_t Address)
+{
+	return std::any_of(ReadOnlySections.begin(), ReadOnlySections.end(), [&](const FModuleSection& Section) { return Section.Contains(Address); });
+}
+
+void RTTI::ScanForClasses(std::vector<PotentialClass>& PotentialClasses)
+{
+	SetProcessingStage("Scanning for potential classes...");
+
+	// the copies are kept, vtables are sliced out of them later instead of being read one by one
+	SectionCopies.clear();
+	SectionCopies.reserve(ReadOnlySections.size());
+
+	for (const FModuleSection& Section : ReadOnlySections)
+	{
+		FMemoryBlock& SectionCopy = SectionCopies.emplace_back(Section.Start, Section.Size());
+		Process->Read(Section.Start, SectionCopy.Copy.data(), SectionCopy.Size);
+
+		const uintptr_t* SectionBuffer = reinterpret_cast<const uintptr_t*>(SectionCopy.Copy.data());
+		const size_t SectionMax = SectionCopy.Size / sizeof(uintptr_t);
+
+		for (size_t Index = 0; Index + 1 < SectionMax; Index++)
+		{
+			if (SectionBuffer[Index] == 0)
+			{
+				continue;
+			}
+
+			// first pointer is not a valid RTTI object or the second pointer is not a valid VTable function ptr
+			if (!IsInReadOnlySection(SectionBuffer[Index]) || !IsInExecutableSection(SectionBuffer[Index + 1]))
+			{
+				continue;
+			}
+
+			PotentialClass& PClass = PotentialClasses.emplace_back();
+			PClass.CompleteObjectLocator = SectionBuffer[Index];
+			// VTables are in order in MSVC so we can just add the index to the start of the section
+			PClass.VTable = Section.Start + (Index + 1) * sizeof(uintptr_t);
+		}
+	}
+
+	SortClasses(PotentialClasses);
+
+	FLog::WriteF("Found %u potential classes in %s\n", PotentialClasses.size(), ModuleName.c_str());
+}
+
+void RTTI::ValidateClasses(std::vector<PotentialClass>& PotentialClasses)
+{
+	SetProcessingStage("Validating potential classes...");
+
+	std::vector<PotentialClass> ValidatedClasses;
+	ValidatedClasses.reserve(PotentialClasses.size());
+
+	DWORD signatureMatch = IsRunning64Bits() ? 1 : 0;
+
+	for (PotentialClass& PClass : PotentialClasses)
+	{
+		RTTICompleteObjectLocator CompleteObjectLocator;
+		RTTITypeDescriptor TypeDescriptor;
+
+		Process->Read(PClass.CompleteObjectLocator, &CompleteObjectLocator, sizeof(RTTICompleteObjectLocator));
+
+		if (signatureMatch != CompleteObjectLocator.signature)
+		{
+			continue;
+		}
+
+		uintptr_t pTypeDescriptor = CompleteObjectLocator.pTypeDescriptor + ModuleBase;
+
+		if (!IsInReadOnlySection(pTypeDescriptor))
+		{
+			continue;
+		}
+
+		Process->Read(pTypeDescriptor, &TypeDescriptor, sizeof(RTTITypeDescriptor));
+
+		if (!IsInReadOnlySection(TypeDescriptor.pVTable))
+		{
+			continue;
+		}
+
+		char Name[StandardBufferSize];
+		Process->Read(pTypeDescriptor + offsetof(RTTITypeDescriptor, name), Name, StandardBufferSize);
+		Name[StandardBufferSize - 1] = 0;
+		PClass.Name = Name;
+		PClass.DemangledName = DemangleMSVC(Name);
+
+		ValidatedClasses.push_back(PClass);
+	}
+
+	ProcessClasses(ValidatedClasses);
+
+	FLog::WriteF("Found %u valid classes in %s\n", Classes.size(), ModuleName.c_str());
+}
+
+void RTTI::ProcessClasses(const std::vector<PotentialClass>& FinalClasses)
+{
+	SetProcessingStage("Processing class data...");
+
+	std::string LastClassName = "";
+	std::shared_ptr<ClassMetaData> LastClass = nullptr;
+
+	FunctionTable.Reset();
+
+	// every class gets the ClassID of its position
+	VTableIndex.Reserve(FinalClasses.size());
+	std::vector<uintptr_t> SortedVTables;
+	SortedVTables.reserve(FinalClasses.size());
+
+	for (size_t i = 0; i < FinalClasses.size(); i++)
+	{
+		VTableIndex.Insert(FinalClasses[i].VTable, static_cast<uint32_t>(i));
+		SortedVTables.push_back(FinalClasses[i].VTable);
+	}
+	std::sort(SortedVTables.begin(), SortedVTables.end());
+
+	for (const PotentialClass& PClassFinal : FinalClasses)
+	{
+		RTTICompleteObjectLocator CompleteObjectLocator;
+		RTTIClassHierarchyDescriptor ClassHierarchyDescriptor;
+
+		Process->Read(PClassFinal.CompleteObjectLocator, &CompleteObjectLocator, sizeof(RTTICompleteObjectLocator));
+		uintptr_t pClassDescriptor = CompleteObjectLocator.pClassDescriptor + ModuleBase;
+
+		Process->Read(pClassDescriptor, &ClassHierarchyDescriptor, sizeof(RTTIClassHierarchyDescriptor));
 
 		std::shared_ptr<ClassMetaData> ValidClass = std::make_shared<ClassMetaData>();
 		ValidClass->CompleteObjectLocator = PClassFinal.CompleteObjectLocator;
 		ValidClass->VTable = PClassFinal.VTable;
+		ValidClass->TypeDescriptor = CompleteObjectLocator.pTypeDescriptor + ModuleBase;
 		ValidClass->MangledName = PClassFinal.Name;
 		ValidClass->Name = PClassFinal.DemangledName;
 
-		FilterSymbol(ValidClass->Name);
+		FilterSymbol(ValidClass->Name);
+
+		ValidClass->VTableOffset = CompleteObjectLocator.offset;
+		ValidClass->ConstructorDisplacementOffset = CompleteObjectLocator.cdOffset;
+		ValidClass->numBaseClasses = ClassHierarchyDescriptor.numBaseClasses;
+
+		ValidClass->bMultipleInheritance = (ClassHierarchyDescriptor.attributes >> 0) & 1;
+		ValidClass->bVirtualInheritance = (ClassHierarchyDescriptor.attributes >> 1) & 1;
+		ValidClass->bAmbigious = (ClassHierarchyDescriptor.attributes >> 2) & 1;
+
+		if (ValidClass->MangledName[3] == 'U')
+		{
+			ValidClass->bStruct = true;
+		}
+
+		if (ValidClass->Name == LastClassName && ValidClass->bMultipleInheritance)
+		{
+			// TODO Fix interface detection.
+			ValidClass->bInterface = true;
+			LastClass->Interfaces.push_back(ValidClass);
+		}
+		else
+		{
+			LastClassName = ValidClass->Name;
+			LastClass = ValidClass;
+		}
+
+		ValidClass->ClassID = static_cast<uint32_t>(Classes.size());
+		EnumerateVirtualFunctions(ValidClass, GetVTableEnd(ValidClass->VTable, SortedVTables));
+
+		Classes.push_back(ValidClass);
+		VTableClassMap.insert(std::pair<uintptr_t, std::shared_ptr<ClassMetaData>>(ValidClass->VTable, ValidClass));
+		NameClassMap.insert(std::pair<std::string, std::shared_ptr<ClassMetaData>>(ValidClass->Name, ValidClass));
+	}
+
+	FunctionTable.Finalize();
+	FLog::WriteF("Function table: %u unique virtual functions in %u vtable slots, stored in %u shared chunks (%u KB)",
+		FunctionTable.GetNumFunctions(),
+		FunctionTable.GetNumSlots(),
+		FunctionTable.GetNumChunks(),
+		FunctionTable.GetNumChunks() * FVTableView::ChunkSize * sizeof(uint32_t) / 1024);
+
+	ProcessParentClasses();
+	LinkSecondaryVTables();
+	AnalyzeOverrides();
+	ResolveFunctionExtents();
+}
+
+void RTTI::ProcessParentClasses()
+{
+	// process parent classes
+	SetProcessingStage("Processing parent class data...");
+	
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		if (CMeta->numBaseClasses <= 1)
+		{
+			continue;
+		}
+
+		RTTICompleteObjectLocator CompleteObjectLocator;
+		RTTIClassHierarchyDescriptor ClassHierarchyDescriptor;
+
+		Process->Read(CMeta->CompleteObjectLocator, &CompleteObjectLocator, sizeof(RTTICompleteObjectLocator));
+
+		uintptr_t pClassDescriptor = CompleteObjectLocator.pClassDescriptor + ModuleBase;
+
+		Process->Read(pClassDescriptor, &ClassHierarchyDescriptor, sizeof(RTTIClassHierarchyDescriptor));
+
+		// the base class array is a pre-order walk of the hierarchy, entry 0 is the class itself
+		std::vector<DWORD> BaseClassArray(CMeta->numBaseClasses);
+		uintptr_t pBaseClassArray = ClassHierarchyDescriptor.pBaseClassArray + ModuleBase;
+		Process->Read(pBaseClassArray, BaseClassArray.data(), sizeof(DWORD) * BaseClassArray.size());
+
+		// number of entries left in the subtree of every base we are currently nested in
+		std::vector<DWORD> OpenSubtrees;
+
+		for (unsigned int i = 1; i < CMeta->numBaseClasses; i++)
+		{
+			RTTIBaseClassDescriptor BaseClassDescriptor;
+			std::shared_ptr<ParentClass> ParentClassNode = std::make_shared<ParentClass>();
+			Process->Read(BaseClassArray[i] + ModuleBase, &BaseClassDescriptor, sizeof(RTTIBaseClassDescriptor));
+
+			// process child name
+			char name[StandardBufferSize];
+
+			Process->Read((uintptr_t)BaseClassDescriptor.pTypeDescriptor + ModuleBase + offsetof(RTTITypeDescriptor, name), name, StandardBufferSize);
+			name[StandardBufferSize - 1] = 0;
+
+			ParentClassNode->MangledName = name;
+			ParentClassNode->Name = DemangleMSVC(name);
+			ParentClassNode->TypeDescriptor = (uintptr_t)BaseClassDescriptor.pTypeDescriptor + ModuleBase;
+			ParentClassNode->attributes = BaseClassDescriptor.attributes;
+			FilterSymbol(ParentClassNode->Name);
+
+			ParentClassNode->ChildClass = CMeta;
+			ParentClassNode->Class = FindFirst(ParentClassNode->Name);
+			ParentClassNode->numContainedBases = BaseClassDescriptor.numContainedBases;
+			ParentClassNode->where = BaseClassDescriptor.where;
+			ParentClassNode->TreeDepth = static_cast<DWORD>(OpenSubtrees.size());
+
+			for (DWORD& Remaining : OpenSubtrees)
+			{
+				Remaining--;
+			}
+
+			while (!OpenSubtrees.empty() && OpenSubtrees.back() == 0)
+			{
+				OpenSubtrees.pop_back();
+			}
+
+			if (BaseClassDescriptor.numContainedBases > 0)
+			{
+				OpenSubtrees.push_back(BaseClassDescriptor.numContainedBases);
+			}
+
+			if (CMeta->VTableOffset == ParentClassNode->where.mdisp && CMeta->bInterface)
+			{
+				std::string OriginalName = CMeta->Name;
+				CMeta->Name = OriginalName + " -> " + ParentClassNode->Name;
+				CMeta->MangledName = ParentClassNode->MangledName;
+			}
+			CMeta->Parents.push_back(ParentClassNode);
+		}
+	}
+}
+
+void RTTI::LinkSecondaryVTables()
+{
+	SetProcessingStage("Linking secondary vtables...");
+
+	// every vtable of a complete class shares its type descriptor, the one at offset 0 is the primary vtable
+	std::unordered_map<uintptr_t, std::shared_ptr<ClassMetaData>> PrimaryVTables;
+
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		if (CMeta->VTableOffset == 0)
+		{
+			PrimaryVTables.try_emplace(CMeta->TypeDescriptor, CMeta);
+		}
+	}
+
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		if (CMeta->VTableOffset == 0)
+		{
+			continue;
+		}
+
+		auto it = PrimaryVTables.find(CMeta->TypeDescriptor);
+		if (it != PrimaryVTables.end())
+		{
+			CMeta->CompleteClass = it->second;
+		}
+	}
+}
+
+std::shared_ptr<ClassMetaData> RTTI::GetVTableBase(const std::shared_ptr<ClassMetaData>& CMeta) const
+{
+	// the base array is in pre-order, the first non-virtual base at the vtable's offset is the one it extends
+	for (const std::shared_ptr<ParentClass>& Parent : CMeta->Parents)
+	{
+		if (Parent->where.pdisp != -1 || Parent->where.mdisp != static_cast<int>(CMeta->VTableOffset))
+		{
+			continue;
+		}
+
+		std::shared_ptr<ClassMetaData> Base = GetCompleteClass(Parent->Class.lock());
+		if (Base && Base != CMeta && Base->TypeDescriptor != CMeta->TypeDescriptor)
+		{
+			return Base;
+		}
+	}
+
+	return nullptr;
+}
+
+void RTTI::AnalyzeOverrides()
+{
+	SetProcessingStage("Analyzing overrides...");
+
+	// bases always have fewer base classes than their children, so this is a topological order
+	std::vector<uint32_t> Order(Classes.size());
+	std::iota(Order.begin(), Order.end(), 0);
+	std::stable_sort(Order.begin(), Order.end(), [this](uint32_t A, uint32_t B) { return Classes[A]->numBaseClasses < Classes[B]->numBaseClasses; });
+
+	size_t NumInherited = 0;
+	size_t NumOverridden = 0;
+
+	for (uint32_t ClassID : Order)
+	{
+		const std::shared_ptr<ClassMetaData>& CMeta = Classes[ClassID];
+		const FVTableView VTable = FunctionTable.GetVTable(ClassID);
+
+		std::shared_ptr<ClassMetaData> Base = GetVTableBase(CMeta);
+		const FVTableView BaseVTable = Base ? FunctionTable.GetVTable(Base->ClassID) : FVTableView();
+
+		for (uint32_t Slot = 0; Slot < VTable.size(); Slot++)
+		{
+			ESlotStatus Status = ESlotStatus::Introduced;
+			if (Slot < BaseVTable.size())
+			{
+				Status = VTable[Slot] == BaseVTable[Slot] ? ESlotStatus::Inherited : ESlotStatus::Overridden;
+			}
+
+			FunctionTable.SetSlotStatus(ClassID, Slot, Status);
+
+			if (Status == ESlotStatus::Inherited)
+			{
+				NumInherited++;
+				continue;
+			}
+
+			NumOverridden += Status == ESlotStatus::Overridden ? 1 : 0;
+
+			// inherited slots keep the owner their base already gave them
+			if (FunctionTable.GetOwner(VTable[Slot]).ClassID == FFunctionTable::InvalidIndex)
+			{
+				FunctionTable.SetOwner(VTable[Slot], { ClassID, Slot });
+			}
+		}
+	}
+
+	FLog::WriteF("Override analysis: %u inherited, %u overridden and %u introduced slots",
+		NumInherited,
+		NumOverridden,
+		FunctionTable.GetNumSlots() - NumInherited - NumOverridden);
+}
+
+void RTTI::ResolveFunctionExtents()
+{
+	if (!Image.HasRuntimeFunctions())
+	{
+		return;
+	}
+
+	SetProcessingStage("Resolving function extents...");
+
+	size_t NumResolved = 0;
+	size_t NumFragments = 0;
+	for (uint32_t FunctionIndex = 0; FunctionIndex < FunctionTable.GetNumFunctions(); FunctionIndex++)
+	{
+		FFunctionExtent Extent;
+		if (!Image.FindFunction(FunctionTable.GetAddress(FunctionIndex), Extent))
+		{
+			continue;
+		}
+
+		// thunks and adjustors can point into the middle of a function, the size is measured from the slot address
+		FunctionTable.SetSize(FunctionIndex, static_cast<uint32_t>(Extent.End - FunctionTable.GetAddress(FunctionIndex)));
+		NumResolved++;
+		NumFragments += Extent.PrimaryStart != Extent.Start ? 1 : 0;
+	}
+
+	FLog::WriteF("Function extents: %u of %u virtual functions resolved from %u runtime functions, %u chained fragments",
+		NumResolved,
+		FunctionTable.GetNumFunctions(),
+		Image.GetRuntimeFunctions().size(),
+		NumFragments);
+}
+
+FFunctionExtent RTTI::GetFunctionExtent(uint32_t FunctionIndex)
+{
+	FFunctionExtent Extent;
+	if (FunctionIndex >= FunctionTable.GetNumFunctions())
+	{
+		return Extent;
+	}
+
+	const uintptr_t Address = FunctionTable.GetAddress(FunctionIndex);
+	if (Image.FindFunction(Address, Extent))
+	{
+		return Extent;
+	}
+
+	Extent.Start = Address;
+	Extent.PrimaryStart = Address;
+
+	if (uint32_t Size = FunctionTable.GetSize(FunctionIndex))
+	{
+		Extent.End = Address + Size;
+		return Extent;
+	}
+
+	// no unwind data (x86, or leaf functions on x64), decode a local copy up to the first ret
+	constexpr size_t MaxFunctionSize = 0x1000;
+	std::vector<uint8_t> Buffer(MaxFunctionSize);
+	Process->Read(Address, Buffer.data(), Buffer.size());
+
+	static const Disassembler Decoder;
+	const size_t Size = Decoder.GetFunctionSize(Buffer.data(), Buffer.size());
+	FunctionTable.SetSize(FunctionIndex, static_cast<uint32_t>(Size));
+	Extent.End = Address + Size;
+	return Extent;
+}
+
+void RTTI::LoadDisassemblyCache()
+{
+	SetProcessingStage("Copying code sections for disassembly...");
+
+	DisassemblyCache = std::make_unique<FDisassemblyCache>(Process);
+	if (!DisassemblyCache->LoadCode(GetExecutableSectionRanges()))
+	{
+		FLog::WriteF("Failed to copy the code of %s, disassembly will read from the process", ModuleName.c_str());
+	}
+}
+
+void RTTI::AnalyzeCode()
+{
+	// one copy of the module's code serves every pass
+	FCodeScanner Code(Process);
+	if (!Code.LoadRanges(GetExecutableSectionRanges()))
+	{
+		FLog::WriteF("Failed to read executable sections of %s, skipping code analysis", ModuleName.c_str());
+		return;
+	}
+
+	FindConstructors(Code);
+	InferObjectSizes(Code);
+	HashFunctions(Code);
+}
+
+void RTTI::HashFunctions(FCodeScanner& Code)
+{
+	SetProcessingStage("Hashing virtual functions...");
+
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	static const Disassembler Decoder;
+	constexpr size_t MaxFunctionSize = 0x1000;
+
+	// no unwind data, same sweep up to the first ret as GetFunctionExtent
+	for (uint32_t FunctionIndex = 0; FunctionIndex < FunctionTable.GetNumFunctions(); FunctionIndex++)
+	{
+		if (FunctionTable.GetSize(FunctionIndex) != 0)
+		{
+			continue;
+		}
+
+		// functions near the end of their section have less than MaxFunctionSize bytes left to sweep
+		const uintptr_t Address = FunctionTable.GetAddress(FunctionIndex);
+		const size_t ReadSize = std::min(MaxFunctionSize, Code.GetLocalSize(Address));
+		if (const uint8_t* Body = ReadSize ? Code.GetLocalCopy(Address, ReadSize) : nullptr)
+		{
+			FunctionTable.SetSize(FunctionIndex, static_cast<uint32_t>(Decoder.GetFunctionSize(Body, ReadSize)));
+		}
+	}
+
+	const uintptr_t LoadAddress = GetLoadAddress();
+	const FFunctionHasher Hasher(LoadAddress, LoadAddress + Image.GetSizeOfImage());
+	const size_t NumHashed = Hasher.HashAll(FunctionTable, Code);
+
+	const double ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+
+	FLog::WriteF("Function hashes: %u of %u virtual functions hashed in %.1f ms", NumHashed, FunctionTable.GetNumFunctions(), ElapsedMs);
+}
+
+void RTTI::RenameFunction(uint32_t FunctionIndex, const std::string& Name)
+{
+	FunctionTable.SetName(FunctionIndex, Name);
+
+	if (FunctionTable.GetHash(FunctionIndex) == 0 || FunctionTable.FindFunctionByHash(FunctionTable.GetHash(FunctionIndex)) != FunctionIndex)
+	{
+		FLog::WriteF("%s shares its code with other functions, the name will not carry over to other builds", Name.c_str());
+	}
+
+	SaveAnnotations();
+}
+
+void RTTI::SaveAnnotations()
+{
+	// names of earlier builds stay in the file, names of this session replace theirs
+	const std::string Path = FFunctionAnnotations::GetPath(ModuleName);
+	FFunctionAnnotations Annotations;
+	if (Path.empty() || !Annotations.Load(Path))
+	{
+		FLog::WriteF("Failed to load function annotations %s", Path.c_str());
+		return;
+	}
+
+	Annotations.Collect(FunctionTable);
+	if (!Annotations.Save(Path))
+	{
+		FLog::WriteF("Failed to save function annotations %s", Path.c_str());
+	}
+}
+
+void RTTI::ApplyAnnotations()
+{
+	const std::string Path = FFunctionAnnotations::GetPath(ModuleName);
+	FFunctionAnnotations Annotations;
+	if (Path.empty() || !Annotations.Load(Path) || Annotations.size() == 0)
+	{
+		return;
+	}
+
+	const size_t NumApplied = Annotations.Apply(FunctionTable);
+	FLog::WriteF("Function annotations: %u of %u names applied from %s", NumApplied, Annotations.size(), Path.c_str());
+}
+
+void RTTI::FindConstructors(FCodeScanner& Code)
+{
+	SetProcessingStage("Finding constructors and destructors...");
+
+	std::vector<FVTableStore> Stores = Code.FindVTableStores(VTableIndex, FunctionTable.GetAddressIndex());
+
+	// the exception directory knows where functions start, the sweep only knows where padding ends
+	for (FVTableStore& Store : Stores)
+	{
+		FFunctionExtent Extent;
+		if (Image.FindFunction(Store.Instruction, Extent))
+		{
+			Store.Function = Extent.PrimaryStart;
+		}
+	}
+
+	std::stable_sort(Stores.begin(), Stores.end(), [](const FVTableStore& A, const FVTableStore& B) { return A.Function < B.Function; });
 
-		ValidClass->VTableOffset = CompleteObjectLocator.offset;
-		ValidClass->ConstructorDisplacementOffset = CompleteObjectLocator.cdOffset;
-		ValidClass->numBaseClasses = ClassHierarchyDescriptor.numBaseClasses;
+	size_t NumConstructors = 0;
+	size_t NumDestructors = 0;
+	size_t NumAmbiguous = 0;
 
-		ValidClass->bMultipleInheritance = (ClassHierarchyDescriptor.attributes >> 0) & 1;
-		ValidClass->bVirtualInheritance = (ClassHierarchyDescriptor.attributes >> 1) & 1;
-		ValidClass->bAmbigious = (ClassHierarchyDescriptor.attributes >> 2) & 1;
+	for (auto First = Stores.begin(); First != Stores.end();)
+	{
+		auto Last = std::find_if(First, Stores.end(), [&](const FVTableStore& Store) { return Store.Function != First->Function; });
 
-		if (ValidClass->MangledName[3] == 'U')
+		// complete classes whose vtable is written at its own offset into the object, in program order
+		std::vector<std::shared_ptr<ClassMetaData>> Written;
+		for (auto it = First; it != Last; ++it)
 		{
-			ValidClass->bStruct = true;
+			const std::shared_ptr<ClassMetaData>& VTableClass = Classes[it->VTableIndex];
+			if (static_cast<DWORD>(it->Offset) != VTableClass->VTableOffset)
+			{
+				continue;
+			}
+
+			std::shared_ptr<ClassMetaData> Complete = GetCompleteClass(VTableClass);
+			if (Written.empty() || Written.back() != Complete)
+			{
+				Written.push_back(Complete);
+			}
 		}
 
-		if (ValidClass->Name == LastClassName && ValidClass->bMultipleInheritance)
+		const uintptr_t FunctionStart = First->Function;
+		First = Last;
+
+		if (Written.empty())
 		{
-			// TODO Fix interface detection.
-			ValidClass->bInterface = true;
-			LastClass->Interfaces.push_back(ValidClass);
+			continue;
+		}
+
+		const std::shared_ptr<ClassMetaData>& FirstClass = Written.front();
+		const std::shared_ptr<ClassMetaData>& LastClass = Written.back();
+
+		std::shared_ptr<ClassMetaData> Subject;
+		bool bDestructor = false;
+
+		if (FirstClass == LastClass)
+		{
+			// a virtual function that resets its own class's vtable is the (deleting) destructor, anything else is the
+			// constructor of a class without bases or a non-virtual destructor, told apart by ResolveStructorCandidates
+			Subject = FirstClass;
+			const uint32_t VirtualIndex = FunctionTable.FindFunction(FunctionStart);
+			if (VirtualIndex == FFunctionTable::InvalidIndex || FunctionTable.GetSlots(VirtualIndex).empty())
+			{
+				const uint32_t FunctionIndex = AddSpecialFunction(FunctionStart);
+				std::vector<uint32_t>& Candidates = Subject->StructorCandidates;
+				if (std::find(Candidates.begin(), Candidates.end(), FunctionIndex) == Candidates.end())
+				{
+					Candidates.push_back(FunctionIndex);
+					NumAmbiguous++;
+				}
+				continue;
+			}
+			bDestructor = true;
+		}
+		else if (LastClass->IsChildOf(FirstClass))
+		{
+			// constructors install the base vtables first and the derived one last
+			Subject = LastClass;
+		}
+		else if (FirstClass->IsChildOf(LastClass))
+		{
+			// destructors restore the base vtables as the bases are torn down
+			Subject = FirstClass;
+			bDestructor = true;
 		}
 		else
 		{
-			LastClassName = ValidClass->Name;
-			LastClass = ValidClass;
+			continue;
 		}
 
-		EnumerateVirtualFunctions(ValidClass);
+		if (SetSpecialFunction(Subject, AddSpecialFunction(FunctionStart), bDestructor))
+		{
+			(bDestructor ? NumDestructors : NumConstructors)++;
+		}
+	}
 
-		Classes.push_back(ValidClass);
-		VTableClassMap.insert(std::pair<uintptr_t, std::shared_ptr<ClassMetaData>>(ValidClass->VTable, ValidClass));
-		NameClassMap.insert(std::pair<std::string, std::shared_ptr<ClassMetaData>>(ValidClass->Name, ValidClass));
+	const size_t NumResolved = ResolveStructorCandidates(Code);
+
+	FLog::WriteF("Constructor scan: %u vtable stores, %u constructor and %u destructor candidates, %u of %u single class functions resolved by their callers (%llu instructions)",
+		Stores.size(),
+		NumConstructors,
+		NumDestructors,
+		NumResolved,
+		NumAmbiguous,
+		Code.GetStats().Instructions);
+}
+
+uint32_t RTTI::AddSpecialFunction(uintptr_t FunctionStart)
+{
+	const uint32_t FunctionIndex = FunctionTable.AddFunction(FunctionStart);
+	if (FunctionTable.GetSize(FunctionIndex) == 0)
+	{
+		FFunctionExtent Extent;
+		if (Image.FindFunction(FunctionStart, Extent))
+		{
+			FunctionTable.SetSize(FunctionIndex, static_cast<uint32_t>(Extent.End - FunctionStart));
+		}
 	}
+	return FunctionIndex;
+}
 
-	ProcessParentClasses();
+bool RTTI::SetSpecialFunction(const std::shared_ptr<ClassMetaData>& Subject, uint32_t FunctionIndex, bool bDestructor)
+{
+	std::vector<uint32_t>& Functions = bDestructor ? Subject->Destructors : Subject->Constructors;
+	if (std::find(Functions.begin(), Functions.end(), FunctionIndex) != Functions.end())
+	{
+		return false;
+	}
+
+	Functions.push_back(FunctionIndex);
+	std::erase(Subject->StructorCandidates, FunctionIndex);
+
+	// Foo::Bar<int> gets Foo::Bar<int>::Bar and Foo::Bar<int>::~Bar
+	if (!FunctionTable.HasName(FunctionIndex))
+	{
+		FunctionTable.SetName(FunctionIndex, Subject->Name + (bDestructor ? "::~" : "::") + GetUnqualifiedName(Subject->Name), ENameSource::Inferred);
+	}
+	return true;
 }
 
-// TODO FIX Parent processing bugs
-void RTTI::ProcessParentClasses()
+size_t RTTI::ResolveStructorCandidates(FCodeScanner& Code)
 {
-	// process parent classes
-	SetProcessingStage("Processing parent class data...");
-	
+	// destructors call the destructors of their bases and members, deleting destructors call the plain one,
+	// constructors call constructors; a candidate only called from one side is resolved to it
+	std::unordered_set<uintptr_t> DestructorCallees;
+	std::unordered_set<uintptr_t> ConstructorCallees;
+	std::vector<std::pair<uint32_t, bool>> Pending; // function index, is destructor
+
 	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
 	{
-		if (CMeta->numBaseClasses <= 1)
+		for (uint32_t FunctionIndex : CMeta->Constructors)
+		{
+			Pending.emplace_back(FunctionIndex, false);
+		}
+		for (uint32_t FunctionIndex : CMeta->Destructors)
+		{
+			Pending.emplace_back(FunctionIndex, true);
+		}
+	}
+
+	size_t NumResolved = 0;
+	while (!Pending.empty())
+	{
+		for (const auto& [FunctionIndex, bDestructor] : Pending)
+		{
+			for (uintptr_t Callee : Code.FindDirectCallees(FunctionTable.GetAddress(FunctionIndex), FunctionTable.GetSize(FunctionIndex)))
+			{
+				(bDestructor ? DestructorCallees : ConstructorCallees).insert(Callee);
+			}
+		}
+		Pending.clear();
+
+		// resolved functions are decoded in the next round, their callees can resolve further candidates
+		for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+		{
+			const std::vector<uint32_t> Candidates = CMeta->StructorCandidates;
+			for (uint32_t FunctionIndex : Candidates)
+			{
+				const uintptr_t Address = FunctionTable.GetAddress(FunctionIndex);
+				const bool bFromDestructor = DestructorCallees.contains(Address);
+				if (bFromDestructor == ConstructorCallees.contains(Address))
+				{
+					continue;
+				}
+
+				SetSpecialFunction(CMeta, FunctionIndex, bFromDestructor);
+				Pending.emplace_back(FunctionIndex, bFromDestructor);
+				NumResolved++;
+			}
+		}
+	}
+
+	return NumResolved;
+}
+
+void RTTI::InferObjectSizes(FCodeScanner& Code)
+{
+	SetProcessingStage("Inferring object sizes from allocations...");
+
+	// constructors map to their ClassID, unresolved candidates past the last ClassID to their entry in Candidates
+	FAddressIndex ConstructorIndex;
+	std::vector<std::pair<uint32_t, uint32_t>> Candidates; // ClassID, function index
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		for (uint32_t FunctionIndex : CMeta->Constructors)
+		{
+			ConstructorIndex.Insert(FunctionTable.GetAddress(FunctionIndex), CMeta->ClassID);
+		}
+		for (uint32_t FunctionIndex : CMeta->StructorCandidates)
+		{
+			ConstructorIndex.Insert(FunctionTable.GetAddress(FunctionIndex), static_cast<uint32_t>(Classes.size() + Candidates.size()));
+			Candidates.emplace_back(CMeta->ClassID, FunctionIndex);
+		}
+	}
+
+	std::vector<FAllocationSite> Sites = Code.FindAllocationSites(ConstructorIndex);
+
+	// nothing but a constructor is called on freshly allocated memory
+	size_t NumPromoted = 0;
+	for (FAllocationSite& Site : Sites)
+	{
+		if (Site.ConstructorIndex < Classes.size())
 		{
 			continue;
 		}
 
-		// read class array (skip the first one)
-		std::unique_ptr<DWORD[]> baseClassArray = std::make_unique<DWORD[]>(0x4000);
+		const auto [ClassID, FunctionIndex] = Candidates[Site.ConstructorIndex - Classes.size()];
+		NumPromoted += SetSpecialFunction(Classes[ClassID], FunctionIndex, false) ? 1 : 0;
+		Site.ConstructorIndex = ClassID;
+	}
 
-		RTTICompleteObjectLocator CompleteObjectLocator;
-		RTTIClassHierarchyDescriptor ClassHierarchyDescriptor;
+	// the most common size wins, inlined base constructors or placement into a larger buffer are outvoted
+	std::sort(Sites.begin(), Sites.end(), [](const FAllocationSite& A, const FAllocationSite& B)
+		{
+			return A.ConstructorIndex != B.ConstructorIndex ? A.ConstructorIndex < B.ConstructorIndex : A.Size < B.Size;
+		});
 
-		std::vector<uintptr_t> BaseClasses;
-		BaseClasses.reserve(CMeta->numBaseClasses);
+	size_t NumSized = 0;
+	for (auto First = Sites.begin(); First != Sites.end();)
+	{
+		const uint32_t ClassID = First->ConstructorIndex;
+		uint32_t BestSize = 0;
+		size_t BestVotes = 0;
 
-		Process->Read(CMeta->CompleteObjectLocator, &CompleteObjectLocator, sizeof(RTTICompleteObjectLocator));
+		while (First != Sites.end() && First->ConstructorIndex == ClassID)
+		{
+			auto Last = std::find_if(First, Sites.end(), [&](const FAllocationSite& Site) { return Site.ConstructorIndex != ClassID || Site.Size != First->Size; });
+			if (static_cast<size_t>(Last - First) > BestVotes)
+			{
+				BestVotes = Last - First;
+				BestSize = First->Size;
+			}
+			First = Last;
+		}
 
-		uintptr_t pClassDescriptor = CompleteObjectLocator.pClassDescriptor + ModuleBase;
+		const std::shared_ptr<ClassMetaData>& CMeta = Classes[ClassID];
+		CMeta->ObjectSize = BestSize;
+		CMeta->ObjectSizeSource = EObjectSizeSource::Allocation;
+		NumSized++;
+	}
 
-		Process->Read(pClassDescriptor, &ClassHierarchyDescriptor, sizeof(RTTIClassHierarchyDescriptor));
+	FLog::WriteF("Object sizes: %u allocation sites, %u classes sized, %u constructors found by their allocations", Sites.size(), NumSized, NumPromoted);
+}
 
-		uintptr_t pBaseClassArray = ClassHierarchyDescriptor.pBaseClassArray + ModuleBase;
-		Process->Read(pBaseClassArray, baseClassArray.get(), sizeof(uintptr_t) * CMeta->numBaseClasses - 1);
+void RTTI::EstimateObjectSizesFromInstances()
+{
+	// gaps further apart than this are to unrelated allocations, not to the end of the object
+	constexpr uintptr_t MaxInstanceSpacing = 0x10000;
+	constexpr size_t MaxNeighbours = 8;
+	constexpr size_t MinGaps = 2;
 
-		for (unsigned int i = 0; i < CMeta->numBaseClasses - 1; ++i)
+	// the estimate only depends on the instances known now, earlier estimates are dropped
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		if (CMeta->ObjectSizeSource == EObjectSizeSource::InstanceSpacing)
 		{
-			BaseClasses.emplace_back(baseClassArray[i] + ModuleBase);
+			CMeta->ObjectSize = 0;
+			CMeta->ObjectSizeSource = EObjectSizeSource::Unknown;
 		}
+	}
 
-		DWORD LastDisplacement = 0;
-		DWORD Depth = 0;
+	struct FObject
+	{
+		uintptr_t Address = 0; // complete object start
+		uint32_t ClassID = 0; // complete class
+		uint32_t RangeIndex = 0; // into Ranges, gaps are only taken between objects of the same range
+	};
 
-		for (unsigned int i = 0; i < CMeta->numBaseClasses - 1; i++)
+	std::vector<FObject> Objects;
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		for (const FClassInstance& Instance : CMeta->ClassInstances)
 		{
-			RTTIBaseClassDescriptor BaseClassDescriptor;
-			std::shared_ptr<ParentClass> ParentClassNode = std::make_shared<ParentClass>();
-			Process->Read(BaseClasses[i], &BaseClassDescriptor, sizeof(RTTIBaseClassDescriptor));
+			Objects.push_back({ Instance.Address, GetCompleteClass(CMeta)->ClassID, 0 });
+		}
+	}
 
-			// process child name
-			char name[StandardBufferSize];
+	std::sort(Objects.begin(), Objects.end(), [](const FObject& A, const FObject& B) { return A.Address < B.Address; });
+	Objects.erase(std::unique(Objects.begin(), Objects.end(), [](const FObject& A, const FObject& B) { return A.Address == B.Address; }), Objects.end());
 
-			Process->Read((uintptr_t)BaseClassDescriptor.pTypeDescriptor + ModuleBase + offsetof(RTTITypeDescriptor, name), name, StandardBufferSize);
-			name[StandardBufferSize - 1] = 0;
+	std::vector<FMemoryRange> Ranges = Process->GetReadableRanges();
+	std::sort(Ranges.begin(), Ranges.end(), [](const FMemoryRange& A, const FMemoryRange& B) { return A.Start < B.Start; });
 
-			ParentClassNode->MangledName = name;
-			ParentClassNode->Name = DemangleMSVC(name);
-			ParentClassNode->attributes = BaseClassDescriptor.attributes;
-			FilterSymbol(ParentClassNode->Name);
+	// objects inside the allocation sized extent of an earlier object are members of it, not neighbours
+	std::vector<FObject> Independent;
+	std::vector<uint32_t> NumObjects(Classes.size(), 0);
+	uintptr_t ContainerEnd = 0;
+	for (FObject& Object : Objects)
+	{
+		auto Range = std::upper_bound(Ranges.begin(), Ranges.end(), Object.Address, [](uintptr_t Address, const FMemoryRange& Range) { return Address < Range.Start; });
+		if (Range == Ranges.begin() || !(--Range)->Contains(Object.Address) || Object.Address < ContainerEnd)
+		{
+			continue;
+		}
 
-			ParentClassNode->ChildClass = CMeta;
-			ParentClassNode->Class = FindFirst(ParentClassNode->Name);
-			ParentClassNode->numContainedBases = BaseClassDescriptor.numContainedBases;
-			ParentClassNode->where = BaseClassDescriptor.where;
+		Object.RangeIndex = static_cast<uint32_t>(Range - Ranges.begin());
+		const ClassMetaData& Class = *Classes[Object.ClassID];
+		if (Class.ObjectSizeSource == EObjectSizeSource::Allocation)
+		{
+			ContainerEnd = Object.Address + Class.ObjectSize;
+		}
 
-			if (BaseClassDescriptor.where.mdisp == LastDisplacement)
-			{
-				Depth++;
-			}
-			else
+		Independent.push_back(Object);
+		NumObjects[Object.ClassID]++;
+	}
+
+	auto GetGap = [&](size_t From, size_t To) -> uintptr_t
+	{
+		if (To >= Independent.size() || Independent[To].RangeIndex != Independent[From].RangeIndex)
+		{
+			return 0;
+		}
+
+		const uintptr_t Gap = Independent[To].Address - Independent[From].Address;
+		return Gap <= MaxInstanceSpacing ? Gap : 0;
+	};
+
+	// a different class at the same offset behind most instances of a class is a polymorphic member
+	// whose extent is unknown, such as a B at +0x10 of every A; it is skipped like a known member
+	using FMemberKey = std::tuple<uint32_t, uint32_t, uintptr_t>; // class, member class, offset
+	std::vector<FMemberKey> Pairs;
+	for (size_t i = 0; i + 1 < Independent.size(); i++)
+	{
+		const uintptr_t Gap = GetGap(i, i + 1);
+		if (Gap != 0 && Independent[i].ClassID != Independent[i + 1].ClassID)
+		{
+			Pairs.emplace_back(Independent[i].ClassID, Independent[i + 1].ClassID, Gap);
+		}
+	}
+	std::sort(Pairs.begin(), Pairs.end());
+
+	std::vector<FMemberKey> Members;
+	for (auto First = Pairs.begin(); First != Pairs.end();)
+	{
+		auto Last = std::find_if(First, Pairs.end(), [&](const FMemberKey& Key) { return Key != *First; });
+		const size_t Count = Last - First;
+		if (Count >= 2 && Count * 2 > NumObjects[std::get<0>(*First)])
+		{
+			Members.push_back(*First);
+		}
+		First = Last;
+	}
+
+	// in arrays the container also sits at a fixed offset behind its member, the closer relation is the member
+	std::vector<FMemberKey> Candidates = Members;
+	std::erase_if(Members, [&](const FMemberKey& Key)
+		{
+			auto Reverse = std::lower_bound(Candidates.begin(), Candidates.end(), FMemberKey(std::get<1>(Key), std::get<0>(Key), 0));
+			return Reverse != Candidates.end() && std::get<0>(*Reverse) == std::get<1>(Key) && std::get<1>(*Reverse) == std::get<0>(Key)
+				&& std::get<2>(*Reverse) < std::get<2>(Key);
+		});
+
+	// distance to the first neighbour that is not a member, per class
+	std::vector<std::vector<uint32_t>> Gaps(Classes.size());
+	for (size_t i = 0; i < Independent.size(); i++)
+	{
+		for (size_t Next = i + 1; Next <= i + MaxNeighbours; Next++)
+		{
+			const uintptr_t Gap = GetGap(i, Next);
+			if (Gap == 0)
 			{
-				LastDisplacement = BaseClassDescriptor.where.mdisp;
-				Depth = 0;
+				break;
 			}
 
-			ParentClassNode->TreeDepth = Depth;
-
-			if (CMeta->VTableOffset == ParentClassNode->where.mdisp && CMeta->bInterface)
+			if (!std::binary_search(Members.begin(), Members.end(), FMemberKey(Independent[i].ClassID, Independent[Next].ClassID, Gap)))
 			{
-				std::string OriginalName = CMeta->Name;
-				CMeta->Name = OriginalName + " -> " + ParentClassNode->Name;
-				CMeta->MangledName = ParentClassNode->MangledName;
+				Gaps[Independent[i].ClassID].push_back(static_cast<uint32_t>(Gap));
+				break;
 			}
-			CMeta->Parents.push_back(ParentClassNode);
 		}
 	}
+
+	// the lower quartile, a single object packed against an unrelated one does not decide the size
+	size_t NumSized = 0;
+	for (const std::shared_ptr<ClassMetaData>& CMeta : Classes)
+	{
+		std::vector<uint32_t>& ClassGaps = Gaps[CMeta->ClassID];
+		if (CMeta->ObjectSizeSource == EObjectSizeSource::Allocation || ClassGaps.size() < MinGaps)
+		{
+			continue;
+		}
+
+		auto Quartile = ClassGaps.begin() + (ClassGaps.size() - 1) / 4;
+		std::nth_element(ClassGaps.begin(), Quartile, ClassGaps.end());
+
+		CMeta->ObjectSize = *Quartile;
+		CMeta->ObjectSizeSource = EObjectSizeSource::InstanceSpacing;
+		NumSized++;
+	}
+
+	if (NumSized > 0)
+	{
+		FLog::WriteF("Object sizes: %u classes bounded by instance spacing, %u member relations skipped", NumSized, Members.size());
+	}
+}
+
+const char* RTTI::GetObjectSizeSourceName(EObjectSizeSource Source)
+{
+	switch (Source)
+	{
+	case EObjectSizeSource::Allocation: return "allocation";
+	case EObjectSizeSource::InstanceSpacing: return "instance spacing, upper bound";
+	default: return "unknown";
+	}
+}
+
+void RTTI::RequestDisassembly(uint32_t FunctionIndex)
+{
+	if (!DisassemblyCache || FunctionIndex >= FunctionTable.GetNumFunctions())
+	{
+		return;
+	}
+
+	DisassemblyCache->Request(FunctionTable.GetAddress(FunctionIndex), FunctionTable.GetSize(FunctionIndex));
 }
 
+void RTTI::PrefetchDisassembly(const std::shared_ptr<ClassMetaData>& CMeta)
+{
+	if (!DisassemblyCache || !CMeta)
+	{
+		return;
+	}
 
+	for (uint32_t FunctionIndex : FunctionTable.GetVTable(CMeta->ClassID))
+	{
+		RequestDisassembly(FunctionIndex);
+	}
+}
 
-void RTTI::EnumerateVirtualFunctions(const std::shared_ptr<ClassMetaData>& CMeta)
+std::string RTTI::GetFunctionName(uint32_t FunctionIndex) const
 {
-	constexpr int MaximumVirtualFunctions = 0x4000;
-	static std::unique_ptr<uintptr_t[]> buffer = std::make_unique<uintptr_t[]>(MaximumVirtualFunctions);
+	if (FunctionIndex >= FunctionTable.GetNumFunctions())
+	{
+		return "<unknown>";
+	}
+
+	if (FunctionTable.HasName(FunctionIndex))
+	{
+		return FunctionTable.GetName(FunctionIndex);
+	}
+
+	const FFunctionSlot Owner = FunctionTable.GetOwner(FunctionIndex);
+	if (Owner.ClassID < Classes.size())
+	{
+		return Classes[Owner.ClassID]->Name + "::vf" + std::to_string(Owner.Slot);
+	}
 
-	memset(buffer.get(), 0, sizeof(uintptr_t) * MaximumVirtualFunctions);
+	return FunctionTable.GetName(FunctionIndex);
+}
 
-	CMeta->Functions.clear();
+uintptr_t RTTI::GetVTableEnd(uintptr_t VTable, const std::vector<uintptr_t>& SortedVTables) const
+{
+	// a vtable never runs into the COL slot of the vtable that follows it, or past the end of its section
+	uintptr_t End = UINTPTR_MAX;
 
-	Process->Read(CMeta->VTable, buffer.get(), MaximumVirtualFunctions);
+	auto Next = std::upper_bound(SortedVTables.begin(), SortedVTables.end(), VTable);
+	if (Next != SortedVTables.end())
+	{
+		End = *Next - sizeof(uintptr_t);
+	}
 
-	for (size_t i = 0; i < MaximumVirtualFunctions / sizeof(uintptr_t); i++)
+	for (const FMemoryBlock& SectionCopy : SectionCopies)
 	{
-		if (buffer[i] == 0)
+		const uintptr_t SectionStart = reinterpret_cast<uintptr_t>(SectionCopy.Address);
+		if (VTable >= SectionStart && VTable < SectionStart + SectionCopy.Size)
 		{
+			End = std::min(End, SectionStart + SectionCopy.Size);
 			break;
 		}
+	}
+
+	// with relocations every slot has a fixup, the first slot without one ends the vtable
+	if (Image.HasRelocations() && End != UINTPTR_MAX)
+	{
+		const size_t MaxSlots = (End - VTable) / sizeof(uintptr_t);
+		End = VTable + Image.CountRelocatedSlots(VTable, MaxSlots) * sizeof(uintptr_t);
+	}
+
+	return End;
+}
+
+const uint8_t* RTTI::GetSectionCopy(uintptr_t Address, size_t Size) const
+{
+	for (const FMemoryBlock& SectionCopy : SectionCopies)
+	{
+		const uintptr_t SectionStart = reinterpret_cast<uintptr_t>(SectionCopy.Address);
+		if (Address >= SectionStart && Address + Size <= SectionStart + SectionCopy.Size)
+		{
+			return SectionCopy.Copy.data() + (Address - SectionStart);
+		}
+	}
+
+	return nullptr;
+}
+
+void RTTI::EnumerateVirtualFunctions(const std::shared_ptr<ClassMetaData>& CMeta, uintptr_t VTableEnd)
+{
+	constexpr size_t MaximumVirtualFunctions = 0x800;
+
+	std::vector<uintptr_t> Functions;
+
+	const size_t NumSlots = std::min<size_t>((VTableEnd - CMeta->VTable) / sizeof(uintptr_t), MaximumVirtualFunctions);
+	const uint8_t* Slots = NumSlots ? GetSectionCopy(CMeta->VTable, NumSlots * sizeof(uintptr_t)) : nullptr;
+
+	if (NumSlots && !Slots)
+	{
+		FLog::WriteF("VTable of %s at 0x%p is outside the copied sections", CMeta->Name.c_str(), CMeta->VTable);
+	}
+
+	for (size_t i = 0; Slots && i < NumSlots; i++)
+	{
+		uintptr_t Function = 0;
+		memcpy(&Function, Slots + i * sizeof(uintptr_t), sizeof(uintptr_t));
 
-		if (!IsInExecutableSection(buffer[i]))
+		// without relocations the bound may still cover an adjacent function pointer table or padding
+		if (Function == 0 || !IsInExecutableSection(Function))
 		{
 			break;
 		}
 
-		CMeta->Functions.push_back(buffer[i]);
-
-		std::string function_name = "sub_" + IntegerToHexStr(buffer[i]);
-		CMeta->FunctionNames.try_emplace(buffer[i], function_name);
+		Functions.push_back(Function);
 	}
+
+	FunctionTable.AddVTable(CMeta->ClassID, Functions);
 }
 
 std::string RTTI::DemangleMSVC(char* Symbol)
@@ -618,7 +2787,7 @@ std::string RTTI::DemangleMSVC(char* Symbol)
 		pSymbol = Symbol + 2;
 	else
 	{
-		ClassDumper3::LogF("Unknown symbol format: %s", Symbol);
+		FLog::WriteF("Unknown symbol format: %s", Symbol);
 		return std::string(Symbol);
 	}
 
@@ -629,7 +2798,7 @@ std::string RTTI::DemangleMSVC(char* Symbol)
 	std::memset(StringBuffer, 0, StandardBufferSize);
 	if (!UnDecorateSymbolName(ModifiedSymbol.c_str(), StringBuffer, StandardBufferSize, 0))
 	{
-		ClassDumper3::LogF("UnDecorateSymbolName failed: %s", Symbol);
+		FLog::WriteF("UnDecorateSymbolName failed: %s", Symbol);
 		return std::string(Symbol);
 	}
 
@@ -656,28 +2825,6 @@ void RTTI::FilterSymbol(std::string& Symbol)
 	}
 }
 
-void RTTI::ScanAllMemory(std::vector<std::future<FMemoryBlock>>& Blocks, bool isForInstances)
-{
-	std::mutex mtx;
-	ThreadPool pool(std::thread::hardware_concurrency());
-
-	for (auto& Block : Blocks)
-	{
-		pool.enqueue(
-			[&]() mutable
-			{
-				Block.wait();
-				FMemoryBlock MemoryBlock = Block.get();
-				if (!MemoryBlock.IsValid())
-				{
-					return;
-				}
-
-				ProcessMemoryBlock(MemoryBlock, isForInstances, mtx);
-			});
-	}
-}
-
 void RTTI::SetProcessingStage(const std::string& Stage)
 {
 	std::scoped_lock Lock(ProcessingStageMutex);
@@ -687,7 +2834,7 @@ void RTTI::SetProcessingStage(const std::string& Stage)
 
 bool ClassMetaData::IsChildOf(const std::shared_ptr<ClassMetaData>& CMeta) const
 {
-	return std::any_of(Parents.begin(), Parents.end(), [&](const std::shared_ptr<ParentClass>& Parent) { return Parent->Name == CMeta->Name; });
+	return std::any_of(Parents.begin(), Parents.end(), [&](const std::shared_ptr<ParentClass>& Parent) { return Parent->TypeDescriptor == CMeta->TypeDescriptor; });
 }
 
 // Force RTTI/vtable generation for all test types
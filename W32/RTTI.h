@@ -1,5 +1,20 @@
 #pragma once
 #include "Memory.h"
+#include "InstanceValidator.h"
+#include "ScanPipeline.h"
+#include "CodeScanner.h"
+#include "PEImage.h"
+#include "FunctionTable.h"
+#include "DisassemblyCache.h"
+#include "LayoutSampler.h"
+#include "HeaderExporter.h"
+#include "JsonExporter.h"
+#include "ClassDatabase.h"
+#include "ClassDiff.h"
+#include "ResultCache.h"
+#include "MemoryHash.h"
+#include "FunctionHash.h"
+#include "../Util/AddressIndex.h"
 #include <atomic>
 #include <typeinfo>
 
@@ -88,10 +103,62 @@ struct PotentialClass
 };
 
 struct ParentClass;
+struct ClassMetaData;
+
+struct FClassInstance
+{
+	uintptr_t Address = 0; // start of the complete object
+	uint8_t Confidence = 100; // 0-100, set by FInstanceValidator
+	EInstanceRegion Region = EInstanceRegion::Unknown;
+};
+
+// instance hit normalized to the start of its complete object
+struct FInstanceHit
+{
+	FClassInstance Instance;
+	ClassMetaData* Class = nullptr; // complete class
+};
+
+struct FInstanceGroup
+{
+	std::shared_ptr<ClassMetaData> Class; // concrete class owning the hits
+	std::vector<FClassInstance> Instances;
+};
+
+struct FCensusEntry
+{
+	std::shared_ptr<ClassMetaData> Class;
+	uint64_t Count = 0;
+	int64_t Delta = 0; // against the previous census
+	std::vector<uintptr_t> Samples; // reservoir sampled example addresses
+};
+
+struct FClassCensus
+{
+	std::vector<FCensusEntry> Entries; // sorted by count, highest first
+	uint64_t TotalInstances = 0;
+	uint32_t Generation = 0;
+};
+
+struct FSlotCallCount
+{
+	uint32_t Total = 0; // call sites through this slot index of any vtable
+	uint32_t FromThis = 0; // call sites inside the class's own virtual functions, through the vtable of this
+};
+
+enum class EObjectSizeSource : uint8_t
+{
+	Unknown,
+	Allocation, // immediate size of an allocation whose result is passed to a constructor
+	InstanceSpacing // lower quartile of the distances from instances to the next independent object in the same region
+};
+
 struct ClassMetaData
 {
+	uint32_t ClassID = 0; // index into RTTI::GetClasses()
 	uintptr_t CompleteObjectLocator = 0;
 	uintptr_t VTable = 0;
+	uintptr_t TypeDescriptor = 0;
 
 	std::string Name;
 	std::string MangledName;
@@ -99,14 +166,29 @@ struct ClassMetaData
 	DWORD VTableOffset = 0;
 	DWORD ConstructorDisplacementOffset = 0;
 
-	std::vector<uintptr_t> Functions;
-	std::map<uintptr_t, std::string> FunctionNames; // map of function addresses to names
-
 	DWORD numBaseClasses = 0;
 	std::vector<std::shared_ptr<ParentClass>> Parents;
 	std::vector<std::weak_ptr<ClassMetaData>> Interfaces;
+
+	// for secondary vtables (VTableOffset != 0), the entry holding the primary vtable of the same complete class
+	std::weak_ptr<ClassMetaData> CompleteClass;
+
 	std::vector<uintptr_t> CodeReferences;
-	std::vector<uintptr_t> ClassInstances;
+	std::vector<FClassInstance> ClassInstances;
+
+	// function table indices of functions that store this class's vtable, see RTTI::FindConstructors
+	std::vector<uint32_t> Constructors;
+	std::vector<uint32_t> Destructors;
+
+	// non-virtual functions that write only this class's vtable: the constructor of a class without bases
+	// and a non-virtual destructor look the same, these are the ones neither callers nor allocations resolved
+	std::vector<uint32_t> StructorCandidates;
+
+	uint32_t ObjectSize = 0; // sizeof the complete object, 0 if unknown
+	EObjectSizeSource ObjectSizeSource = EObjectSizeSource::Unknown;
+
+	// pointer sized fields inferred from live instances, see RTTI::SampleLayout
+	std::vector<FFieldLayout> Members;
 
 	bool bMultipleInheritance = false;
 	bool bVirtualInheritance = false;
@@ -122,6 +204,7 @@ struct ParentClass
 	// basic class info
 	std::string Name;
 	std::string MangledName;
+	uintptr_t TypeDescriptor = 0;
 	DWORD numContainedBases = 0;
 	PMD where = { 0,0,0 };
 	DWORD attributes = 0;
@@ -151,6 +234,38 @@ public:
 	std::vector<std::shared_ptr<ClassMetaData>> FindAll(const std::string& ClassName);
 	std::vector<std::shared_ptr<ClassMetaData>> FindChildClasses(const std::shared_ptr<ClassMetaData>& CMeta);
 	std::vector<std::shared_ptr<ClassMetaData>> GetClasses();
+	const std::string& GetModuleName() const { return ModuleName; }
+	uintptr_t GetModuleBase() const { return ModuleBase; }
+
+	// where the module is mapped in the target, GetModuleBase is 0 on x86 where RTTI holds absolute addresses
+	uintptr_t GetLoadAddress() const { return reinterpret_cast<uintptr_t>(Module->BaseAddress); }
+	uint32_t GetSizeOfImage() const { return Image.GetSizeOfImage(); }
+	const FModuleFingerprint& GetModuleFingerprint() const { return Fingerprint; }
+	std::shared_ptr<ClassMetaData> GetClass(uint32_t ClassID) const { return ClassID < Classes.size() ? Classes[ClassID] : nullptr; }
+
+	// virtual functions of every class, slots are looked up by ClassID
+	FFunctionTable& GetFunctionTable() { return FunctionTable; }
+	size_t GetNumFunctions(const std::shared_ptr<ClassMetaData>& CMeta) const { return FunctionTable.GetVTable(CMeta->ClassID).size(); }
+
+	// the user given name, or Owner::vfN after the class that introduced or last overrode the function
+	std::string GetFunctionName(uint32_t FunctionIndex) const;
+
+	// names the function and records the name under its hash, so it is applied again in later builds of the module
+	void RenameFunction(uint32_t FunctionIndex, const std::string& Name);
+
+	// start and end of a virtual function, exact from the exception directory on x64, otherwise decoded up to the first ret
+	FFunctionExtent GetFunctionExtent(uint32_t FunctionIndex);
+
+	// decoded listings of virtual functions, nullptr until the module is processed
+	FDisassemblyCache* GetDisassemblyCache() { return DisassemblyCache.get(); }
+	void RequestDisassembly(uint32_t FunctionIndex);
+	void PrefetchDisassembly(const std::shared_ptr<ClassMetaData>& CMeta);
+
+	// virtual call sites per slot of the class's vtable, empty until ScanForVirtualCalls ran
+	std::vector<FSlotCallCount> GetVirtualCallCounts(const std::shared_ptr<ClassMetaData>& CMeta);
+
+	// the class whose vtable this vtable extends: the base at the same offset of the complete object
+	std::shared_ptr<ClassMetaData> GetVTableBase(const std::shared_ptr<ClassMetaData>& CMeta) const;
 
 	void ProcessRTTI();
 	
@@ -162,12 +277,57 @@ public:
 	
 	
 	void ScanAllAsync();
+	void RunClassCensusAsync(size_t SamplesPerClass = 4);
+	FClassCensus GetClassCensus(size_t TopN);
+	uint32_t GetClassCensusGeneration();
 	void ScanForCodeReferencesAsync(const std::shared_ptr<ClassMetaData>& CMeta);
+	void BenchmarkCodeReferenceScanAsync();
+	void BenchmarkHashingAsync();
+	void ScanForVirtualCallsAsync();
 	void ScanForClassInstancesAsync(const std::shared_ptr<ClassMetaData>& CMeta);
+	void ScanForPolymorphicInstancesAsync(const std::shared_ptr<ClassMetaData>& Root);
+	void SampleLayoutAsync(const std::shared_ptr<ClassMetaData>& CMeta);
+	void ExportHeaderAsync(const std::string& Path, const FHeaderExportSettings& Settings = {});
+	void ExportJsonAsync(const std::string& Path);
+	void BenchmarkJsonExportAsync(size_t NumRecords = 100000);
+	void BenchmarkClassDiffAsync(size_t NumClasses = 100000);
+	void SaveDatabaseAsync(const std::string& Path);
+
+	// diffs the current results against a database of an older build, names given there carry over to unnamed functions
+	void DiffWithDatabaseAsync(const std::string& OldPath, const std::string& ReportPath);
 	inline bool IsAsyncScanning() const { return bIsScanning.load(std::memory_order_acquire); }
 
+	void SetScanPipelineSettings(const FScanPipelineSettings& InSettings) { ScanSettings = InSettings; }
+	const FScanPipelineSettings& GetScanPipelineSettings() const { return ScanSettings; }
+	FScanPipelineStats GetLastScanStats();
+
+	void SetLayoutSamplerSettings(const FLayoutSamplerSettings& InSettings) { LayoutSettings = InSettings; }
+	const FLayoutSamplerSettings& GetLayoutSamplerSettings() const { return LayoutSettings; }
+
+	void SetInstanceValidationSettings(const FInstanceValidationSettings& InSettings) { ValidationSettings = InSettings; }
+	const FInstanceValidationSettings& GetInstanceValidationSettings() const { return ValidationSettings; }
+
+	// ProcessRTTI loads results of the same module build from FResultCache instead of scanning, and stores new ones
+	void SetResultCacheEnabled(bool bEnabled) { bUseResultCache = bEnabled; }
+	bool IsResultCacheEnabled() const { return bUseResultCache; }
+
+	static const char* GetObjectSizeSourceName(EObjectSizeSource Source);
+
+	std::shared_ptr<ClassMetaData> GetCompleteClass(const std::shared_ptr<ClassMetaData>& CMeta) const;
+	std::vector<std::shared_ptr<ClassMetaData>> GetPolymorphicVTables(const std::shared_ptr<ClassMetaData>& Root) const;
+
+	// results of the last polymorphic scan, grouped by concrete class
+	std::shared_ptr<ClassMetaData> GetPolymorphicScanRoot();
+	std::vector<FInstanceGroup> GetPolymorphicScanResults();
+
 protected:
 	void FindValidSections();
+	void LoadImage();
+	void ComputeFingerprint();
+	bool LoadCachedResults();
+	void SaveCachedResults();
+	void LoadDatabase(const FClassDatabase& Database);
+	std::vector<FMemoryRange> GetExecutableSectionRanges() const;
 	bool IsInExecutableSection(uintptr_t Address);
 	bool IsInReadOnlySection(uintptr_t Address);
 
@@ -177,28 +337,55 @@ protected:
 	void ValidateClasses(std::vector<PotentialClass>& PotentialClasses);
 	void ProcessClasses(const std::vector<PotentialClass>& FinalClasses);
 	void ProcessParentClasses();
+	void LinkSecondaryVTables();
+	void AnalyzeOverrides();
+	void ResolveFunctionExtents();
+	void LoadDisassemblyCache();
+	void AnalyzeCode();
+	void FindConstructors(FCodeScanner& Code);
+	size_t ResolveStructorCandidates(FCodeScanner& Code);
+	uint32_t AddSpecialFunction(uintptr_t FunctionStart);
+	bool SetSpecialFunction(const std::shared_ptr<ClassMetaData>& Subject, uint32_t FunctionIndex, bool bDestructor);
+	void InferObjectSizes(FCodeScanner& Code);
+	void HashFunctions(FCodeScanner& Code);
+	void ApplyAnnotations();
+	void SaveAnnotations();
+	void EstimateObjectSizesFromInstances();
 
 	// todo: name functions based on what class they are from...
-	void EnumerateVirtualFunctions(const std::shared_ptr<ClassMetaData>& CMeta);
+	void EnumerateVirtualFunctions(const std::shared_ptr<ClassMetaData>& CMeta, uintptr_t VTableEnd);
+	uintptr_t GetVTableEnd(uintptr_t VTable, const std::vector<uintptr_t>& SortedVTables) const;
+	const uint8_t* GetSectionCopy(uintptr_t Address, size_t Size) const;
 
 	std::string DemangleMSVC(char* Symbol);
 	void SortClasses(std::vector<PotentialClass>& Classes);
 	void FilterSymbol(std::string& Symbol);
 	
-	void ScanAllMemory(std::vector<std::future<FMemoryBlock>>& Blocks, bool isForInstances);
-	void ProcessMemoryBlock(const FMemoryBlock& MemoryBlock, bool isForInstances, std::mutex& mtx);
-
 	using FScanCallback = std::function<void(uintptr_t Candidate, uintptr_t RealAddress)>;
 
-	void ScanBlock(const FMemoryBlock& MemoryBlock, bool isForInstances, FScanCallback Callback);
-	std::vector<uintptr_t> ScanMemory(const std::shared_ptr<ClassMetaData>& CMeta, std::vector<std::future<FMemoryBlock>>& Blocks, bool isForInstances);
+	void ScanBlock(const FMemoryBlock& MemoryBlock, bool isForInstances, const FScanCallback& Callback);
+	void RecordScanStats(const FScanPipeline& Pipeline, const char* ScanName);
 
 	std::vector<uintptr_t> ScanForCodeReferences(const std::shared_ptr<ClassMetaData>& CMeta);
+	std::vector<FCodeReference> FindCodeReferences(const FAddressIndex& Targets, const char* ScanName);
+	void BenchmarkCodeReferenceScan();
+	void BenchmarkHashing();
+	void ScanForVirtualCalls();
 	std::vector<uintptr_t> ScanForClassInstances(const std::shared_ptr<ClassMetaData>& CMeta);
+	std::vector<FInstanceGroup> ScanForPolymorphicInstances(const std::shared_ptr<ClassMetaData>& Root);
+	void SampleLayout(const std::shared_ptr<ClassMetaData>& CMeta);
+	void ExportHeader(std::string Path, FHeaderExportSettings Settings);
+	void ExportJson(std::string Path);
+	void BenchmarkJsonExport(size_t NumRecords);
+	void BenchmarkClassDiff(size_t NumClasses);
+	void SaveDatabase(std::string Path);
+	void DiffWithDatabase(std::string OldPath, std::string ReportPath);
+	std::vector<FInstanceHit> ScanInstances(const std::vector<std::shared_ptr<ClassMetaData>>& VTables, const char* ScanName);
 	
 	void ScanAll();
 	void ScanForAllCodeReferences();
 	void ScanForAllClassInstances();
+	void RunClassCensus(size_t SamplesPerClass);
 	
 	/************************************************************************/
 	/*	RTTI Scanning */
@@ -216,6 +403,23 @@ protected:
 	std::atomic_bool bIsScanning = false;
 	std::thread ScannerThread;
 	bool bUse64BitScanner = sizeof(void*) == 8;
+	FScanPipelineSettings ScanSettings;
+	FInstanceValidationSettings ValidationSettings;
+	FLayoutSamplerSettings LayoutSettings;
+	std::mutex ScanStatsMutex;
+	FScanPipelineStats LastScanStats;
+
+	std::mutex PolymorphicScanMutex;
+	std::shared_ptr<ClassMetaData> PolymorphicScanRoot;
+	std::vector<FInstanceGroup> PolymorphicScanResults;
+
+	std::mutex VirtualCallMutex;
+	std::vector<FVirtualCall> BoundVirtualCalls; // calls through the vtable of this, sorted by caller and slot
+	std::vector<uint32_t> SlotCallCounts; // indexed by slot
+
+	std::mutex CensusMutex;
+	FClassCensus LastCensus;
+	std::vector<uint64_t> PreviousCensusCounts; // indexed by ClassID
 
 	/************************************************************************/
 	/*	Process and Module Info
@@ -228,6 +432,10 @@ protected:
 	uintptr_t ModuleBase;
 	std::vector<FModuleSection> ExecutableSections;
 	std::vector<FModuleSection> ReadOnlySections;
+	std::vector<FMemoryBlock> SectionCopies; // local copies of ReadOnlySections, taken while scanning for classes
+	FPEImage Image; // headers and base relocations of the module
+	FModuleFingerprint Fingerprint;
+	bool bUseResultCache = true;
 	
 	/************************************************************************/
 	/*	Class Meta Data (Processed from RTTI and Memory Scans)
@@ -235,6 +443,9 @@ protected:
 	std::vector<std::shared_ptr<ClassMetaData>> Classes;
 	std::unordered_map<uintptr_t, std::shared_ptr<ClassMetaData>> VTableClassMap;
 	std::unordered_map<std::string, std::shared_ptr<ClassMetaData>> NameClassMap;
+	FAddressIndex VTableIndex; // vtable -> ClassID, for scanning loops
+	FFunctionTable FunctionTable;
+	std::unique_ptr<FDisassemblyCache> DisassemblyCache;
 };
 
 // Virtual Test Suite
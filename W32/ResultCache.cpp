@@ -0,0 +1,83 @@
+#include "ResultCache.h"
+#include "PEImage.h"
+#include "MemoryHash.h"
+#include "../Util/Paths.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+std::string FResultCache::GetDirectory()
+{
+	return GetAppDataDirectory("Cache");
+}
+
+std::string FResultCache::GetPath(const std::string& ModuleName, const FModuleFingerprint& Fingerprint)
+{
+	const std::string Directory = GetDirectory();
+	if (Directory.empty())
+	{
+		return "";
+	}
+
+	char Key[64] = { 0 };
+	snprintf(Key, sizeof(Key), "%08X_%08X_%08X_%016llX",
+		Fingerprint.TimeDateStamp,
+		Fingerprint.SizeOfImage,
+		Fingerprint.CheckSum,
+		static_cast<unsigned long long>(Fingerprint.RDataHash));
+
+	return Directory + "\\" + ModuleName + "_" + Key + ".cd3db";
+}
+
+FModuleFingerprint FResultCache::ComputeFingerprint(FTargetProcess* Process, const FModule& Module, const FPEImage& Image)
+{
+	FModuleFingerprint Fingerprint;
+	Fingerprint.TimeDateStamp = Image.GetTimeDateStamp();
+	Fingerprint.SizeOfImage = Image.GetSizeOfImage();
+	Fingerprint.CheckSum = Image.GetCheckSum();
+
+	const uintptr_t LoadAddress = reinterpret_cast<uintptr_t>(Module.BaseAddress);
+	const bool bHasRData = std::any_of(Module.Sections.begin(), Module.Sections.end(), [](const FModuleSection& Section) { return Section.Name == ".rdata"; });
+	const std::vector<uint32_t>& Relocations = Image.GetRelocations();
+	const IMAGE_DATA_DIRECTORY& ImportAddressTable = Image.GetDirectory(IMAGE_DIRECTORY_ENTRY_IAT);
+
+	uint64_t Hash = 0;
+	for (const FModuleSection& Section : Module.Sections)
+	{
+		// linkers that do not merge into .rdata still get a fingerprint from every read only section
+		if (bHasRData ? Section.Name != ".rdata" : !Section.bFlagReadonly || Section.bFlagExecutable)
+		{
+			continue;
+		}
+
+		FMemoryBlock Block(Section.Start, Section.Size());
+		Process->Read(Section.Start, Block.Copy.data(), Block.Size);
+
+		const uint32_t SectionRva = static_cast<uint32_t>(Section.Start - LoadAddress);
+		const uint32_t SectionEnd = SectionRva + static_cast<uint32_t>(Block.Size);
+
+		// relocated pointers hold the load address, turn them back into RVAs
+		auto it = std::lower_bound(Relocations.begin(), Relocations.end(), SectionRva);
+		for (; it != Relocations.end() && *it + sizeof(uintptr_t) <= SectionEnd; ++it)
+		{
+			uintptr_t Value;
+			memcpy(&Value, &Block.Copy[*it - SectionRva], sizeof(Value));
+			Value -= LoadAddress;
+			memcpy(&Block.Copy[*it - SectionRva], &Value, sizeof(Value));
+		}
+
+		// the import address table is merged into .rdata by MSVC and holds addresses in other modules
+		const uint32_t IATStart = std::max<uint32_t>(ImportAddressTable.VirtualAddress, SectionRva);
+		const uint32_t IATEnd = std::min<uint32_t>(ImportAddressTable.VirtualAddress + ImportAddressTable.Size, SectionEnd);
+		if (IATStart < IATEnd)
+		{
+			memset(&Block.Copy[IATStart - SectionRva], 0, IATEnd - IATStart);
+		}
+
+		const FHash128 SectionHash = HashMemoryBlock(Block).Hash;
+		Hash = FHash::Hash64(&SectionHash, sizeof(SectionHash), Hash);
+	}
+
+	Fingerprint.RDataHash = Hash;
+	return Fingerprint;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "ClassDatabase.h"
+#include "Memory.h"
+#include <string>
+
+class FPEImage;
+
+/**
+ * On disk cache of RTTI results, one class database per module build under %LOCALAPPDATA%\ClassDumper3\Cache.
+ * Entries are named after the module fingerprint, so finding the entry for an attached module is a single
+ * file lookup and a build that changed in any way simply misses. Module addresses in the database are RVAs,
+ * a hit is rebased onto wherever the module is loaded now.
+ */
+class FResultCache
+{
+public:
+	// empty if the cache directory could not be created
+	static std::string GetDirectory();
+	static std::string GetPath(const std::string& ModuleName, const FModuleFingerprint& Fingerprint);
+
+	// PE header fields plus a hash of .rdata, which holds every vtable and RTTI record of the module
+	static FModuleFingerprint ComputeFingerprint(FTargetProcess* Process, const FModule& Module, const FPEImage& Image);
+};
@@ -0,0 +1,190 @@
+#include "ScanPipeline.h"
+#include <chrono>
+#include <thread>
+#include "../Util/ThreadPool.h"
+
+namespace
+{
+	using FClock = std::chrono::steady_clock;
+
+	uint64_t ElapsedNs(FClock::time_point Start)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(FClock::now() - Start).count());
+	}
+}
+
+FScanPipeline::FScanPipeline(HANDLE InProcessHandle, const FScanPipelineSettings& InSettings)
+	: ProcessHandle(InProcessHandle), Settings(InSettings)
+{
+	Settings.ChunkSize = std::max<size_t>(Settings.ChunkSize & ~(sizeof(uintptr_t) - 1), 0x1000);
+	Settings.NumReaders = std::max<size_t>(Settings.NumReaders, 1);
+	Settings.PrefetchDepth = std::max<size_t>(Settings.PrefetchDepth, 1);
+
+	NumScanners = Settings.NumScanners ? Settings.NumScanners : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void FScanPipeline::Run(const std::vector<FMemoryRange>& Ranges, const FChunkCallback& Callback)
+{
+	const auto StartTime = FClock::now();
+
+	BuildTasks(Ranges);
+	if (Tasks.empty())
+	{
+		return;
+	}
+
+	// one buffer per reader and scanner in flight plus the prefetch queue
+	const size_t NumBuffers = std::min(Settings.NumReaders + NumScanners + Settings.PrefetchDepth, Tasks.size() + NumScanners);
+
+	Buffers.clear();
+	Buffers.resize(NumBuffers);
+	FreeBuffers.clear();
+	FilledBuffers.clear();
+
+	for (FMemoryBlock& Buffer : Buffers)
+	{
+		Buffer.Copy.reserve(Settings.ChunkSize + ChunkOverlap);
+		FreeBuffers.push_back(&Buffer);
+	}
+
+	NextTask.store(0);
+	ActiveReaders.store(Settings.NumReaders);
+
+	{
+		ThreadPool Pool(Settings.NumReaders + NumScanners);
+
+		for (size_t i = 0; i < Settings.NumReaders; i++)
+		{
+			Pool.enqueue([this]() { ReaderLoop(); });
+		}
+
+		for (size_t i = 0; i < NumScanners; i++)
+		{
+			Pool.enqueue([this, i, &Callback]() { ScannerLoop(i, Callback); });
+		}
+	}
+
+	Buffers.clear();
+	FreeBuffers.clear();
+	TotalNs = ElapsedNs(StartTime);
+}
+
+FScanPipelineStats FScanPipeline::GetStats() const
+{
+	FScanPipelineStats Stats;
+	Stats.BytesRead = BytesRead.load();
+	Stats.ChunksRead = ChunksRead.load();
+	Stats.ChunksFailed = ChunksFailed.load();
+	Stats.ReaderStallNs = ReaderStallNs.load();
+	Stats.ScannerStallNs = ScannerStallNs.load();
+	Stats.TotalNs = TotalNs;
+	return Stats;
+}
+
+void FScanPipeline::BuildTasks(const std::vector<FMemoryRange>& Ranges)
+{
+	Tasks.clear();
+
+	for (const FMemoryRange& Range : Ranges)
+	{
+		for (uintptr_t Address = Range.Start; Address < Range.End; Address += Settings.ChunkSize)
+		{
+			FChunkTask& Task = Tasks.emplace_back();
+			Task.Address = Address;
+			Task.ReadSize = std::min<size_t>(Settings.ChunkSize + ChunkOverlap, Range.End - Address);
+		}
+	}
+}
+
+void FScanPipeline::ReaderLoop()
+{
+	for (size_t TaskIndex = NextTask++; TaskIndex < Tasks.size(); TaskIndex = NextTask++)
+	{
+		const FChunkTask& Task = Tasks[TaskIndex];
+		FMemoryBlock* Buffer = nullptr;
+
+		{
+			std::unique_lock Lock(QueueMutex);
+			if (FreeBuffers.empty())
+			{
+				const auto StallStart = FClock::now();
+				FreeCondition.wait(Lock, [this]() { return !FreeBuffers.empty(); });
+				ReaderStallNs += ElapsedNs(StallStart);
+			}
+
+			Buffer = FreeBuffers.back();
+			FreeBuffers.pop_back();
+		}
+
+		Buffer->Address = reinterpret_cast<void*>(Task.Address);
+		Buffer->Size = Task.ReadSize;
+		Buffer->Copy.resize(Task.ReadSize);
+
+		SIZE_T BytesCopied = 0;
+		const bool bRead = ReadProcessMemory(ProcessHandle, Buffer->Address, Buffer->Copy.data(), Buffer->Size, &BytesCopied);
+
+		{
+			std::scoped_lock Lock(QueueMutex);
+			if (bRead)
+			{
+				FilledBuffers.push_back(Buffer);
+			}
+			else
+			{
+				FreeBuffers.push_back(Buffer);
+			}
+		}
+
+		if (bRead)
+		{
+			BytesRead += BytesCopied;
+			ChunksRead++;
+			FilledCondition.notify_one();
+		}
+		else
+		{
+			ChunksFailed++;
+			FreeCondition.notify_one();
+		}
+	}
+
+	if (--ActiveReaders == 0)
+	{
+		std::scoped_lock Lock(QueueMutex);
+		FilledCondition.notify_all();
+	}
+}
+
+void FScanPipeline::ScannerLoop(size_t ScannerIndex, const FChunkCallback& Callback)
+{
+	for (;;)
+	{
+		FMemoryBlock* Buffer = nullptr;
+
+		{
+			std::unique_lock Lock(QueueMutex);
+			if (FilledBuffers.empty())
+			{
+				const auto StallStart = FClock::now();
+				FilledCondition.wait(Lock, [this]() { return !FilledBuffers.empty() || ActiveReaders.load() == 0; });
+				ScannerStallNs += ElapsedNs(StallStart);
+			}
+
+			if (FilledBuffers.empty())
+			{
+				return;
+			}
+
+			Buffer = FilledBuffers.front();
+			FilledBuffers.pop_front();
+		}
+
+		Callback(*Buffer, ScannerIndex);
+
+		{
+			std::scoped_lock Lock(QueueMutex);
+			FreeBuffers.push_back(Buffer);
+		}
+		FreeCondition.notify_one();
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Memory.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// ---------------------------------------------
+// Scan Pipeline
+// ---------------------------------------------
+
+struct FScanPipelineSettings
+{
+	size_t ChunkSize = 0x100000; // bytes handed to a scanner per chunk
+	size_t PrefetchDepth = 8; // filled chunks allowed to queue up ahead of the scanners
+	size_t NumReaders = 2;
+	size_t NumScanners = 0; // 0 = hardware concurrency
+};
+
+struct FScanPipelineStats
+{
+	uint64_t BytesRead = 0;
+	uint64_t ChunksRead = 0;
+	uint64_t ChunksFailed = 0;
+	uint64_t ReaderStallNs = 0; // time readers spent waiting for a free buffer
+	uint64_t ScannerStallNs = 0; // time scanners spent waiting for a filled chunk
+	uint64_t TotalNs = 0;
+};
+
+/**
+ * Producer/consumer pipeline for scanning remote memory.
+ * Reader tasks copy chunks of the requested ranges into recycled buffers and push them
+ * through a bounded queue, scanner tasks consume them. Once the queue is warm the scanners
+ * never wait on ReadProcessMemory.
+ * Chunks carry sizeof(uintptr_t) - 1 bytes of overlap from the following chunk, so a scan
+ * that reads a pointer at every offset of the chunk never misses a value crossing a boundary.
+ */
+class FScanPipeline
+{
+public:
+	using FChunkCallback = std::function<void(const FMemoryBlock& Chunk, size_t ScannerIndex)>;
+
+	FScanPipeline(HANDLE InProcessHandle, const FScanPipelineSettings& InSettings);
+
+	void Run(const std::vector<FMemoryRange>& Ranges, const FChunkCallback& Callback);
+
+	size_t GetNumScanners() const { return NumScanners; }
+	FScanPipelineStats GetStats() const;
+
+	static constexpr size_t ChunkOverlap = sizeof(uintptr_t) - 1;
+
+protected:
+	struct FChunkTask
+	{
+		uintptr_t Address = 0;
+		size_t ReadSize = 0;
+	};
+
+	void BuildTasks(const std::vector<FMemoryRange>& Ranges);
+	void ReaderLoop();
+	void ScannerLoop(size_t ScannerIndex, const FChunkCallback& Callback);
+
+	HANDLE ProcessHandle = INVALID_HANDLE_VALUE;
+	FScanPipelineSettings Settings;
+	size_t NumScanners = 1;
+
+	std::vector<FChunkTask> Tasks;
+	std::atomic<size_t> NextTask = 0;
+	std::atomic<size_t> ActiveReaders = 0;
+
+	std::vector<FMemoryBlock> Buffers;
+	std::vector<FMemoryBlock*> FreeBuffers;
+	std::deque<FMemoryBlock*> FilledBuffers;
+	std::mutex QueueMutex;
+	std::condition_variable FreeCondition;
+	std::condition_variable FilledCondition;
+
+	std::atomic<uint64_t> BytesRead = 0;
+	std::atomic<uint64_t> ChunksRead = 0;
+	std::atomic<uint64_t> ChunksFailed = 0;
+	std::atomic<uint64_t> ReaderStallNs = 0;
+	std::atomic<uint64_t> ScannerStallNs = 0;
+	uint64_t TotalNs = 0;
+};